@@ -4,16 +4,49 @@ in vec2 texcoord;
 in vec2 position;
 in vec4 diffuse;
 
+// One record per quad for instanced drawing, the corners get expanded
+// from gl_VertexID.
+in vec4 quad_dstrect;
+in vec4 quad_srcrect;
+in float quad_angle;
+in vec4 quad_diffuse;
+
 out vec2 texcoord_var;
 out vec4 diffuse_var;
 
 uniform mat3 modelviewprojection;
+uniform bool instanced;
 
 void main(void)
 {
-  texcoord_var = texcoord;
-  diffuse_var = diffuse;
-  gl_Position = vec4(vec3(position, 1) * modelviewprojection, 1.0);
+  if (instanced)
+  {
+    // Two triangles: top left, top right, bottom right and bottom left,
+    // top left, bottom right.
+    const vec2 corners[6] = vec2[6](vec2(0, 0), vec2(1, 0), vec2(1, 1),
+                                    vec2(0, 1), vec2(0, 0), vec2(1, 1));
+    vec2 corner = corners[gl_VertexID];
+
+    vec2 pos = mix(quad_dstrect.xy, quad_dstrect.zw, corner);
+    if (quad_angle != 0.0)
+    {
+      vec2 center = (quad_dstrect.xy + quad_dstrect.zw) * 0.5;
+      vec2 d = pos - center;
+      float s = sin(quad_angle);
+      float c = cos(quad_angle);
+      pos = vec2(d.x * c - d.y * s, d.x * s + d.y * c) + center;
+    }
+
+    texcoord_var = mix(quad_srcrect.xy, quad_srcrect.zw, corner);
+    diffuse_var = quad_diffuse;
+    gl_Position = vec4(vec3(pos, 1) * modelviewprojection, 1.0);
+  }
+  else
+  {
+    texcoord_var = texcoord;
+    diffuse_var = diffuse;
+    gl_Position = vec4(vec3(position, 1) * modelviewprojection, 1.0);
+  }
 }
 
 /* EOF */
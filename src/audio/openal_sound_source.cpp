@@ -22,8 +22,10 @@
 OpenALSoundSource::OpenALSoundSource() :
   m_source(),
   m_gain(1.0f),
-  m_volume(1.0f)
+  m_volume(1.0f),
+  m_buffer()
 {
+  std::lock_guard<std::recursive_mutex> lock(SoundManager::s_al_mutex);
   alGenSources(1, &m_source);
 
   // Don't catch anything here: force the caller to catch the error, so that
@@ -36,12 +38,15 @@ OpenALSoundSource::OpenALSoundSource() :
 OpenALSoundSource::~OpenALSoundSource()
 {
   stop();
+
+  std::lock_guard<std::recursive_mutex> lock(SoundManager::s_al_mutex);
   alDeleteSources(1, &m_source);
 }
 
 void
 OpenALSoundSource::stop(bool unload_buffer)
 {
+  std::lock_guard<std::recursive_mutex> lock(SoundManager::s_al_mutex);
 #ifdef WIN32
   // See commit 417a8e7a8c599bfc2dceaec7b6f64ac865318ef1
   alSourceRewindv(1, &m_source); // Stops the source
@@ -64,6 +69,7 @@ OpenALSoundSource::stop(bool unload_buffer)
 void
 OpenALSoundSource::pause()
 {
+  std::lock_guard<std::recursive_mutex> lock(SoundManager::s_al_mutex);
   alSourcePause(m_source);
   try
   {
@@ -78,6 +84,7 @@ OpenALSoundSource::pause()
 void
 OpenALSoundSource::play()
 {
+  std::lock_guard<std::recursive_mutex> lock(SoundManager::s_al_mutex);
   alSourcePlay(m_source);
 
   try
@@ -94,6 +101,7 @@ OpenALSoundSource::play()
 bool
 OpenALSoundSource::playing() const
 {
+  std::lock_guard<std::recursive_mutex> lock(SoundManager::s_al_mutex);
   ALint state = AL_PLAYING;
   alGetSourcei(m_source, AL_SOURCE_STATE, &state);
   return state == AL_PLAYING;
@@ -113,6 +121,7 @@ OpenALSoundSource::resume()
 bool
 OpenALSoundSource::paused() const
 {
+    std::lock_guard<std::recursive_mutex> lock(SoundManager::s_al_mutex);
     ALint state = AL_PAUSED;
     alGetSourcei(m_source, AL_SOURCE_STATE, &state);
     return state == AL_PAUSED;
@@ -126,30 +135,35 @@ OpenALSoundSource::update()
 void
 OpenALSoundSource::set_looping(bool looping)
 {
+  std::lock_guard<std::recursive_mutex> lock(SoundManager::s_al_mutex);
   alSourcei(m_source, AL_LOOPING, looping ? AL_TRUE : AL_FALSE);
 }
 
 void
 OpenALSoundSource::set_relative(bool relative)
 {
+  std::lock_guard<std::recursive_mutex> lock(SoundManager::s_al_mutex);
   alSourcei(m_source, AL_SOURCE_RELATIVE, relative ? AL_TRUE : AL_FALSE);
 }
 
 void
 OpenALSoundSource::set_position(const Vector& position)
 {
+  std::lock_guard<std::recursive_mutex> lock(SoundManager::s_al_mutex);
   alSource3f(m_source, AL_POSITION, position.x, position.y, 0);
 }
 
 void
 OpenALSoundSource::set_velocity(const Vector& velocity)
 {
+  std::lock_guard<std::recursive_mutex> lock(SoundManager::s_al_mutex);
   alSource3f(m_source, AL_VELOCITY, velocity.x, velocity.y, 0);
 }
 
 void
 OpenALSoundSource::set_gain(float gain)
 {
+  std::lock_guard<std::recursive_mutex> lock(SoundManager::s_al_mutex);
   alSourcef(m_source, AL_GAIN, gain * m_volume);
   m_gain = gain;
 }
@@ -157,18 +171,21 @@ OpenALSoundSource::set_gain(float gain)
 void
 OpenALSoundSource::set_pitch(float pitch)
 {
+  std::lock_guard<std::recursive_mutex> lock(SoundManager::s_al_mutex);
   alSourcef(m_source, AL_PITCH, pitch);
 }
 
 void
 OpenALSoundSource::set_reference_distance(float distance)
 {
+  std::lock_guard<std::recursive_mutex> lock(SoundManager::s_al_mutex);
   alSourcef(m_source, AL_REFERENCE_DISTANCE, distance);
 }
 
 void
 OpenALSoundSource::set_volume(float volume)
 {
+  std::lock_guard<std::recursive_mutex> lock(SoundManager::s_al_mutex);
   m_volume = volume;
   alSourcef(m_source, AL_GAIN, m_gain * m_volume);
 }
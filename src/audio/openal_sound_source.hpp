@@ -17,6 +17,7 @@
 #pragma once
 
 #include <al.h>
+#include <memory>
 
 #include "audio/sound_source.hpp"
 
@@ -52,6 +53,10 @@ protected:
   float m_gain;
   float m_volume;
 
+  /** The cached buffer attached to the source, keeps the SoundManager
+      from evicting it. */
+  std::shared_ptr<const ALuint> m_buffer;
+
 private:
   OpenALSoundSource(const OpenALSoundSource&) = delete;
   OpenALSoundSource& operator=(const OpenALSoundSource&) = delete;
@@ -0,0 +1,85 @@
+//  SuperTux
+//  Copyright (C) 2026 SuperTux Development Team
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#include "audio/ring_buffer.hpp"
+
+#include <algorithm>
+#include <string.h>
+
+RingBuffer::RingBuffer(size_t capacity) :
+  m_data(),
+  m_mask(),
+  m_read_pos(0),
+  m_write_pos(0)
+{
+  size_t size = 1;
+  while (size < capacity)
+    size <<= 1;
+
+  m_data.reset(new char[size]);
+  m_mask = size - 1;
+}
+
+size_t
+RingBuffer::write(const void* data, size_t size)
+{
+  const size_t write_pos = m_write_pos.load(std::memory_order_relaxed);
+  const size_t read_pos = m_read_pos.load(std::memory_order_acquire);
+  size = std::min(size, capacity() - (write_pos - read_pos));
+
+  const size_t offset = write_pos & m_mask;
+  const size_t first = std::min(size, capacity() - offset);
+  memcpy(m_data.get() + offset, data, first);
+  memcpy(m_data.get(), static_cast<const char*>(data) + first, size - first);
+
+  m_write_pos.store(write_pos + size, std::memory_order_release);
+  return size;
+}
+
+size_t
+RingBuffer::read(void* data, size_t size)
+{
+  const size_t read_pos = m_read_pos.load(std::memory_order_relaxed);
+  const size_t write_pos = m_write_pos.load(std::memory_order_acquire);
+  size = std::min(size, write_pos - read_pos);
+
+  const size_t offset = read_pos & m_mask;
+  const size_t first = std::min(size, capacity() - offset);
+  memcpy(data, m_data.get() + offset, first);
+  memcpy(static_cast<char*>(data) + first, m_data.get(), size - first);
+
+  m_read_pos.store(read_pos + size, std::memory_order_release);
+  return size;
+}
+
+size_t
+RingBuffer::readable() const
+{
+  return m_write_pos.load(std::memory_order_acquire) - m_read_pos.load(std::memory_order_relaxed);
+}
+
+size_t
+RingBuffer::writable() const
+{
+  return capacity() - (m_write_pos.load(std::memory_order_relaxed) - m_read_pos.load(std::memory_order_acquire));
+}
+
+void
+RingBuffer::clear()
+{
+  m_read_pos = 0;
+  m_write_pos = 0;
+}
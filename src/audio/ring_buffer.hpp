@@ -0,0 +1,60 @@
+//  SuperTux
+//  Copyright (C) 2026 SuperTux Development Team
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#pragma once
+
+#include <atomic>
+#include <memory>
+#include <stddef.h>
+
+/**
+ * A fixed size byte queue between exactly one producer and one
+ * consumer thread, without locks. The producer only calls write() and
+ * writable(), the consumer only read() and readable().
+ */
+class RingBuffer final
+{
+public:
+  /** 'capacity' gets rounded up to a power of two. */
+  explicit RingBuffer(size_t capacity);
+
+  /** Copies as much of 'data' as fits, returns the number of bytes
+      written. */
+  size_t write(const void* data, size_t size);
+
+  /** Copies up to 'size' bytes into 'data', returns the number of bytes
+      read. */
+  size_t read(void* data, size_t size);
+
+  size_t readable() const;
+  size_t writable() const;
+  inline size_t capacity() const { return m_mask + 1; }
+
+  /** Drops all contents. Neither side may be active at the same time. */
+  void clear();
+
+private:
+  std::unique_ptr<char[]> m_data;
+  size_t m_mask;
+
+  /** Total bytes read and written, the difference is the fill level. */
+  std::atomic<size_t> m_read_pos;
+  std::atomic<size_t> m_write_pos;
+
+private:
+  RingBuffer(const RingBuffer&) = delete;
+  RingBuffer& operator=(const RingBuffer&) = delete;
+};
@@ -18,6 +18,7 @@
 
 #include <SDL.h>
 #include <assert.h>
+#include <chrono>
 #include <iostream>
 #include <stdexcept>
 #include <sstream>
@@ -26,16 +27,55 @@
 #include "audio/dummy_sound_source.hpp"
 #include "audio/sound_file.hpp"
 #include "audio/stream_sound_source.hpp"
+#include "audio/voice_pool.hpp"
 #include "util/log.hpp"
 
+namespace {
+
+const size_t s_default_buffer_budget = 64 * 1024 * 1024;
+
+/** Files at least this big are streamed instead of being kept in a
+    buffer. */
+const size_t s_max_buffered_size = 100000;
+
+/** Sources reserved for play(). Leaves room below common hardware
+    limits for music, ambient sounds and the sources objects own. */
+const size_t s_max_voices = 24;
+
+/** Voice priorities of play(). */
+const int s_priority_positional = 0;
+const int s_priority_relative = 1;
+
+/** How often the streaming thread looks at the OpenAL queues and fades
+    of the registered streams while their ring buffers are full. */
+const std::chrono::milliseconds s_streaming_interval(20);
+
+} // namespace
+
+std::recursive_mutex SoundManager::s_al_mutex;
+
 SoundManager::SoundManager() :
   m_device(alcOpenDevice(nullptr)),
   m_context(alcCreateContext(m_device, nullptr)),
   m_sound_enabled(false),
   m_sound_volume(0),
   m_buffers(),
+  m_buffer_lru(),
+  m_buffer_budget(s_default_buffer_budget),
+  m_buffers_size(0),
+  m_buffer_hits(0),
+  m_buffer_misses(0),
+  m_buffer_evictions(0),
   m_sources(),
+  m_voices(),
+  m_listener_position(0.0f, 0.0f),
   m_update_list(),
+  m_streaming_mutex(),
+  m_streaming_thread(),
+  m_streaming_wake_mutex(),
+  m_streaming_wakeup(),
+  m_streaming_wake(false),
+  m_streaming_quit(false),
   m_music_source(),
   m_music_enabled(false),
   m_music_volume(0),
@@ -54,6 +94,10 @@ SoundManager::SoundManager() :
     m_music_enabled = true;
 
     set_listener_orientation(Vector(0.0f, 0.0f), Vector(0.0f, -1.0f));
+
+    m_voices = std::make_unique<VoicePool>(s_max_voices);
+
+    start_streaming_thread();
   } catch(std::exception& e) {
     if (m_context != nullptr) {
       alcDestroyContext(m_context);
@@ -70,11 +114,14 @@ SoundManager::SoundManager() :
 
 SoundManager::~SoundManager()
 {
+  stop_streaming_thread();
+
   m_music_source.reset();
   m_sources.clear();
+  m_voices.reset();
 
   for (const auto& buffer : m_buffers) {
-    alDeleteBuffers(1, &buffer.second);
+    alDeleteBuffers(1, buffer.second.buffer.get());
   }
 
   if (m_context != nullptr) {
@@ -91,11 +138,13 @@ ALuint
 SoundManager::load_file_into_buffer(SoundFile& file)
 {
   ALenum format = get_sample_format(file);
+  std::unique_ptr<char[]> samples(new char[file.m_size]);
+  file.read(samples.get(), file.m_size);
+
+  std::lock_guard<std::recursive_mutex> lock(s_al_mutex);
   ALuint buffer;
   alGenBuffers(1, &buffer);
   check_al_error("Couldn't create audio buffer: ");
-  std::unique_ptr<char[]> samples(new char[file.m_size]);
-  file.read(samples.get(), file.m_size);
   log_debug << "buffer: " << buffer << "\n"
             << "format: " << format << "\n"
             << "samples: " << samples.get() << "\n"
@@ -118,21 +167,16 @@ SoundManager::intern_create_sound_source(const std::string& filename)
   auto source = std::make_unique<OpenALSoundSource>();
   source->set_volume(static_cast<float>(m_sound_volume) / 100.0f);
 
-  ALuint buffer;
-
   // reuse an existing static sound buffer
-  auto it = m_buffers.find(filename);
-  if (it != m_buffers.end()) {
-    buffer = it->second;
-  } else {
+  std::shared_ptr<const ALuint> buffer = find_buffer(filename);
+  if (!buffer) {
     // Load sound file
     std::unique_ptr<SoundFile> file(load_sound_file(filename));
 
-    if (file->m_size < 100000) {
+    if (file->m_size < s_max_buffered_size) {
       log_debug << "Adding \"" << filename <<
         "\" into the buffer, file size: " << file->m_size << std::endl;
-      buffer = load_file_into_buffer(*file);
-      m_buffers.insert(std::make_pair(filename, buffer));
+      buffer = add_buffer(filename, load_file_into_buffer(*file), file->m_size);
     } else {
       log_debug << "Playing \"" << filename <<
         "\" as StreamSoundSource, file size: " << file->m_size << std::endl;
@@ -143,7 +187,11 @@ SoundManager::intern_create_sound_source(const std::string& filename)
     }
   }
 
-  alSourcei(source->m_source, AL_BUFFER, buffer);
+  {
+    std::lock_guard<std::recursive_mutex> lock(s_al_mutex);
+    alSourcei(source->m_source, AL_BUFFER, *buffer);
+  }
+  source->m_buffer = std::move(buffer);
   return source;
 }
 
@@ -174,16 +222,90 @@ SoundManager::preload(const std::string& filename)
   try {
     std::unique_ptr<SoundFile> file (load_sound_file(filename));
     // only keep small files
-    if (file->m_size >= 100000)
+    if (file->m_size >= s_max_buffered_size)
       return;
 
-    ALuint buffer = load_file_into_buffer(*file);
-    m_buffers.insert(std::make_pair(filename, buffer));
+    add_buffer(filename, load_file_into_buffer(*file), file->m_size);
   } catch(std::exception& e) {
     log_warning << "Error while preloading sound file: " << e.what() << std::endl;
   }
 }
 
+void
+SoundManager::set_buffer_budget(size_t bytes)
+{
+  m_buffer_budget = bytes;
+  enforce_buffer_budget();
+}
+
+void
+SoundManager::print_buffer_stats() const
+{
+  log_info << "Sound buffers: " << m_buffers.size() << " using "
+           << m_buffers_size / 1024 << " of " << m_buffer_budget / 1024 << " KiB, "
+           << m_buffer_hits << " hits, " << m_buffer_misses << " misses, "
+           << m_buffer_evictions << " evictions" << std::endl;
+  if (m_voices) {
+    std::lock_guard<std::recursive_mutex> lock(s_al_mutex);
+    log_info << "Sound voices: " << m_voices->get_playing_count() << " of " << m_voices->size()
+             << " playing, " << m_voices->get_stolen_count() << " stolen, "
+             << m_voices->get_coalesced_count() << " coalesced, "
+             << m_voices->get_dropped_count() << " dropped" << std::endl;
+  }
+}
+
+std::shared_ptr<const ALuint>
+SoundManager::find_buffer(const std::string& filename)
+{
+  auto it = m_buffers.find(filename);
+  if (it == m_buffers.end())
+    return {};
+
+  m_buffer_hits += 1;
+  m_buffer_lru.splice(m_buffer_lru.begin(), m_buffer_lru, it->second.lru_pos);
+  return it->second.buffer;
+}
+
+std::shared_ptr<const ALuint>
+SoundManager::add_buffer(const std::string& filename, ALuint buffer, size_t size)
+{
+  m_buffer_misses += 1;
+  m_buffer_lru.push_front(filename);
+
+  auto& entry = m_buffers[filename];
+  entry.buffer = std::make_shared<const ALuint>(buffer);
+  entry.size = size;
+  entry.lru_pos = m_buffer_lru.begin();
+  m_buffers_size += size;
+
+  // Hold on to the new buffer, so that it's not the one evicted.
+  std::shared_ptr<const ALuint> result = entry.buffer;
+  enforce_buffer_budget();
+  return result;
+}
+
+void
+SoundManager::enforce_buffer_budget()
+{
+  std::lock_guard<std::recursive_mutex> lock(s_al_mutex);
+  auto it = m_buffer_lru.end();
+  while (m_buffers_size > m_buffer_budget && it != m_buffer_lru.begin()) {
+    --it;
+    auto entry = m_buffers.find(*it);
+    assert(entry != m_buffers.end());
+
+    // Still attached to a source.
+    if (entry->second.buffer.use_count() > 1)
+      continue;
+
+    alDeleteBuffers(1, entry->second.buffer.get());
+    m_buffers_size -= entry->second.size;
+    m_buffer_evictions += 1;
+    m_buffers.erase(entry);
+    it = m_buffer_lru.erase(it);
+  }
+}
+
 void
 SoundManager::play(const std::string& filename, const Vector& pos,
   const float gain)
@@ -196,16 +318,41 @@ SoundManager::play(const std::string& filename, const Vector& pos,
   assert(gain >= 0.0f && gain <= 1.0f);
 
   try {
-    std::unique_ptr<OpenALSoundSource> source(intern_create_sound_source(filename));
-    source->set_gain(gain);
+    std::shared_ptr<const ALuint> buffer = find_buffer(filename);
+    if (!buffer) {
+      std::unique_ptr<SoundFile> file(load_sound_file(filename));
+      if (file->m_size >= s_max_buffered_size) {
+        // Too big for a buffer, stream it on a source of its own.
+        auto source = std::make_unique<StreamSoundSource>();
+        source->set_sound_file(std::move(file));
+        source->set_volume(static_cast<float>(m_sound_volume) / 100.0f);
+        source->set_gain(gain);
+        if (pos.x < 0 || pos.y < 0) {
+          source->set_relative(true);
+        } else {
+          source->set_position(pos);
+        }
+        source->play();
+        m_sources.push_back(std::move(source));
+        return;
+      }
+      buffer = add_buffer(filename, load_file_into_buffer(*file), file->m_size);
+    }
 
+    VoicePool::Sound sound;
+    sound.buffer = std::move(buffer);
+    sound.gain = gain;
     if (pos.x < 0 || pos.y < 0) {
-      source->set_relative(true);
+      sound.priority = s_priority_relative;
+      sound.distance = 0.0f;
     } else {
-      source->set_position(pos);
+      sound.priority = s_priority_positional;
+      sound.distance = glm::length(pos - m_listener_position);
+      sound.position = pos;
     }
-    source->play();
-    m_sources.push_back(std::move(source));
+    std::lock_guard<std::recursive_mutex> lock(s_al_mutex);
+    m_voices->play(sound, SDL_GetTicks());
+    check_al_error("Couldn't start audio source: ");
   } catch(std::exception& e) {
     log_warning << "Couldn't play sound " << filename << ": " << e.what() << std::endl;
   }
@@ -227,7 +374,11 @@ SoundManager::register_for_update(StreamSoundSource* sss)
 {
   if (sss)
   {
-    m_update_list.push_back(sss);
+    {
+      std::lock_guard<std::mutex> lock(m_streaming_mutex);
+      m_update_list.push_back(sss);
+    }
+    wake_streaming_thread();
   }
 }
 
@@ -236,6 +387,7 @@ SoundManager::remove_from_update(StreamSoundSource* sss)
 {
   if (sss)
   {
+    std::lock_guard<std::mutex> lock(m_streaming_mutex);
     auto it = m_update_list.begin();
     while (it != m_update_list.end()) {
       if (*it == sss) {
@@ -357,6 +509,11 @@ SoundManager::pause_music(float fadetime)
 void
 SoundManager::pause_sounds()
 {
+  if (m_voices) {
+    std::lock_guard<std::recursive_mutex> lock(s_al_mutex);
+    m_voices->pause_all();
+  }
+
   for (auto& source : m_sources) {
     if (source->playing()) {
       source->pause();
@@ -367,6 +524,11 @@ SoundManager::pause_sounds()
 void
 SoundManager::resume_sounds()
 {
+  if (m_voices) {
+    std::lock_guard<std::recursive_mutex> lock(s_al_mutex);
+    m_voices->resume_all();
+  }
+
   for (auto& source : m_sources) {
     if (source->paused()) {
       source->resume();
@@ -377,6 +539,11 @@ SoundManager::resume_sounds()
 void
 SoundManager::stop_sounds()
 {
+  if (m_voices) {
+    std::lock_guard<std::recursive_mutex> lock(s_al_mutex);
+    m_voices->stop_all();
+  }
+
   for (auto& source : m_sources) {
     source->stop();
   }
@@ -386,6 +553,11 @@ void
 SoundManager::set_sound_volume(int volume)
 {
   m_sound_volume = volume;
+  if (m_voices) {
+    std::lock_guard<std::recursive_mutex> lock(s_al_mutex);
+    m_voices->set_volume(static_cast<float>(volume) / 100.0f);
+  }
+
   for (auto& source : m_sources) {
     source->set_volume(static_cast<float>(volume) / 100.0f);
   }
@@ -410,6 +582,8 @@ SoundManager::resume_music(float fadetime)
 void
 SoundManager::set_listener_position(const Vector& pos)
 {
+  m_listener_position = pos;
+
   static Uint32 lastticks = SDL_GetTicks();
 
   Uint32 current_ticks = SDL_GetTicks();
@@ -417,12 +591,14 @@ SoundManager::set_listener_position(const Vector& pos)
     return;
   lastticks = current_ticks;
 
+  std::lock_guard<std::recursive_mutex> lock(s_al_mutex);
   alListener3f(AL_POSITION, pos.x, pos.y, -300);
 }
 
 void
 SoundManager::set_listener_velocity(const Vector& vel)
 {
+  std::lock_guard<std::recursive_mutex> lock(s_al_mutex);
   alListener3f(AL_VELOCITY, vel.x, vel.y, 0);
 }
 
@@ -430,12 +606,19 @@ void
 SoundManager::set_listener_orientation(const Vector& at, const Vector& up)
 {
   ALfloat orientation[]={at.x, at.y, 1.0, up.x, up.y, 0.0};
+  std::lock_guard<std::recursive_mutex> lock(s_al_mutex);
   alListenerfv(AL_ORIENTATION, orientation);
 }
 
 void
 SoundManager::update()
 {
+  // Reports what the streaming thread couldn't log, or does its work
+  // where there is no such thread.
+  for (auto* sss : m_update_list) {
+    sss->update();
+  }
+
   static Uint32 lasttime = SDL_GetTicks();
   Uint32 now = SDL_GetTicks();
 
@@ -455,6 +638,13 @@ SoundManager::update()
       ++it;
     }
   }
+  // buffers of finished sources can go now
+  if (m_voices) {
+    std::lock_guard<std::recursive_mutex> lock(s_al_mutex);
+    m_voices->update();
+  }
+  enforce_buffer_budget();
+
   // check streaming sounds
   if (m_music_source) {
     m_music_source->update();
@@ -465,12 +655,82 @@ SoundManager::update()
     alcProcessContext(m_context);
     check_alc_error("Error while processing audio context: ");
   }
+}
+
+void
+SoundManager::start_streaming_thread()
+{
+#ifndef __EMSCRIPTEN__
+  try {
+    m_streaming_quit = false;
+    m_streaming_thread = std::thread(&SoundManager::run_streaming, this);
+  } catch(const std::exception& e) {
+    log_warning << "Couldn't start audio streaming thread, streaming on the main thread: " << e.what() << std::endl;
+  }
+#endif
+}
 
-  //run update() for stream_sound_source
-  auto s = m_update_list.begin();
-  while (s != m_update_list.end()) {
-    (*s)->update();
-    ++s;
+void
+SoundManager::stop_streaming_thread()
+{
+  {
+    std::lock_guard<std::mutex> lock(m_streaming_wake_mutex);
+    m_streaming_quit = true;
+  }
+  m_streaming_wakeup.notify_one();
+
+  if (m_streaming_thread.joinable())
+    m_streaming_thread.join();
+}
+
+void
+SoundManager::wake_streaming_thread()
+{
+  {
+    std::lock_guard<std::mutex> lock(m_streaming_wake_mutex);
+    m_streaming_wake = true;
+  }
+  m_streaming_wakeup.notify_one();
+}
+
+void
+SoundManager::run_streaming()
+{
+  while (true) {
+    // Streams take turns in chunks, the next round follows right away
+    // as long as any of them decoded something.
+    bool decoded = false;
+    bool idle = true;
+    {
+      std::lock_guard<std::mutex> lock(m_streaming_mutex);
+      for (auto* sss : m_update_list) {
+        decoded = sss->decode(StreamSoundSource::DECODECHUNKSIZE) || decoded;
+      }
+
+      std::lock_guard<std::recursive_mutex> al_lock(s_al_mutex);
+      for (auto* sss : m_update_list) {
+        sss->feed();
+        sss->update_fade();
+      }
+      idle = m_update_list.empty();
+    }
+
+    std::unique_lock<std::mutex> lock(m_streaming_wake_mutex);
+    if (m_streaming_quit)
+      break;
+
+    if (!decoded) {
+      // Playing streams need their OpenAL queue refilled before it runs
+      // out, no matter how long the main thread takes for a frame.
+      const auto woken = [this] { return m_streaming_wake || m_streaming_quit; };
+      if (idle)
+        m_streaming_wakeup.wait(lock, woken);
+      else
+        m_streaming_wakeup.wait_for(lock, s_streaming_interval, woken);
+      if (m_streaming_quit)
+        break;
+    }
+    m_streaming_wake = false;
   }
 }
 
@@ -16,9 +16,13 @@
 
 #pragma once
 
+#include <condition_variable>
+#include <list>
 #include <map>
 #include <memory>
+#include <mutex>
 #include <string>
+#include <thread>
 #include <vector>
 
 #include <al.h>
@@ -31,6 +35,7 @@ class SoundFile;
 class SoundSource;
 class StreamSoundSource;
 class OpenALSoundSource;
+class VoicePool;
 
 class SoundManager final : public Currenton<SoundManager>
 {
@@ -42,8 +47,16 @@ private:
   static ALenum get_sample_format(const SoundFile& file);
 
   static void print_openal_version();
+  /** The caller has to hold s_al_mutex since the OpenAL call it checks. */
   static void check_al_error(const char* message);
 
+  /** Held around every use of OpenAL while the streaming thread runs.
+      The OpenAL error state is shared between threads, this keeps each
+      alGetError() to the errors of its own calls. Never held when
+      registering or removing a stream, the streaming thread takes it
+      with m_streaming_mutex held. */
+  static std::recursive_mutex s_al_mutex;
+
 public:
   SoundManager();
   ~SoundManager() override;
@@ -56,7 +69,10 @@ public:
       This function never throws exceptions, but might return a DummySoundSource */
   std::unique_ptr<SoundSource> create_sound_source(const std::string& filename);
 
-  /** Convenience functions to simply play a sound at a given position. */
+  /** Convenience functions to simply play a sound at a given position.
+      These play on a fixed pool of voices: when it is exhausted, sounds
+      relative to the listener win over positional ones, and nearer
+      sounds over farther ones. */
   void play(const std::string& name, const Vector& pos = Vector(-1, -1),
     const float gain = 0.5f);
   void play(const std::string& name, const float gain)
@@ -72,6 +88,13 @@ public:
   /** preloads a sound, so that you don't get a lag later when playing it */
   void preload(const std::string& name);
 
+  /** Sets how many bytes of decoded sounds may stay loaded. Beyond that
+      the least recently used buffers that no source holds get freed. */
+  void set_buffer_budget(size_t bytes);
+
+  /** Logs the buffer cache and voice pool usage. */
+  void print_buffer_stats() const;
+
   void set_listener_position(const Vector& position);
   void set_listener_velocity(const Vector& velocity);
   void set_listener_orientation(const Vector& at, const Vector& up);
@@ -99,25 +122,74 @@ public:
   /** Tell soundmanager to call update() for stream_sound_source. */
   void register_for_update(StreamSoundSource* sss);
 
-  /** Unsubscribe from updates for stream_sound_source. */
+  /** Unsubscribe from updates for stream_sound_source. Once this
+      returns the streaming thread is done with 'sss'. */
   void remove_from_update(StreamSoundSource* sss);
 
+  /** Whether the registered streams get decoded, queued and faded by
+      the streaming thread instead of their update(). */
+  inline bool is_streaming_threaded() const { return m_streaming_thread.joinable(); }
+
+private:
+  void start_streaming_thread();
+  void stop_streaming_thread();
+  void wake_streaming_thread();
+
+  /** Thread function, keeps the ring buffers and OpenAL queues of the
+      registered streams filled and runs their fades. */
+  void run_streaming();
+
 private:
   /** creates a new sound source, might throw exceptions, never returns nullptr */
   std::unique_ptr<OpenALSoundSource> intern_create_sound_source(const std::string& filename);
 
   void check_alc_error(const char* message) const;
 
+  /** Returns the cached buffer for 'filename' and marks it as recently
+      used, nullptr if it isn't loaded. */
+  std::shared_ptr<const ALuint> find_buffer(const std::string& filename);
+  std::shared_ptr<const ALuint> add_buffer(const std::string& filename, ALuint buffer, size_t size);
+  void enforce_buffer_budget();
+
+private:
+  struct CachedBuffer
+  {
+    /** Shared with the sources the buffer is attached to, it can be
+        evicted once the cache holds the only reference. */
+    std::shared_ptr<const ALuint> buffer;
+    size_t size;
+    std::list<std::string>::iterator lru_pos;
+  };
+
 private:
   ALCdevice* m_device;
   ALCcontext* m_context;
   bool m_sound_enabled;
   int m_sound_volume;
 
-  std::map<std::string, ALuint> m_buffers;
+  std::map<std::string, CachedBuffer> m_buffers;
+  /** Most recently used first. */
+  std::list<std::string> m_buffer_lru;
+  size_t m_buffer_budget;
+  size_t m_buffers_size;
+  int m_buffer_hits;
+  int m_buffer_misses;
+  int m_buffer_evictions;
   std::vector<std::unique_ptr<OpenALSoundSource> > m_sources;
+  std::unique_ptr<VoicePool> m_voices;
+  Vector m_listener_position;
 
+  /** Changed only on the main thread with m_streaming_mutex held, the
+      streaming thread holds it while going through the list. */
   std::vector<StreamSoundSource*> m_update_list;
+  std::mutex m_streaming_mutex;
+  std::thread m_streaming_thread;
+
+  /** Guards m_streaming_wake and m_streaming_quit for m_streaming_wakeup. */
+  std::mutex m_streaming_wake_mutex;
+  std::condition_variable m_streaming_wakeup;
+  bool m_streaming_wake;
+  bool m_streaming_quit;
 
   std::unique_ptr<StreamSoundSource> m_music_source;
 
@@ -14,19 +14,33 @@
 //  You should have received a copy of the GNU General Public License
 //  along with this program.  If not, see <http://www.gnu.org/licenses/>.
 
+#include "audio/stream_sound_source.hpp"
+
+#include <algorithm>
+#include <stdexcept>
+
 #include "audio/sound_file.hpp"
 #include "audio/sound_manager.hpp"
-#include "audio/stream_sound_source.hpp"
-#include "supertux/globals.hpp"
 #include "util/log.hpp"
 
 StreamSoundSource::StreamSoundSource() :
   m_file(),
+  m_format(),
+  m_rate(),
+  m_ring(DECODEBUFFERSIZE),
+  m_decode_buffer(new char[DECODECHUNKSIZE]),
+  m_end_of_stream(false),
+  m_free_buffers(),
+  m_feed_buffer(new char[STREAMFRAGMENTSIZE]),
   m_fade_state(NoFading),
   m_fade_start_time(),
   m_fade_time(),
+  m_fade_action(NoAction),
+  m_error(),
+  m_underruns(0),
   m_looping(false)
 {
+  std::lock_guard<std::recursive_mutex> lock(SoundManager::s_al_mutex);
   alGenBuffers(STREAMFRAGMENTS, m_buffers);
   try
   {
@@ -36,8 +50,7 @@ StreamSoundSource::StreamSoundSource() :
   {
     log_warning << e.what() << std::endl;
   }
-  //add me to update list
-  SoundManager::current()->register_for_update( this );
+  m_free_buffers.assign(m_buffers, m_buffers + STREAMFRAGMENTS);
 }
 
 StreamSoundSource::~StreamSoundSource()
@@ -46,6 +59,8 @@ StreamSoundSource::~StreamSoundSource()
   SoundManager::current()->remove_from_update( this );
   m_file.reset();
   stop();
+
+  std::lock_guard<std::recursive_mutex> lock(SoundManager::s_al_mutex);
   alDeleteBuffers(STREAMFRAGMENTS, m_buffers);
   try
   {
@@ -61,118 +76,239 @@ StreamSoundSource::~StreamSoundSource()
 void
 StreamSoundSource::set_sound_file(std::unique_ptr<SoundFile> newfile)
 {
+  // The decoder thread must not see the file change underneath it.
+  SoundManager::current()->remove_from_update(this);
+
+  m_format = SoundManager::get_sample_format(*newfile);
+  m_rate = newfile->m_rate;
   m_file = std::move(newfile);
+  m_ring.clear();
+  m_end_of_stream = false;
 
-  ALint queued;
-  alGetSourcei(m_source, AL_BUFFERS_QUEUED, &queued);
-  for (size_t i = 0; i < STREAMFRAGMENTS - queued; ++i) {
-    if (fillBufferAndQueue(m_buffers[i]) == false)
-      break;
-  }
+  decode(STREAMBUFFERSIZE);
+  feed();
+
+  //add me to update list
+  SoundManager::current()->register_for_update(this);
 }
 
 void
 StreamSoundSource::resume()
 {
+  std::lock_guard<std::recursive_mutex> lock(SoundManager::s_al_mutex);
   OpenALSoundSource::resume();
   set_gain(1.0);
   m_fade_state = NoFading;
+  m_fade_action = NoAction;
 }
 
 void
 StreamSoundSource::update()
 {
-  ALint processed = 0;
-  alGetSourcei(m_source, AL_BUFFERS_PROCESSED, &processed);
-  for (ALint i = 0; i < processed; ++i) {
-    ALuint buffer;
-    alSourceUnqueueBuffers(m_source, 1, &buffer);
-    try
-    {
-      SoundManager::check_al_error("Couldn't unqueue audio buffer: ");
-    }
-    catch(std::exception& e)
-    {
-      log_warning << e.what() << std::endl;
-    }
+  if (!m_file)
+    return;
 
-    if (fillBufferAndQueue(buffer) == false)
-      break;
+  if (!SoundManager::current()->is_streaming_threaded())
+  {
+    decode(STREAMBUFFERSIZE);
+    feed();
+    update_fade();
   }
 
-  if (!playing() && !paused()) {
-    if (processed == 0 || !m_looping)
-      return;
-
-    // we might have to restart the source if we had a buffer underrun
-    log_info << "Restarting audio source because of buffer underrun" << std::endl;
-    play();
+  FadeAction action;
+  std::string error;
+  int underruns;
+  {
+    std::lock_guard<std::recursive_mutex> lock(SoundManager::s_al_mutex);
+    action = m_fade_action;
+    m_fade_action = NoAction;
+    std::swap(error, m_error);
+    underruns = m_underruns;
+    m_underruns = 0;
   }
 
-  if (m_fade_state == FadingOn || m_fade_state == FadingResume) {
-    float time = g_real_time - m_fade_start_time;
-    if (time >= m_fade_time) {
-      set_gain(1.0);
-      m_fade_state = NoFading;
-    } else {
-      set_gain(time / m_fade_time);
-    }
-  } else if (m_fade_state == FadingOff || m_fade_state == FadingPause) {
-    float time = g_real_time - m_fade_start_time;
-    if (time >= m_fade_time) {
-      if (m_fade_state == FadingOff)
-        stop();
-      else
-        pause();
-      m_fade_state = NoFading;
-    } else {
-      set_gain( (m_fade_time - time) / m_fade_time);
-    }
+  if (!error.empty())
+    log_warning << error << std::endl;
+
+  if (underruns > 0)
+    log_info << "Restarted audio source because of buffer underrun" << std::endl;
+
+  switch (action)
+  {
+    case ActionStop:
+      stop();
+      break;
+    case ActionPause:
+      pause();
+      break;
+    case NoAction:
+      break;
   }
 }
 
 void
 StreamSoundSource::set_fading(FadeState state, float fade_time_)
 {
+  std::lock_guard<std::recursive_mutex> lock(SoundManager::s_al_mutex);
   m_fade_state = state;
   m_fade_time = fade_time_;
-  m_fade_start_time = g_real_time;
+  m_fade_start_time = Clock::now();
+  m_fade_action = NoAction;
+}
+
+StreamSoundSource::FadeState
+StreamSoundSource::get_fade_state() const
+{
+  std::lock_guard<std::recursive_mutex> lock(SoundManager::s_al_mutex);
+  return m_fade_state;
 }
 
 bool
-StreamSoundSource::fillBufferAndQueue(ALuint buffer)
+StreamSoundSource::decode(size_t max_size)
 {
-  // fill buffer
-  std::unique_ptr<char[]> bufferdata(new char[STREAMFRAGMENTSIZE]);
-  size_t bytesread = 0;
-  do {
-    bytesread += m_file->read(static_cast<char *>(bufferdata.get()) + bytesread,
-      STREAMFRAGMENTSIZE - bytesread);
+  // The looping flag might have been set after the end was reached.
+  if (m_end_of_stream && m_looping)
+  {
+    m_file->reset();
+    m_end_of_stream = false;
+  }
+
+  bool decoded = false;
+  bool restarted = false;
+  while (max_size > 0 && !m_end_of_stream)
+  {
+    const size_t size = std::min({ max_size, m_ring.writable(), DECODECHUNKSIZE });
+    if (size == 0)
+      break;
+
+    const size_t bytesread = m_file->read(m_decode_buffer.get(), size);
+    m_ring.write(m_decode_buffer.get(), bytesread);
+    max_size -= bytesread;
+    decoded = decoded || bytesread > 0;
+
     // end of sound file
-    if (bytesread < STREAMFRAGMENTSIZE) {
-      if (m_looping)
+    if (bytesread < size)
+    {
+      // An empty file would loop forever.
+      if (m_looping && !(restarted && bytesread == 0))
+      {
         m_file->reset();
+        restarted = true;
+      }
       else
-        break;
+      {
+        m_end_of_stream = true;
+      }
+    }
+    else
+    {
+      restarted = false;
     }
-  } while(bytesread < STREAMFRAGMENTSIZE);
+  }
+
+  return decoded;
+}
+
+void
+StreamSoundSource::feed()
+{
+  std::lock_guard<std::recursive_mutex> lock(SoundManager::s_al_mutex);
+  ALint processed = 0;
+  ALint queued = 0;
+  alGetSourcei(m_source, AL_BUFFERS_PROCESSED, &processed);
+  alGetSourcei(m_source, AL_BUFFERS_QUEUED, &queued);
+  for (ALint i = 0; i < processed; ++i) {
+    ALuint buffer;
+    alSourceUnqueueBuffers(m_source, 1, &buffer);
+    m_free_buffers.push_back(buffer);
+  }
+  queued -= processed;
+
+  try
+  {
+    SoundManager::check_al_error("Couldn't unqueue audio buffer: ");
+  }
+  catch(std::exception& e)
+  {
+    set_error(e.what());
+  }
+
+  // stop() detaches all buffers from the source at once.
+  if (queued <= 0)
+    m_free_buffers.assign(m_buffers, m_buffers + STREAMFRAGMENTS);
+
+  ALint state = AL_STOPPED;
+  alGetSourcei(m_source, AL_SOURCE_STATE, &state);
+  const bool ran_dry = processed > 0 && queued <= 0 && state == AL_STOPPED;
+
+  bool requeued = false;
+  while (!m_free_buffers.empty())
+  {
+    // Read the flag first, everything decoded before it was set is
+    // readable then.
+    const bool end_of_stream = m_end_of_stream;
+    const size_t available = m_ring.readable();
+    if (available == 0 || (available < STREAMFRAGMENTSIZE && !end_of_stream))
+      break;
 
-  if (bytesread > 0) {
-    ALenum format = SoundManager::get_sample_format(*m_file);
+    const size_t size = m_ring.read(m_feed_buffer.get(), STREAMFRAGMENTSIZE);
+    const ALuint buffer = m_free_buffers.back();
     try
     {
-      alBufferData(buffer, format, bufferdata.get(), static_cast<ALsizei>(bytesread), m_file->m_rate);
+      alBufferData(buffer, m_format, m_feed_buffer.get(), static_cast<ALsizei>(size), m_rate);
       SoundManager::check_al_error("Couldn't refill audio buffer: ");
 
       alSourceQueueBuffers(m_source, 1, &buffer);
       SoundManager::check_al_error("Couldn't queue audio buffer: ");
+
+      m_free_buffers.pop_back();
+      requeued = true;
     }
     catch(std::exception& e)
     {
-      log_warning << e.what() << std::endl;
+      set_error(e.what());
+      break;
+    }
+  }
+
+  // we might have to restart the source if we had a buffer underrun
+  if (ran_dry && requeued && m_looping)
+  {
+    alSourcePlay(m_source);
+    ++m_underruns;
+  }
+}
+
+void
+StreamSoundSource::update_fade()
+{
+  std::lock_guard<std::recursive_mutex> lock(SoundManager::s_al_mutex);
+  if (m_fade_state == NoFading)
+    return;
+
+  const float time = std::chrono::duration<float>(Clock::now() - m_fade_start_time).count();
+  if (m_fade_state == FadingOn || m_fade_state == FadingResume) {
+    if (time >= m_fade_time) {
+      set_gain(1.0);
+      m_fade_state = NoFading;
+    } else {
+      set_gain(time / m_fade_time);
+    }
+  } else if (m_fade_state == FadingOff || m_fade_state == FadingPause) {
+    if (time >= m_fade_time) {
+      // Silent already, update() stops or pauses the source.
+      set_gain(0.0);
+      m_fade_action = (m_fade_state == FadingOff) ? ActionStop : ActionPause;
+      m_fade_state = NoFading;
+    } else {
+      set_gain( (m_fade_time - time) / m_fade_time);
     }
   }
+}
 
-  // return false if there aren't more buffers to fill
-  return bytesread >= STREAMFRAGMENTSIZE;
+void
+StreamSoundSource::set_error(const std::string& error)
+{
+  if (m_error.empty())
+    m_error = error;
 }
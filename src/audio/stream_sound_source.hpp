@@ -16,17 +16,42 @@
 
 #pragma once
 
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <string>
+#include <vector>
+
 #include "audio/openal_sound_source.hpp"
+#include "audio/ring_buffer.hpp"
 
 class SoundFile;
 
+/**
+ * Plays a sound file by decoding it in fragments. The SoundManager's
+ * streaming thread keeps the ring buffer filled from the file, moves
+ * fragments from there into the OpenAL queue and runs the fades, so
+ * that the music goes on however long the main thread takes for a
+ * frame. update() reports what happened on that thread, as logging
+ * isn't thread safe. Without the streaming thread update() does all
+ * of it.
+ */
 class StreamSoundSource final : public OpenALSoundSource
 {
+  friend class SoundManager;
+
 private:
   static const size_t STREAMBUFFERSIZE = 1024 * 500;
   static const size_t STREAMFRAGMENTS = 5;
   static const size_t STREAMFRAGMENTSIZE = STREAMBUFFERSIZE / STREAMFRAGMENTS;
 
+  /** Decoded audio waiting for a free OpenAL buffer, around six seconds
+      of 44.1 kHz 16 bit stereo. */
+  static const size_t DECODEBUFFERSIZE = 1024 * 1024;
+  /** How much a single decode() call decodes at most when called from
+      the decoder thread, so that streams take turns. */
+  static const size_t DECODECHUNKSIZE = 1024 * 64;
+
 public:
   enum FadeState { NoFading, FadingOn, FadingOff, FadingPause, FadingResume };
 
@@ -38,23 +63,58 @@ public:
   virtual void update() override;
   virtual void set_looping(bool looping_) override { m_looping = looping_; }
 
+  /** Decodes and queues the first fragments right away, so that the
+      source can be played as soon as this returns. */
   void set_sound_file(std::unique_ptr<SoundFile> newfile);
 
   void set_fading(FadeState state, float fadetime);
-  inline FadeState get_fade_state() const { return m_fade_state; }
+  FadeState get_fade_state() const;
   inline bool get_looping() const { return m_looping; }
 
 private:
-  bool fillBufferAndQueue(ALuint buffer);
+  /** Reads up to 'max_size' bytes from the file into the ring buffer.
+      Returns false if there was nothing to decode. */
+  bool decode(size_t max_size);
+
+  /** Refills the processed OpenAL buffers from the ring buffer and
+      queues them again. */
+  void feed();
+
+  /** Adjusts the gain of a running fade. At its end the source is
+      silent, update() stops or pauses it. */
+  void update_fade();
+
+  /** Keeps the first error of feed() for update() to log. */
+  void set_error(const std::string& error);
 
 private:
+  using Clock = std::chrono::steady_clock;
+
+  enum FadeAction { NoAction, ActionStop, ActionPause };
+
   std::unique_ptr<SoundFile> m_file;
+  ALenum m_format;
+  int m_rate;
   ALuint m_buffers[STREAMFRAGMENTS];
 
+  RingBuffer m_ring;
+  std::unique_ptr<char[]> m_decode_buffer;
+  std::atomic<bool> m_end_of_stream;
+
+  /** Buffers that are neither queued nor filled. */
+  std::vector<ALuint> m_free_buffers;
+  std::unique_ptr<char[]> m_feed_buffer;
+
+  /** The fade and the reports for update() are guarded by
+      SoundManager::s_al_mutex, like the gain. */
   FadeState m_fade_state;
-  float m_fade_start_time;
+  Clock::time_point m_fade_start_time;
   float m_fade_time;
-  bool m_looping;
+  FadeAction m_fade_action;
+  std::string m_error;
+  int m_underruns;
+
+  std::atomic<bool> m_looping;
 
 private:
   StreamSoundSource(const StreamSoundSource&) = delete;
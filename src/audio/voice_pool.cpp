@@ -0,0 +1,202 @@
+//  SuperTux
+//  Copyright (C) 2026 SuperTux Development Team
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#include "audio/voice_pool.hpp"
+
+#include <algorithm>
+
+VoicePool::VoicePool(size_t max_voices) :
+  m_voices(),
+  m_volume(1.0f),
+  m_stolen(0),
+  m_coalesced(0),
+  m_dropped(0)
+{
+  m_voices.reserve(max_voices);
+  for (size_t i = 0; i < max_voices; ++i)
+  {
+    ALuint source;
+    alGenSources(1, &source);
+    if (alGetError() != AL_NO_ERROR)
+      break;
+
+    m_voices.push_back({ source, {}, 0.0f, 0, 0.0f, 0 });
+  }
+}
+
+VoicePool::~VoicePool()
+{
+  for (const auto& voice : m_voices)
+  {
+    alSourceStop(voice.source);
+    alSourcei(voice.source, AL_BUFFER, AL_NONE);
+    alDeleteSources(1, &voice.source);
+  }
+}
+
+VoicePool::Result
+VoicePool::play(const Sound& sound, uint32_t time)
+{
+  Voice* free_voice = nullptr;
+  Voice* victim = nullptr;
+  for (auto& voice : m_voices)
+  {
+    if (!is_busy(voice))
+    {
+      if (!free_voice)
+        free_voice = &voice;
+      continue;
+    }
+
+    if (voice.buffer == sound.buffer && time - voice.start_time < COALESCE_TIME)
+    {
+      if (sound.gain > voice.gain)
+      {
+        voice.gain = sound.gain;
+        alSourcef(voice.source, AL_GAIN, std::min(voice.gain * m_volume, 1.0f));
+      }
+      voice.priority = std::max(voice.priority, sound.priority);
+      voice.distance = std::min(voice.distance, sound.distance);
+      m_coalesced += 1;
+      return COALESCED;
+    }
+
+    if (!victim || less_important(voice.priority, voice.distance, voice.start_time,
+                                  victim->priority, victim->distance, victim->start_time))
+      victim = &voice;
+  }
+
+  Result result = STARTED;
+  Voice* voice = free_voice;
+  if (!voice)
+  {
+    if (!victim || less_important(sound.priority, sound.distance, time,
+                                  victim->priority, victim->distance, victim->start_time))
+    {
+      m_dropped += 1;
+      return DROPPED;
+    }
+
+    voice = victim;
+    result = STOLEN;
+    m_stolen += 1;
+  }
+
+  const ALuint source = voice->source;
+  alSourceStop(source);
+  alSourcei(source, AL_BUFFER, static_cast<ALint>(*sound.buffer));
+  alSourcei(source, AL_LOOPING, AL_FALSE);
+  alSourcef(source, AL_PITCH, 1.0f);
+  alSourcef(source, AL_REFERENCE_DISTANCE, 128);
+  alSourcef(source, AL_GAIN, std::min(sound.gain * m_volume, 1.0f));
+  if (sound.position)
+  {
+    alSourcei(source, AL_SOURCE_RELATIVE, AL_FALSE);
+    alSource3f(source, AL_POSITION, sound.position->x, sound.position->y, 0);
+  }
+  else
+  {
+    alSourcei(source, AL_SOURCE_RELATIVE, AL_TRUE);
+    alSource3f(source, AL_POSITION, 0, 0, 0);
+  }
+  alSourcePlay(source);
+
+  voice->buffer = sound.buffer;
+  voice->gain = sound.gain;
+  voice->priority = sound.priority;
+  voice->distance = sound.distance;
+  voice->start_time = time;
+  return result;
+}
+
+void
+VoicePool::update()
+{
+  for (auto& voice : m_voices)
+  {
+    if (voice.buffer && !is_busy(voice))
+    {
+      alSourcei(voice.source, AL_BUFFER, AL_NONE);
+      voice.buffer.reset();
+    }
+  }
+}
+
+void
+VoicePool::pause_all()
+{
+  for (const auto& voice : m_voices)
+  {
+    ALint state;
+    alGetSourcei(voice.source, AL_SOURCE_STATE, &state);
+    if (state == AL_PLAYING)
+      alSourcePause(voice.source);
+  }
+}
+
+void
+VoicePool::resume_all()
+{
+  for (const auto& voice : m_voices)
+  {
+    ALint state;
+    alGetSourcei(voice.source, AL_SOURCE_STATE, &state);
+    if (state == AL_PAUSED)
+      alSourcePlay(voice.source);
+  }
+}
+
+void
+VoicePool::stop_all()
+{
+  for (const auto& voice : m_voices)
+    alSourceStop(voice.source);
+}
+
+void
+VoicePool::set_volume(float volume)
+{
+  m_volume = volume;
+  for (const auto& voice : m_voices)
+    alSourcef(voice.source, AL_GAIN, std::min(voice.gain * m_volume, 1.0f));
+}
+
+size_t
+VoicePool::get_playing_count() const
+{
+  return static_cast<size_t>(std::count_if(m_voices.begin(), m_voices.end(),
+                                           [this](const Voice& voice) { return is_busy(voice); }));
+}
+
+bool
+VoicePool::is_busy(const Voice& voice) const
+{
+  ALint state = AL_STOPPED;
+  alGetSourcei(voice.source, AL_SOURCE_STATE, &state);
+  return state == AL_PLAYING || state == AL_PAUSED;
+}
+
+bool
+VoicePool::less_important(int lhs_priority, float lhs_distance, uint32_t lhs_time,
+                          int rhs_priority, float rhs_distance, uint32_t rhs_time)
+{
+  if (lhs_priority != rhs_priority)
+    return lhs_priority < rhs_priority;
+  if (lhs_distance != rhs_distance)
+    return lhs_distance > rhs_distance;
+  // The older sound has less left to play.
+  return lhs_time < rhs_time;
+}
@@ -0,0 +1,106 @@
+//  SuperTux
+//  Copyright (C) 2026 SuperTux Development Team
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#pragma once
+
+#include <al.h>
+#include <memory>
+#include <optional>
+#include <stdint.h>
+#include <vector>
+
+#include "math/vector.hpp"
+
+/**
+ * A fixed set of OpenAL sources for fire-and-forget sounds. When all of
+ * them are busy, the least important sound gets cut off for a more
+ * important one, or the new sound is dropped. Plays of the same buffer
+ * that start almost at once are merged into one voice.
+ */
+class VoicePool final
+{
+public:
+  /** Plays of the same buffer closer together than this share a voice. */
+  static const uint32_t COALESCE_TIME = 15;
+
+  struct Sound
+  {
+    std::shared_ptr<const ALuint> buffer;
+    float gain;
+    /** Higher priorities cut off lower ones. */
+    int priority;
+    /** Distance to the listener, farther sounds get cut off first. */
+    float distance;
+    /** Position in the world, none for sounds relative to the listener. */
+    std::optional<Vector> position;
+  };
+
+  enum Result { STARTED, STOLEN, COALESCED, DROPPED };
+
+private:
+  struct Voice
+  {
+    ALuint source;
+    /** Keeps the buffer cached while the voice uses it. */
+    std::shared_ptr<const ALuint> buffer;
+    float gain;
+    int priority;
+    float distance;
+    uint32_t start_time;
+  };
+
+public:
+  /** Creates up to 'max_voices' sources, fewer if OpenAL runs out. */
+  explicit VoicePool(size_t max_voices);
+  ~VoicePool();
+
+  /** Starts 'sound' at 'time' milliseconds. */
+  Result play(const Sound& sound, uint32_t time);
+
+  /** Lets go of the buffers of finished voices. */
+  void update();
+
+  void pause_all();
+  void resume_all();
+  void stop_all();
+  void set_volume(float volume);
+
+  inline size_t size() const { return m_voices.size(); }
+  size_t get_playing_count() const;
+
+  inline int get_stolen_count() const { return m_stolen; }
+  inline int get_coalesced_count() const { return m_coalesced; }
+  inline int get_dropped_count() const { return m_dropped; }
+
+private:
+  bool is_busy(const Voice& voice) const;
+
+  /** Whether 'lhs' should be cut off before 'rhs'. */
+  static bool less_important(int lhs_priority, float lhs_distance, uint32_t lhs_time,
+                             int rhs_priority, float rhs_distance, uint32_t rhs_time);
+
+private:
+  std::vector<Voice> m_voices;
+  float m_volume;
+
+  int m_stolen;
+  int m_coalesced;
+  int m_dropped;
+
+private:
+  VoicePool(const VoicePool&) = delete;
+  VoicePool& operator=(const VoicePool&) = delete;
+};
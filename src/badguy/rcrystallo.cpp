@@ -71,7 +71,7 @@ RCrystallo::initialize()
   }
   else
   {
-    m_col.m_bbox.move(Vector(3.f, 0.f));
+    m_col.move(Vector(3.f, 0.f));
     set_action(m_dir == Direction::LEFT ? "roof-detected-left" : "roof-detected-right", 1, ANCHOR_TOP);
   }
 }
@@ -119,7 +119,7 @@ RCrystallo::active_update(float dt_sec)
         player->get_bbox().get_middle() - Vector(0, 40), false, player))
     {
       // Center enemy, begin falling.
-      m_col.m_bbox.move(Vector(3.f, 0.f));
+      m_col.move(Vector(3.f, 0.f));
       set_action(m_dir == Direction::LEFT ? "roof-detected-left" : "roof-detected-right", 1, ANCHOR_TOP);
       m_state = RCRYSTALLO_DETECT;
     }
@@ -0,0 +1,169 @@
+//  SuperTux
+//  Copyright (C) 2026 SuperTux Development Team
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#include "collision/collision_grid.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+#include "math/rectf.hpp"
+
+namespace {
+
+/** Objects covering more cells than this are not worth hashing. */
+const int MAX_CELLS_PER_ENTRY = 1024;
+
+/** Keeps cell coordinates far away from integer overflow. */
+const float MAX_CELL_COORD = 1.0e6f;
+
+void erase_index(std::vector<size_t>& list, size_t index)
+{
+  auto it = std::find(list.begin(), list.end(), index);
+  if (it != list.end())
+  {
+    *it = list.back();
+    list.pop_back();
+  }
+}
+
+} // namespace
+
+CollisionGrid::CollisionGrid(float cell_size) :
+  m_cell_size(cell_size),
+  m_cells(),
+  m_oversized()
+{
+}
+
+void
+CollisionGrid::clear()
+{
+  for (auto& cell : m_cells)
+    cell.second.clear();
+  m_oversized.clear();
+}
+
+CollisionGrid::CellRange
+CollisionGrid::get_cell_range(const Rectf& rect) const
+{
+  const float left = std::min(rect.get_left(), rect.get_right()) / m_cell_size;
+  const float right = std::max(rect.get_left(), rect.get_right()) / m_cell_size;
+  const float top = std::min(rect.get_top(), rect.get_bottom()) / m_cell_size;
+  const float bottom = std::max(rect.get_top(), rect.get_bottom()) / m_cell_size;
+
+  // Also catches NaN, since all comparisons with it are false.
+  if (!(left > -MAX_CELL_COORD && right < MAX_CELL_COORD &&
+        top > -MAX_CELL_COORD && bottom < MAX_CELL_COORD))
+    return { 0, 0, -1, -1, true };
+
+  CellRange range;
+  range.x1 = static_cast<int>(std::floor(left));
+  range.y1 = static_cast<int>(std::floor(top));
+  range.x2 = static_cast<int>(std::floor(right));
+  range.y2 = static_cast<int>(std::floor(bottom));
+  range.oversized = static_cast<int64_t>(range.x2 - range.x1 + 1) *
+                    static_cast<int64_t>(range.y2 - range.y1 + 1) > MAX_CELLS_PER_ENTRY;
+  return range;
+}
+
+uint64_t
+CollisionGrid::get_cell_key(int x, int y)
+{
+  return (static_cast<uint64_t>(static_cast<uint32_t>(x)) << 32) | static_cast<uint32_t>(y);
+}
+
+void
+CollisionGrid::insert(size_t index, const Rectf& rect)
+{
+  const CellRange range = get_cell_range(rect);
+  if (range.oversized)
+  {
+    m_oversized.push_back(index);
+    return;
+  }
+
+  for (int y = range.y1; y <= range.y2; ++y)
+    for (int x = range.x1; x <= range.x2; ++x)
+      m_cells[get_cell_key(x, y)].push_back(index);
+}
+
+void
+CollisionGrid::remove(size_t index, const Rectf& rect)
+{
+  const CellRange range = get_cell_range(rect);
+  if (range.oversized)
+  {
+    erase_index(m_oversized, index);
+    return;
+  }
+
+  for (int y = range.y1; y <= range.y2; ++y)
+  {
+    for (int x = range.x1; x <= range.x2; ++x)
+    {
+      auto it = m_cells.find(get_cell_key(x, y));
+      if (it != m_cells.end())
+        erase_index(it->second, index);
+    }
+  }
+}
+
+void
+CollisionGrid::move(size_t index, const Rectf& old_rect, const Rectf& new_rect)
+{
+  remove(index, old_rect);
+  insert(index, new_rect);
+}
+
+void
+CollisionGrid::query(const Rectf& rect, std::vector<size_t>& result) const
+{
+  result.clear();
+  result.insert(result.end(), m_oversized.begin(), m_oversized.end());
+
+  const CellRange range = get_cell_range(rect);
+  if (range.oversized)
+  {
+    // Querying with a huge rect, give back everything.
+    for (const auto& cell : m_cells)
+      result.insert(result.end(), cell.second.begin(), cell.second.end());
+  }
+  else
+  {
+    for (int y = range.y1; y <= range.y2; ++y)
+    {
+      for (int x = range.x1; x <= range.x2; ++x)
+      {
+        auto it = m_cells.find(get_cell_key(x, y));
+        if (it != m_cells.end())
+          result.insert(result.end(), it->second.begin(), it->second.end());
+      }
+    }
+  }
+
+  std::sort(result.begin(), result.end());
+  result.erase(std::unique(result.begin(), result.end()), result.end());
+}
+
+void
+CollisionGrid::query_cell(int x, int y, std::vector<size_t>& result) const
+{
+  result.insert(result.end(), m_oversized.begin(), m_oversized.end());
+
+  auto it = m_cells.find(get_cell_key(x, y));
+  if (it != m_cells.end())
+    result.insert(result.end(), it->second.begin(), it->second.end());
+}
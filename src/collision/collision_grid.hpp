@@ -0,0 +1,77 @@
+//  SuperTux
+//  Copyright (C) 2026 SuperTux Development Team
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include <unordered_map>
+#include <vector>
+
+class Rectf;
+
+/**
+ * Uniform grid broadphase used by the CollisionSystem.
+ *
+ * Entries are identified by an index (the position of the object in the
+ * CollisionSystem's object list), and queries return the candidate
+ * indices sorted in ascending order, so callers can walk them in the
+ * exact same order as a full scan over the object list would.
+ *
+ * Rectangles that cover too many cells (or have non-finite coordinates)
+ * are kept in a separate list that is returned by every query.
+ */
+class CollisionGrid final
+{
+public:
+  CollisionGrid(float cell_size = 128.0f);
+
+  /** Removes all entries, keeping the allocated cells for reuse. */
+  void clear();
+
+  void insert(size_t index, const Rectf& rect);
+  void remove(size_t index, const Rectf& rect);
+  void move(size_t index, const Rectf& old_rect, const Rectf& new_rect);
+
+  /** Fills 'result' with the sorted, unique indices of all entries
+      that may overlap 'rect'. Candidates still need an exact test. */
+  void query(const Rectf& rect, std::vector<size_t>& result) const;
+
+  /** Appends the indices of all entries in cell (x, y) to 'result',
+      unsorted and including the oversized entries. */
+  void query_cell(int x, int y, std::vector<size_t>& result) const;
+
+  inline float get_cell_size() const { return m_cell_size; }
+
+private:
+  struct CellRange
+  {
+    int x1, y1, x2, y2;
+    bool oversized;
+  };
+
+  CellRange get_cell_range(const Rectf& rect) const;
+  static uint64_t get_cell_key(int x, int y);
+
+private:
+  const float m_cell_size;
+  std::unordered_map<uint64_t, std::vector<size_t>> m_cells;
+  std::vector<size_t> m_oversized;
+
+private:
+  CollisionGrid(const CollisionGrid&) = delete;
+  CollisionGrid& operator=(const CollisionGrid&) = delete;
+};
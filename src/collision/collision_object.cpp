@@ -18,10 +18,12 @@
 #include "collision/collision_object.hpp"
 
 #include "collision/collision_movement_manager.hpp"
+#include "collision/collision_system.hpp"
 #include "supertux/moving_object.hpp"
 
 CollisionObject::CollisionObject(CollisionGroup group, MovingObject& parent) :
   m_parent(parent),
+  m_collision_system(nullptr),
   m_bbox(),
   m_group(group),
   m_movement(0.0f, 0.0f),
@@ -33,6 +35,51 @@ CollisionObject::CollisionObject(CollisionGroup group, MovingObject& parent) :
 {
 }
 
+void
+CollisionObject::set_pos(const Vector& pos)
+{
+  m_dest.move(pos - get_pos());
+  m_bbox.set_pos(pos);
+  invalidate_raycasts();
+}
+
+void
+CollisionObject::move(const Vector& dist)
+{
+  m_bbox.move(dist);
+  invalidate_raycasts();
+}
+
+void
+CollisionObject::set_width(float w)
+{
+  m_dest.set_width(w);
+  m_bbox.set_width(w);
+  invalidate_raycasts();
+}
+
+void
+CollisionObject::set_size(float w, float h)
+{
+  m_dest.set_size(w, h);
+  m_bbox.set_size(w, h);
+  invalidate_raycasts();
+}
+
+void
+CollisionObject::set_group(CollisionGroup group)
+{
+  m_group = group;
+  invalidate_raycasts();
+}
+
+void
+CollisionObject::invalidate_raycasts()
+{
+  if (m_collision_system)
+    m_collision_system->invalidate_raycast_grid();
+}
+
 void
 CollisionObject::collision_solid(const CollisionHit& hit)
 {
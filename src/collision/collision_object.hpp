@@ -26,6 +26,7 @@
 #include "math/rectf.hpp"
 
 class CollisionGroundMovementManager;
+class CollisionSystem;
 class MovingObject;
 
 class CollisionObject
@@ -85,11 +86,7 @@ public:
   /** places the moving object at a specific position. Be careful when
       using this function. There are no collision detection checks
       performed here so bad things could happen. */
-  void set_pos(const Vector& pos)
-  {
-    m_dest.move(pos - get_pos());
-    m_bbox.set_pos(pos);
-  }
+  void set_pos(const Vector& pos);
 
   inline Vector get_pos() const
   {
@@ -109,36 +106,42 @@ public:
     set_pos(pos);
   }
 
+  /** moves the object's bbox by 'dist'. Be careful when using this
+      function. There are no collision detection checks performed
+      here so bad things could happen. */
+  void move(const Vector& dist);
+
   /** sets the moving object's bbox to a specific width. Be careful
       when using this function. There are no collision detection
       checks performed here so bad things could happen. */
-  void set_width(float w)
-  {
-    m_dest.set_width(w);
-    m_bbox.set_width(w);
-  }
+  void set_width(float w);
 
   /** sets the moving object's bbox to a specific size. Be careful
       when using this function. There are no collision detection
       checks performed here so bad things could happen. */
-  void set_size(float w, float h)
-  {
-    m_dest.set_size(w, h);
-    m_bbox.set_size(w, h);
-  }
+  void set_size(float w, float h);
 
   inline CollisionGroup get_group() const
   {
     return m_group;
   }
 
+  void set_group(CollisionGroup group);
+
   bool is_valid() const;
 
   inline MovingObject& get_parent() { return m_parent; }
 
+private:
+  /** Lets the collision system know that its raycast grid is out of date. */
+  void invalidate_raycasts();
+
 private:
   MovingObject& m_parent;
 
+  /** The collision system the object was added to, if any. */
+  CollisionSystem* m_collision_system;
+
 public:
   /** The bounding box of the object (as used for collision detection,
       this isn't necessarily the bounding box for graphics) */
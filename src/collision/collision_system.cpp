@@ -17,28 +17,45 @@
 
 #include "collision/collision_system.hpp"
 
+#include <algorithm>
+#include <limits>
+
 #include "collision/collision.hpp"
 #include "collision/collision_movement_manager.hpp"
+#include "collision/collision_object.hpp"
 #include "editor/editor.hpp"
 #include "math/aatriangle.hpp"
+#include "math/grid_line_walker.hpp"
 #include "math/rect.hpp"
 #include "object/player.hpp"
 #include "object/tilemap.hpp"
 #include "supertux/constants.hpp"
 #include "supertux/sector.hpp"
 #include "supertux/tile.hpp"
+#include "supertux/tile_attribute_grid.hpp"
 #include "video/color.hpp"
 #include "video/drawing_context.hpp"
 
 namespace
 {
   const float MAX_SPEED = 16.0f;
+
+  /** Whether raycasts stop at 'object'. */
+  bool is_raycast_obstacle(const CollisionObject& object)
+  {
+    return object.get_group() == COLGROUP_MOVING
+      || object.get_group() == COLGROUP_MOVING_STATIC
+      || object.get_group() == COLGROUP_STATIC;
+  }
 } // namespace
 
 CollisionSystem::CollisionSystem(Sector& sector) :
   m_sector(sector),
   m_objects(),
-  m_ground_movement_manager(new CollisionGroundMovementManager)
+  m_ground_movement_manager(new CollisionGroundMovementManager),
+  m_grid(),
+  m_candidates(),
+  m_raycast_grid()
 {
 }
 
@@ -46,7 +63,9 @@ void
 CollisionSystem::add(CollisionObject* object)
 {
   object->set_ground_movement_manager(m_ground_movement_manager);
+  object->m_collision_system = this;
   m_objects.push_back(object);
+  m_raycast_grid.invalidate();
 }
 
 void
@@ -55,6 +74,8 @@ CollisionSystem::remove(CollisionObject* object)
   m_objects.erase(
     std::find(m_objects.begin(), m_objects.end(),
       object));
+  object->m_collision_system = nullptr;
+  m_raycast_grid.invalidate();
 
   // FIXME: This is a patch. A better way of fixing this is coming.
   for (auto* collision_object : m_objects) {
@@ -233,8 +254,16 @@ CollisionSystem::collision_tilemap(collision::Constraints* constraints,
   const float y1 = dest.get_top();
   const float y2 = dest.get_bottom();
 
+  const TileAttributeGrid& attributes = m_sector.get_solid_tile_attributes();
+  const bool any_solid = (attributes.get_attributes(Rectf(x1, y1, x2, y2)) & Tile::SOLID) != 0;
+
   for (auto* solids : m_sector.get_solid_tilemaps())
   {
+    int ax, ay;
+    const bool merged = attributes.get_tilemap_position(*solids, ax, ay);
+    if (merged && !any_solid)
+      continue;
+
     // Test with all tiles in this rectangle.
     const Rect test_tiles = solids->get_tiles_overlapping(Rectf(x1, y1, x2, y2));
 
@@ -244,6 +273,9 @@ CollisionSystem::collision_tilemap(collision::Constraints* constraints,
     {
       for (int y = test_tiles.top; y < test_tiles.bottom; ++y)
       {
+        if (merged && !(attributes.get(ax + x, ay + y) & Tile::SOLID))
+          continue;
+
         const Tile& tile = solids->get_tile(x, y);
 
         // Skip non-solid tiles.
@@ -301,9 +333,17 @@ CollisionSystem::collision_tile_attributes(const Rectf& dest, const Vector& mov)
   const float x2 = dest.get_right();
   const float y2 = dest.get_bottom();
 
+  const TileAttributeGrid& attributes = m_sector.get_solid_tile_attributes();
+  const bool any_attributes = attributes.get_attributes(Rectf(x1, y1, x2, y2 + SHIFT_DELTA)) != 0;
+
   uint32_t result = 0;
   for (auto& solids : m_sector.get_solid_tilemaps())
   {
+    int ax, ay;
+    const bool merged = attributes.get_tilemap_position(*solids, ax, ay);
+    if (merged && !any_attributes)
+      continue;
+
     // Test with all tiles in this rectangle.
     const Rect test_tiles = solids->get_tiles_overlapping(Rectf(x1, y1, x2, y2));
 
@@ -313,6 +353,9 @@ CollisionSystem::collision_tile_attributes(const Rectf& dest, const Vector& mov)
     for (int x = test_tiles.left; x < test_tiles.right; ++x) {
       int y;
       for (y = test_tiles.top; y < test_tiles.bottom; ++y) {
+        if (merged && !attributes.get(ax + x, ay + y))
+          continue;
+
         const Tile& tile = solids->get_tile(x, y);
 
         if (tile.is_collisionful(solids->get_tile_bbox(x, y), dest, mov)) {
@@ -320,6 +363,9 @@ CollisionSystem::collision_tile_attributes(const Rectf& dest, const Vector& mov)
         }
       }
       for (; y < test_tiles_ice.bottom; ++y) {
+        if (merged && !(attributes.get(ax + x, ay + y) & Tile::ICE))
+          continue;
+
         const Tile& tile = solids->get_tile(x, y);
         if (tile.is_collisionful(solids->get_tile_bbox(x, y), dest, mov)) {
           result |= (tile.get_attributes() & Tile::ICE);
@@ -583,6 +629,7 @@ void
 CollisionSystem::update()
 {
   if (Editor::is_active()) {
+    m_raycast_grid.invalidate();
     return;
     // Objects in editor shouldn't collide.
   }
@@ -633,6 +680,12 @@ CollisionSystem::update()
   }
 
   // Part 2.5: COLGROUP_MOVING vs COLGROUP_TOUCHABLE.
+  m_grid.clear();
+  for (size_t i = 0; i < m_objects.size(); ++i) {
+    if (m_objects[i]->get_group() == COLGROUP_TOUCHABLE)
+      m_grid.insert(i, m_objects[i]->m_dest);
+  }
+
   for (const auto& object : m_objects)
   {
     if ((object->get_group() != COLGROUP_MOVING
@@ -640,7 +693,11 @@ CollisionSystem::update()
       || !object->is_valid())
       continue;
 
-    for (auto& object_2 : m_objects) {
+    query_candidates(object->m_dest, 0);
+    size_t c = 0;
+    while (c < m_candidates.size()) {
+      const size_t j = m_candidates[c++];
+      auto* object_2 = m_objects[j];
       if (object_2->get_group() != COLGROUP_TOUCHABLE
         || !object_2->is_valid())
         continue;
@@ -654,30 +711,65 @@ CollisionSystem::update()
         if (!object_2->collides(*object, hit))
           continue;
 
+        const Rectf dest = object->m_dest;
+        const Rectf dest_2 = object_2->m_dest;
+
         object->collision(*object_2, hit);
         object_2->collision(*object, hit);
+
+        // Collision handlers may reposition either object (e.g. teleports),
+        // keep the grid and the remaining candidates in sync with that.
+        if (!(object_2->m_dest == dest_2))
+          m_grid.move(j, dest_2, object_2->m_dest);
+        if (!(object->m_dest == dest)) {
+          query_candidates(object->m_dest, j + 1);
+          c = 0;
+        }
       }
     }
   }
 
   // Part 3: COLGROUP_MOVING vs COLGROUP_MOVING.
-  for (auto i = m_objects.begin(); i != m_objects.end(); ++i)
+  m_grid.clear();
+  for (size_t i = 0; i < m_objects.size(); ++i) {
+    if (m_objects[i]->get_group() == COLGROUP_MOVING
+      || m_objects[i]->get_group() == COLGROUP_MOVING_STATIC)
+      m_grid.insert(i, m_objects[i]->m_dest);
+  }
+
+  for (size_t i = 0; i < m_objects.size(); ++i)
   {
-    auto object = *i;
+    auto* object = m_objects[i];
 
     if (!object->is_valid() ||
       (object->get_group() != COLGROUP_MOVING &&
         object->get_group() != COLGROUP_MOVING_STATIC))
       continue;
 
-    for (auto i2 = i + 1; i2 != m_objects.end(); ++i2) {
-      auto object_2 = *i2;
+    query_candidates(object->m_dest, i + 1);
+    size_t c = 0;
+    while (c < m_candidates.size()) {
+      const size_t j = m_candidates[c++];
+      auto* object_2 = m_objects[j];
       if ((object_2->get_group() != COLGROUP_MOVING
         && object_2->get_group() != COLGROUP_MOVING_STATIC)
         || !object_2->is_valid())
         continue;
 
+      const Rectf dest = object->m_dest;
+      const Rectf dest_2 = object_2->m_dest;
+
       collision_object(object, object_2);
+
+      // Collision response pushes both objects apart, which can create
+      // (or resolve) overlaps with objects that come later in the list.
+      if (!(object_2->m_dest == dest_2))
+        m_grid.move(j, dest_2, object_2->m_dest);
+      if (!(object->m_dest == dest)) {
+        m_grid.move(i, dest, object->m_dest);
+        query_candidates(object->m_dest, j + 1);
+        c = 0;
+      }
     }
   }
 
@@ -686,6 +778,16 @@ CollisionSystem::update()
     object->m_bbox = object->m_dest;
     object->m_movement = Vector(0, 0);
   }
+
+  m_raycast_grid.invalidate();
+}
+
+void
+CollisionSystem::query_candidates(const Rectf& rect, size_t first_index)
+{
+  m_grid.query(rect, m_candidates);
+  m_candidates.erase(m_candidates.begin(),
+                     std::lower_bound(m_candidates.begin(), m_candidates.end(), first_index));
 }
 
 bool
@@ -693,12 +795,23 @@ CollisionSystem::is_free_of_tiles(const Rectf& rect, const bool ignoreUnisolid,
 {
   using namespace collision;
 
+  const TileAttributeGrid& attributes = m_sector.get_solid_tile_attributes();
+  const bool any_tiletype = (attributes.get_attributes(rect) & tiletype) != 0;
+
   for (const auto& solids : m_sector.get_solid_tilemaps()) {
+    int ax, ay;
+    const bool merged = attributes.get_tilemap_position(*solids, ax, ay);
+    if (merged && !any_tiletype)
+      continue;
+
     // Test with all tiles in this rectangle.
     const Rect test_tiles = solids->get_tiles_overlapping(rect);
 
     for (int x = test_tiles.left; x < test_tiles.right; ++x) {
       for (int y = test_tiles.top; y < test_tiles.bottom; ++y) {
+        if (merged && !(attributes.get(ax + x, ay + y) & tiletype))
+          continue;
+
         const Tile& tile = solids->get_tile(x, y);
 
         if (!(tile.get_attributes() & tiletype))
@@ -788,58 +901,48 @@ CollisionSystem::get_first_line_intersection(const Vector& line_start,
 
   if (ignore != IGNORE_TILES)
   {
-    // Check if no tile is in the way.
-    const float lsx = std::min(line_start.x, line_end.x);
-    const float lex = std::max(line_start.x, line_end.x);
-    const float lsy = std::min(line_start.y, line_end.y);
-    const float ley = std::max(line_start.y, line_end.y);
-
-    for (float test_x = lsx; test_x <= lex; test_x += 16) { // NOLINT.
-      for (float test_y = lsy; test_y <= ley; test_y += 16) { // NOLINT.
-        for (const auto& solids : m_sector.get_solid_tilemaps()) {
-          const auto& test_vector = Vector(test_x, test_y);
-          if (solids->is_outside_bounds(test_vector))
-          {
-            continue;
-          }
+    // Walk the tiles along the line and stop at the first solid one.
+    const TileAttributeGrid& attributes = m_sector.get_solid_tile_attributes();
+    float best_t = std::numeric_limits<float>::infinity();
+    for (const auto& solids : m_sector.get_solid_tilemaps()) {
+      int ax, ay;
+      const bool merged = attributes.get_tilemap_position(*solids, ax, ay);
+
+      GridLineWalker walker(line_start - solids->get_offset(), line_end - solids->get_offset(), 32.0f);
+      while (walker.next() && walker.get_t() < best_t) {
+        const int x = walker.get_x();
+        const int y = walker.get_y();
+        if (x < 0 || y < 0 || x >= solids->get_width() || y >= solids->get_height())
+          continue;
+        if (merged && !(attributes.get(ax + x, ay + y) & Tile::SOLID))
+          continue;
 
-          const Tile* tile = &solids->get_tile_at(test_vector);
+        const Tile& tile = solids->get_tile(x, y);
 
-          // FIXME: check collision with slope tiles
-          if ((tile->get_attributes() & Tile::SOLID))
-          {
-            tileresult.is_valid = true;
-            tileresult.hit = tile;
-            tileresult.box = solids->get_tile_bbox(static_cast<int>(test_vector.x / 32.f), static_cast<int>(test_vector.y / 32.f));
-            goto finish_tiles;
-          }
+        // FIXME: check collision with slope tiles
+        if (tile.get_attributes() & Tile::SOLID)
+        {
+          best_t = walker.get_t();
+          tileresult.is_valid = true;
+          tileresult.hit = &tile;
+          tileresult.box = solids->get_tile_bbox(x, y);
+          break;
         }
       }
     }
   }
 
-finish_tiles:
   if (ignore == IGNORE_OBJECTS)
     return tileresult;
 
   RaycastResult objresult;
 
   // Check if no object is in the way.
-  for (const auto& object : m_objects) {
-    if (object == ignore_object) continue;
-    if (!object->is_valid()) continue;
-    if ((object->get_group() == COLGROUP_MOVING)
-      || (object->get_group() == COLGROUP_MOVING_STATIC)
-      || (object->get_group() == COLGROUP_STATIC))
-    {
-      if (intersects_line(object->get_bbox(), line_start, line_end))
-      {
-        objresult.is_valid = true;
-        objresult.hit = object;
-        objresult.box = object->get_bbox();
-        break;
-      }
-    }
+  if (auto* object = get_first_object_on_line(line_start, line_end, ignore_object))
+  {
+    objresult.is_valid = true;
+    objresult.hit = object;
+    objresult.box = object->get_bbox();
   }
 
   if (ignore == IGNORE_TILES)
@@ -861,6 +964,25 @@ finish_tiles:
   }
 }
 
+CollisionObject*
+CollisionSystem::get_first_object_on_line(const Vector& line_start, const Vector& line_end,
+                                          const CollisionObject* ignore_object) const
+{
+  m_raycast_grid.update(m_objects.size(), [this](size_t i) -> const Rectf* {
+    return is_raycast_obstacle(*m_objects[i]) ? &m_objects[i]->get_bbox() : nullptr;
+  });
+
+  const auto index = m_raycast_grid.get_first_on_line(line_start, line_end,
+    [this, ignore_object](size_t i) -> const Rectf* {
+      const CollisionObject* object = m_objects[i];
+      if (object == ignore_object || !object->is_valid() || !is_raycast_obstacle(*object))
+        return nullptr;
+      return &object->get_bbox();
+    });
+
+  return index ? m_objects[*index] : nullptr;
+}
+
 bool
 CollisionSystem::free_line_of_sight(const Vector& line_start, const Vector& line_end, bool ignore_objects, const CollisionObject* ignore_object) const
 {
@@ -23,6 +23,8 @@
 #include <stdint.h>
 
 #include "collision/collision.hpp"
+#include "collision/collision_grid.hpp"
+#include "collision/raycast_grid.hpp"
 #include "supertux/tile.hpp"
 #include "math/fwd.hpp"
 
@@ -48,6 +50,9 @@ public:
   void add(CollisionObject* object);
   void remove(CollisionObject* object);
 
+  /** Called by objects that moved or changed their group outside of update(). */
+  inline void invalidate_raycast_grid() { m_raycast_grid.invalidate(); }
+
   /** Draw collision shapes for debugging */
   void draw(DrawingContext& context);
 
@@ -106,6 +111,15 @@ private:
   void get_hit_normal(const CollisionObject* object1, const CollisionObject* object2,
                       CollisionHit& hit, Vector& normal) const;
 
+  /** Fills m_candidates with the indices (into m_objects) of all grid
+      entries near 'rect', starting at 'first_index', in list order. */
+  void query_candidates(const Rectf& rect, size_t first_index);
+
+  /** Returns the obstacle object closest to 'line_start' whose bbox is
+      crossed by the line, or nullptr if there is none. */
+  CollisionObject* get_first_object_on_line(const Vector& line_start, const Vector& line_end,
+                                            const CollisionObject* ignore_object) const;
+
 private:
   Sector& m_sector;
 
@@ -113,6 +127,17 @@ private:
 
   std::shared_ptr<CollisionGroundMovementManager> m_ground_movement_manager;
 
+  /** Broadphase for the object vs. object passes of update(), rebuilt
+      from m_dest for each pass. */
+  CollisionGrid m_grid;
+  std::vector<size_t> m_candidates;
+
+  /** Bboxes of all obstacle objects for raycasts, lazily rebuilt after
+      objects were added, removed, moved or changed their group. Code
+      that moves objects has to go through the setters of
+      CollisionObject, direct writes to its m_bbox are not noticed. */
+  mutable RaycastGrid m_raycast_grid;
+
 private:
   CollisionSystem(const CollisionSystem&) = delete;
   CollisionSystem& operator=(const CollisionSystem&) = delete;
@@ -0,0 +1,105 @@
+//  SuperTux
+//  Copyright (C) 2026 SuperTux Development Team
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#include "collision/raycast_grid.hpp"
+
+#include <algorithm>
+#include <limits>
+
+#include "collision/collision.hpp"
+#include "math/grid_line_walker.hpp"
+#include "math/rectf.hpp"
+
+namespace {
+
+/** Returns the position along the line (0 = start, 1 = end) at which
+    it enters 'rect', or 0 if it starts inside of it. */
+float
+get_line_entry(const Rectf& rect, const Vector& line_start, const Vector& line_end)
+{
+  const Vector dir = line_end - line_start;
+  float t_enter = 0.0f;
+
+  if (dir.x != 0.0f) {
+    const float t1 = (rect.get_left() - line_start.x) / dir.x;
+    const float t2 = (rect.get_right() - line_start.x) / dir.x;
+    t_enter = std::max(t_enter, std::min(t1, t2));
+  }
+  if (dir.y != 0.0f) {
+    const float t1 = (rect.get_top() - line_start.y) / dir.y;
+    const float t2 = (rect.get_bottom() - line_start.y) / dir.y;
+    t_enter = std::max(t_enter, std::min(t1, t2));
+  }
+
+  return t_enter;
+}
+
+} // namespace
+
+RaycastGrid::RaycastGrid(float cell_size) :
+  m_grid(cell_size),
+  m_candidates(),
+  m_dirty(true)
+{
+}
+
+void
+RaycastGrid::update(size_t count, const GetRect& get_rect)
+{
+  if (!m_dirty)
+    return;
+
+  m_grid.clear();
+  for (size_t i = 0; i < count; ++i)
+  {
+    if (const Rectf* rect = get_rect(i))
+      m_grid.insert(i, *rect);
+  }
+  m_dirty = false;
+}
+
+std::optional<size_t>
+RaycastGrid::get_first_on_line(const Vector& line_start, const Vector& line_end,
+                               const GetRect& get_rect)
+{
+  std::optional<size_t> result;
+  float best_t = std::numeric_limits<float>::infinity();
+
+  // A hit at 'best_t' lies inside a cell that is entered at or before
+  // 'best_t', so no cell past that can contain a closer hit.
+  GridLineWalker walker(line_start, line_end, m_grid.get_cell_size());
+  while (walker.next() && walker.get_t() <= best_t)
+  {
+    m_candidates.clear();
+    m_grid.query_cell(walker.get_x(), walker.get_y(), m_candidates);
+
+    for (const size_t i : m_candidates)
+    {
+      const Rectf* rect = get_rect(i);
+      if (!rect || !collision::intersects_line(*rect, line_start, line_end))
+        continue;
+
+      const float t = get_line_entry(*rect, line_start, line_end);
+      if (t < best_t || (result && t == best_t && i < *result))
+      {
+        result = i;
+        best_t = t;
+      }
+    }
+  }
+
+  return result;
+}
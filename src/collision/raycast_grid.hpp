@@ -0,0 +1,66 @@
+//  SuperTux
+//  Copyright (C) 2026 SuperTux Development Team
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#pragma once
+
+#include <functional>
+#include <optional>
+#include <vector>
+
+#include "collision/collision_grid.hpp"
+#include "math/vector.hpp"
+
+class Rectf;
+
+/**
+ * Finds the first of a set of rectangles a line runs into, looking only
+ * at the grid cells along the line.
+ *
+ * The grid is built lazily from the current rectangles, so whoever moves,
+ * adds or removes one of them has to call invalidate() before the next
+ * raycast.
+ */
+class RaycastGrid final
+{
+public:
+  /** Returns the current rectangle of the entry with the given index,
+      nullptr if lines pass through it. */
+  using GetRect = std::function<const Rectf* (size_t index)>;
+
+public:
+  RaycastGrid(float cell_size = 128.0f);
+
+  inline void invalidate() { m_dirty = true; }
+
+  /** Builds the grid from the entries 0 to 'count' - 1 if it was
+      invalidated. */
+  void update(size_t count, const GetRect& get_rect);
+
+  /** Returns the entry the line from 'line_start' to 'line_end' runs
+      into first, ties go to the lower index. 'get_rect' may leave out
+      more entries than the one given to update(), but not add any. */
+  std::optional<size_t> get_first_on_line(const Vector& line_start, const Vector& line_end,
+                                          const GetRect& get_rect);
+
+private:
+  CollisionGrid m_grid;
+  std::vector<size_t> m_candidates;
+  bool m_dirty;
+
+private:
+  RaycastGrid(const RaycastGrid&) = delete;
+  RaycastGrid& operator=(const RaycastGrid&) = delete;
+};
@@ -0,0 +1,117 @@
+//  SuperTux
+//  Copyright (C) 2026 SuperTux Development Team
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#include "math/grid_line_walker.hpp"
+
+#include <cmath>
+#include <limits>
+
+namespace {
+
+/** Cell coordinates beyond this would overflow int. */
+const float MAX_CELL_COORD = 1.0e8f;
+
+} // namespace
+
+GridLineWalker::GridLineWalker(const Vector& line_start, const Vector& line_end, float cell_size) :
+  m_x(0),
+  m_y(0),
+  m_end_x(0),
+  m_end_y(0),
+  m_step_x(0),
+  m_step_y(0),
+  m_t(0.0f),
+  m_t_max_x(std::numeric_limits<float>::infinity()),
+  m_t_max_y(std::numeric_limits<float>::infinity()),
+  m_t_delta_x(std::numeric_limits<float>::infinity()),
+  m_t_delta_y(std::numeric_limits<float>::infinity()),
+  m_started(false),
+  m_done(false)
+{
+  const Vector start = line_start / cell_size;
+  const Vector end = line_end / cell_size;
+
+  // Also catches NaN, since all comparisons with it are false.
+  if (!(std::fabs(start.x) < MAX_CELL_COORD && std::fabs(start.y) < MAX_CELL_COORD &&
+        std::fabs(end.x) < MAX_CELL_COORD && std::fabs(end.y) < MAX_CELL_COORD))
+  {
+    m_done = true;
+    return;
+  }
+
+  m_x = static_cast<int>(std::floor(start.x));
+  m_y = static_cast<int>(std::floor(start.y));
+  m_end_x = static_cast<int>(std::floor(end.x));
+  m_end_y = static_cast<int>(std::floor(end.y));
+
+  const Vector dir = end - start;
+
+  if (dir.x > 0.0f) {
+    m_step_x = 1;
+    m_t_delta_x = 1.0f / dir.x;
+    m_t_max_x = (static_cast<float>(m_x + 1) - start.x) / dir.x;
+  } else if (dir.x < 0.0f) {
+    m_step_x = -1;
+    m_t_delta_x = -1.0f / dir.x;
+    m_t_max_x = (static_cast<float>(m_x) - start.x) / dir.x;
+  }
+
+  if (dir.y > 0.0f) {
+    m_step_y = 1;
+    m_t_delta_y = 1.0f / dir.y;
+    m_t_max_y = (static_cast<float>(m_y + 1) - start.y) / dir.y;
+  } else if (dir.y < 0.0f) {
+    m_step_y = -1;
+    m_t_delta_y = -1.0f / dir.y;
+    m_t_max_y = (static_cast<float>(m_y) - start.y) / dir.y;
+  }
+}
+
+bool
+GridLineWalker::next()
+{
+  if (m_done)
+    return false;
+
+  if (!m_started) {
+    m_started = true;
+    return true;
+  }
+
+  if (m_x == m_end_x && m_y == m_end_y) {
+    m_done = true;
+    return false;
+  }
+
+  if (m_t_max_x < m_t_max_y) {
+    m_t = m_t_max_x;
+    m_x += m_step_x;
+    m_t_max_x += m_t_delta_x;
+  } else {
+    m_t = m_t_max_y;
+    m_y += m_step_y;
+    m_t_max_y += m_t_delta_y;
+  }
+
+  // Rounding errors may let the walk miss the end cell by a hair,
+  // never walk past the end of the line because of that.
+  if (m_t > 1.0f) {
+    m_done = true;
+    return false;
+  }
+
+  return true;
+}
@@ -0,0 +1,63 @@
+//  SuperTux
+//  Copyright (C) 2026 SuperTux Development Team
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#pragma once
+
+#include "math/vector.hpp"
+
+/**
+ * Visits the cells of a uniform grid that a line segment passes
+ * through, in order from start to end (Amanatides & Woo, "A Fast Voxel
+ * Traversal Algorithm for Ray Tracing").
+ *
+ * Coordinates are relative to the grid origin, i.e. cell (0, 0) covers
+ * [0, cell_size) on both axes. Usage:
+ *
+ *   GridLineWalker walker(start, end, 32.0f);
+ *   while (walker.next()) { ... walker.get_x(), walker.get_y() ... }
+ */
+class GridLineWalker final
+{
+public:
+  GridLineWalker(const Vector& line_start, const Vector& line_end, float cell_size);
+
+  /** Advances to the next cell, the first call yields the cell
+      containing 'line_start'. Returns false once the cell containing
+      'line_end' has been passed. */
+  bool next();
+
+  inline int get_x() const { return m_x; }
+  inline int get_y() const { return m_y; }
+
+  /** Position along the line (0 = start, 1 = end) where it enters the
+      current cell. */
+  inline float get_t() const { return m_t; }
+
+private:
+  int m_x;
+  int m_y;
+  int m_end_x;
+  int m_end_y;
+  int m_step_x;
+  int m_step_y;
+  float m_t;
+  float m_t_max_x;
+  float m_t_max_y;
+  float m_t_delta_x;
+  float m_t_delta_y;
+  bool m_started;
+  bool m_done;
+};
@@ -120,8 +120,8 @@ ConveyorBelt::update_hitbox()
 {
   MovingSprite::update_hitbox();
 
-  m_col.m_bbox.set_size(m_sprite->get_current_hitbox_width() * static_cast<float>(m_length),
-                        m_sprite->get_current_hitbox_height());
+  m_col.set_size(m_sprite->get_current_hitbox_width() * static_cast<float>(m_length),
+                 m_sprite->get_current_hitbox_height());
 }
 
 void
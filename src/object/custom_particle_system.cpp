@@ -16,8 +16,10 @@
 
 #include "object/custom_particle_system.hpp"
 
+#include <algorithm>
 #include <assert.h>
 #include <math.h>
+#include <unordered_map>
 
 #include "collision/collision.hpp"
 #include "editor/particle_editor.hpp"
@@ -47,7 +49,10 @@ CustomParticleSystem::CustomParticleSystem() :
   time_last_remaining(0.f),
   script_easings(),
   m_textures(),
-  custom_particles(),
+  m_particle_textures(),
+  m_texture_base(0),
+  m_textures_dirty(true),
+  m_particles(),
   m_particle_main_texture("/images/engine/editor/particle.png"),
   m_max_amount(25),
   m_delay(0.1f),
@@ -90,7 +95,10 @@ CustomParticleSystem::CustomParticleSystem(const ReaderMapping& reader) :
   time_last_remaining(0.f),
   script_easings(),
   m_textures(),
-  custom_particles(),
+  m_particle_textures(),
+  m_texture_base(0),
+  m_textures_dirty(true),
+  m_particles(),
   m_particle_main_texture("/images/engine/editor/particle.png"),
   m_max_amount(25),
   m_delay(0.1f),
@@ -391,6 +399,8 @@ CustomParticleSystem::reinit_textures()
   {
     texture_sum_odds += texture.likeliness;
   }
+
+  m_textures_dirty = true;
 }
 
 void
@@ -556,113 +566,104 @@ CustomParticleSystem::update(float dt_sec)
     }
   }
 
-  // Update existing particles.
-  for (auto& it : custom_particles) {
-    auto particle = dynamic_cast<CustomParticle*>(it.get());
-    assert(particle);
-
-    if (particle->birth_time > dt_sec) {
-      switch(particle->birth_mode) {
+  auto& p = m_particles;
+  const size_t count = p.size();
+
+  // Zones and the camera don't move while the particles are updated.
+  std::vector<ParticleZone::ZoneDetails> zones = get_zones();
+  zones.erase(std::remove_if(zones.begin(), zones.end(),
+                             [this](const ParticleZone::ZoneDetails& zone) {
+                               return zone.get_particle_name() != m_name;
+                             }),
+              zones.end());
+
+  const float abs_x = get_abs_x();
+  const float abs_y = get_abs_y();
+  const float screen_right = static_cast<float>(SCREEN_WIDTH) + abs_x;
+  const float screen_bottom = static_cast<float>(SCREEN_HEIGHT) + abs_y;
+
+  // Birth, death, zones and offscreen handling.
+  for (size_t i = 0; i < count; ++i) {
+    const ParticleModes& modes = p.modes[i];
+    uint8_t& flags = p.flags[i];
+
+    if (p.birth_time[i] > dt_sec) {
+      const float progress = 1.f - (p.birth_time[i] / p.total_birth[i]);
+      switch(modes.birth_mode) {
       case FadeMode::Shrink:
-        particle->scale = static_cast<float>(
-                          getEasingByName(particle->birth_easing)(
-                            static_cast<double>(
-                              1.f - (particle->birth_time / particle->total_birth)
-                            )
-                          ));
+        p.scale[i] = static_cast<float>(getEasingByName(modes.birth_easing)(static_cast<double>(progress)));
         break;
       case FadeMode::Fade:
-        particle->props = SpriteProperties(particle->original_props,
-                                           1.f - (particle->birth_time /
-                                                  particle->total_birth));
+        p.alpha[i] = progress;
         break;
       default:
         break;
       }
-      particle->birth_time -= dt_sec;
-    } else if (particle->birth_time > 0.f) {
-      particle->birth_time = 0.f;
-      switch(particle->birth_mode) {
+      p.birth_time[i] -= dt_sec;
+    } else if (p.birth_time[i] > 0.f) {
+      p.birth_time[i] = 0.f;
+      switch(modes.birth_mode) {
       case FadeMode::Shrink:
-        particle->scale = 1.f;
+        p.scale[i] = 1.f;
         break;
       case FadeMode::Fade:
-        particle->props = particle->original_props;
+        p.alpha[i] = 1.f;
         break;
       default:
         break;
       }
     }
 
-    particle->lifetime -= dt_sec;
-    if (particle->lifetime < 0.f) {
-      particle->lifetime = 0.f;
+    p.lifetime[i] -= dt_sec;
+    if (p.lifetime[i] < 0.f) {
+      p.lifetime[i] = 0.f;
     }
 
-    if (particle->birth_time <= 0.f && particle->lifetime <= 0.f) {
-      if (particle->death_time > dt_sec) {
-        switch(particle->death_mode) {
+    if (p.birth_time[i] <= 0.f && p.lifetime[i] <= 0.f) {
+      if (p.death_time[i] > dt_sec) {
+        const float remaining = p.death_time[i] / p.total_death[i];
+        switch(modes.death_mode) {
         case FadeMode::Shrink:
-          particle->scale = 1.f - static_cast<float>(
-                            getEasingByName(particle->death_easing)(
-                              static_cast<double>(
-                                1.f - (particle->death_time / particle->total_death)
-                              )
-                            ));
+          p.scale[i] = 1.f - static_cast<float>(getEasingByName(modes.death_easing)(static_cast<double>(1.f - remaining)));
           break;
         case FadeMode::Fade:
-          particle->props = SpriteProperties(particle->original_props,
-                                                   (particle->death_time /
-                                                    particle->total_death));
+          p.alpha[i] = remaining;
           break;
         default:
           break;
         }
-        particle->death_time -= dt_sec;
+        p.death_time[i] -= dt_sec;
       } else {
-        particle->death_time = 0.f;
-        switch(particle->death_mode) {
+        p.death_time[i] = 0.f;
+        switch(modes.death_mode) {
         case FadeMode::Shrink:
-          particle->scale = 0.f;
+          p.scale[i] = 0.f;
           break;
         case FadeMode::Fade:
-          particle->props = SpriteProperties(particle->original_props, 0.f);
+          p.alpha[i] = 0.f;
           break;
         default:
           break;
         }
-        particle->ready_for_deletion = true;
+        flags |= READY_FOR_DELETION;
       }
     }
 
-    float abs_x = get_abs_x();
-    float abs_y = get_abs_y();
-
-    if (!particle->has_been_on_screen) {
-      if (particle->pos.y <= static_cast<float>(SCREEN_HEIGHT) + abs_y
-          && particle->pos.y >= abs_y
-          && particle->pos.x <= static_cast<float>(SCREEN_WIDTH) + abs_x
-          && particle->pos.x >= abs_x) {
-        particle->has_been_on_screen = true;
-      }
+    const bool on_screen = p.y[i] <= screen_bottom && p.y[i] >= abs_y
+                        && p.x[i] <= screen_right && p.x[i] >= abs_x;
+    if (on_screen) {
+      flags |= HAS_BEEN_ON_SCREEN;
     }
 
-    switch(particle->offscreen_mode) {
+    switch(modes.offscreen_mode) {
     case OffscreenMode::Always:
-      if (particle->pos.y > static_cast<float>(SCREEN_HEIGHT) + abs_y
-          || particle->pos.y < abs_y
-          || particle->pos.x > static_cast<float>(SCREEN_WIDTH) + abs_x
-          || particle->pos.x < abs_x) {
-        particle->ready_for_deletion = true;
+      if (!on_screen) {
+        flags |= READY_FOR_DELETION;
       }
       break;
     case OffscreenMode::OnlyOnExit:
-      if ((particle->pos.y > static_cast<float>(SCREEN_HEIGHT) + abs_y
-          || particle->pos.y < abs_y
-          || particle->pos.x > static_cast<float>(SCREEN_WIDTH) + abs_x
-          || particle->pos.x < abs_x)
-          && particle->has_been_on_screen) {
-        particle->ready_for_deletion = true;
+      if (!on_screen && (flags & HAS_BEEN_ON_SCREEN)) {
+        flags |= READY_FOR_DELETION;
       }
       break;
     case OffscreenMode::Never:
@@ -670,27 +671,26 @@ CustomParticleSystem::update(float dt_sec)
     }
 
     bool is_in_life_zone = false;
-    for (auto& zone : get_zones()) {
-      if (zone.get_rect().contains(particle->pos) && zone.get_particle_name() == m_name) {
+    for (const auto& zone : zones) {
+      if (zone.get_rect().contains(Vector(p.x[i], p.y[i]))) {
         switch(zone.get_type()) {
         case ParticleZone::ParticleZoneType::Killer:
-          particle->lifetime = 0.f;
-          particle->birth_time = 0.f;
+          p.lifetime[i] = 0.f;
+          p.birth_time[i] = 0.f;
           break;
 
         case ParticleZone::ParticleZoneType::Destroyer:
-          particle->ready_for_deletion = true;
+          flags |= READY_FOR_DELETION;
           break;
 
         case ParticleZone::ParticleZoneType::LifeClear:
-          particle->last_life_zone_required_instakill = true;
-          particle->has_been_in_life_zone = true;
+          flags |= LAST_LIFE_ZONE_REQUIRED_INSTAKILL | HAS_BEEN_IN_LIFE_ZONE;
           is_in_life_zone = true;
           break;
 
         case ParticleZone::ParticleZoneType::Life:
-          particle->last_life_zone_required_instakill = false;
-          particle->has_been_in_life_zone = true;
+          flags &= static_cast<uint8_t>(~LAST_LIFE_ZONE_REQUIRED_INSTAKILL);
+          flags |= HAS_BEEN_IN_LIFE_ZONE;
           is_in_life_zone = true;
           break;
 
@@ -701,120 +701,166 @@ CustomParticleSystem::update(float dt_sec)
       }
     } // For each ParticleZone object.
 
-    if (!is_in_life_zone && particle->has_been_in_life_zone) {
-      if (particle->last_life_zone_required_instakill) {
-        particle->ready_for_deletion = true;
+    if (!is_in_life_zone && (flags & HAS_BEEN_IN_LIFE_ZONE)) {
+      if (flags & LAST_LIFE_ZONE_REQUIRED_INSTAKILL) {
+        flags |= READY_FOR_DELETION;
       } else {
-        particle->lifetime = 0.f;
-        particle->birth_time = 0.f;
+        p.lifetime[i] = 0.f;
+        p.birth_time[i] = 0.f;
       }
     }
+  } // For each particle.
 
-    if (!particle->stuck) {
-      particle->speedX += graphicsRandom.randf(-particle->feather_factor,
-                                      particle->feather_factor) * dt_sec * 1000.f;
-      particle->speedY += graphicsRandom.randf(-particle->feather_factor,
-                                      particle->feather_factor) * dt_sec * 1000.f;
-      particle->speedX += particle->accX * dt_sec;
-      particle->speedY += particle->accY * dt_sec;
-      particle->speedX *= 1.f - particle->frictionX * dt_sec;
-      particle->speedY *= 1.f - particle->frictionY * dt_sec;
-
-      if (Sector::current() && collision(particle,
-                    Vector(particle->speedX,particle->speedY) * dt_sec) > 0) {
-        switch(particle->collision_mode) {
-        case CollisionMode::Ignore:
-          particle->pos.x += particle->speedX * dt_sec;
-          particle->pos.y += particle->speedY * dt_sec;
-          break;
-        case CollisionMode::Stick:
-          // Just don't move
-          break;
-        case CollisionMode::StickForever:
-          particle->stuck = true;
-          break;
-        case CollisionMode::BounceHeavy:
-        case CollisionMode::BounceLight:
-          {
-            auto c = get_collision(particle, Vector(particle->speedX, particle->speedY) * dt_sec);
-
-            float speed_angle = atanf(-particle->speedY / particle->speedX);
-            if (c.slope_normal.x == 0.f && c.slope_normal.y == 0.f) {
-              auto cX = get_collision(particle, Vector(particle->speedX, 0) * dt_sec);
-              if (cX.left != cX.right)
-                particle->speedX *= -1;
-              auto cY = get_collision(particle, Vector(0, particle->speedY) * dt_sec);
-              if (cY.top != cY.bottom)
-                particle->speedY *= -1;
-            } else {
-              float face_angle = atanf(c.slope_normal.y / c.slope_normal.x);
-              float dest_angle = face_angle * 2.f - speed_angle; // Reflect the angle around face_angle.
-              float dX = cosf(dest_angle),
-                    dY = sinf(dest_angle);
-
-              float true_speed = static_cast<float>(sqrt(pow(particle->speedY, 2)
-                                                      + pow(particle->speedX, 2)));
-
-              particle->speedX = dX * true_speed;
-              particle->speedY = dY * true_speed;
-            }
-
-            switch(particle->collision_mode) {
-              case CollisionMode::BounceHeavy:
-                particle->speedX *= .2f;
-                particle->speedY *= .2f;
-                break;
-              case CollisionMode::BounceLight:
-                particle->speedX *= .7f;
-                particle->speedY *= .7f;
-                break;
-              default:
-                assert(false);
-            }
-
-            particle->pos.x += particle->speedX * dt_sec;
-            particle->pos.y += particle->speedY * dt_sec;
-          }
-          break;
-        case CollisionMode::Destroy:
-          particle->ready_for_deletion = true;
-          break;
-        case CollisionMode::FadeOut:
-          particle->lifetime = 0.f;
-          break;
-        }
-      } else {
-        particle->pos.x += particle->speedX * dt_sec;
-        particle->pos.y += particle->speedY * dt_sec;
+  // Random drift. Kept out of the integration below so that loop stays
+  // free of branches and calls.
+  for (size_t i = 0; i < count; ++i) {
+    const float feather = p.feather_factor[i];
+    if (feather != 0.f && p.moving[i] != 0.f) {
+      p.speed_x[i] += graphicsRandom.randf(-feather, feather) * dt_sec * 1000.f;
+      p.speed_y[i] += graphicsRandom.randf(-feather, feather) * dt_sec * 1000.f;
+    }
+  }
+
+  // Integrate the speeds. Plain loops over the arrays with selects
+  // instead of branches, so the compiler can vectorize them.
+  {
+    float* speed_x = p.speed_x.data();
+    float* speed_y = p.speed_y.data();
+    const float* acc_x = p.acc_x.data();
+    const float* acc_y = p.acc_y.data();
+    const float* friction_x = p.friction_x.data();
+    const float* friction_y = p.friction_y.data();
+    const float* moving = p.moving.data();
+    for (size_t i = 0; i < count; ++i) {
+      const float new_x = (speed_x[i] + acc_x[i] * dt_sec) * (1.f - friction_x[i] * dt_sec);
+      const float new_y = (speed_y[i] + acc_y[i] * dt_sec) * (1.f - friction_y[i] * dt_sec);
+      speed_x[i] = (moving[i] != 0.f) ? new_x : speed_x[i];
+      speed_y[i] = (moving[i] != 0.f) ? new_y : speed_y[i];
+    }
+  }
+
+  // Collisions decide which particles get to move by their speed.
+  std::copy(p.moving.begin(), p.moving.end(), p.step.begin());
+  if (Sector::current()) {
+    for (size_t i = 0; i < count; ++i) {
+      // Ignoring particles move the same whether they collide or not.
+      const CollisionMode collision_mode = p.modes[i].collision_mode;
+      if (p.step[i] == 0.f || collision_mode == CollisionMode::Ignore) {
+        continue;
       }
 
-      switch(particle->angle_mode) {
-      case RotationMode::Facing:
-        particle->angle = atanf(particle->speedY / particle->speedX) * 180.f / math::PI;
+      if (particle_collision(i, Vector(p.speed_x[i], p.speed_y[i]) * dt_sec) <= 0) {
+        continue;
+      }
+
+      switch(collision_mode) {
+      case CollisionMode::Ignore:
         break;
-      case RotationMode::Wiggling:
-        particle->angle += graphicsRandom.randf(-particle->angle_speed / 2.f,
-                                            particle->angle_speed / 2.f) * dt_sec;
+      case CollisionMode::Stick:
+        // Just don't move
+        p.step[i] = 0.f;
+        break;
+      case CollisionMode::StickForever:
+        p.step[i] = 0.f;
+        p.moving[i] = 0.f;
+        break;
+      case CollisionMode::BounceHeavy:
+      case CollisionMode::BounceLight:
+        {
+          float& speed_x = p.speed_x[i];
+          float& speed_y = p.speed_y[i];
+          auto c = get_particle_collision(i, Vector(speed_x, speed_y) * dt_sec);
+
+          float speed_angle = atanf(-speed_y / speed_x);
+          if (c.slope_normal.x == 0.f && c.slope_normal.y == 0.f) {
+            auto cX = get_particle_collision(i, Vector(speed_x, 0) * dt_sec);
+            if (cX.left != cX.right)
+              speed_x *= -1;
+            auto cY = get_particle_collision(i, Vector(0, speed_y) * dt_sec);
+            if (cY.top != cY.bottom)
+              speed_y *= -1;
+          } else {
+            float face_angle = atanf(c.slope_normal.y / c.slope_normal.x);
+            float dest_angle = face_angle * 2.f - speed_angle; // Reflect the angle around face_angle.
+            float dX = cosf(dest_angle),
+                  dY = sinf(dest_angle);
+
+            float true_speed = static_cast<float>(sqrt(pow(speed_y, 2) + pow(speed_x, 2)));
+
+            speed_x = dX * true_speed;
+            speed_y = dY * true_speed;
+          }
+
+          const float bounce = (collision_mode == CollisionMode::BounceHeavy) ? .2f : .7f;
+          speed_x *= bounce;
+          speed_y *= bounce;
+        }
+        break;
+      case CollisionMode::Destroy:
+        p.step[i] = 0.f;
+        p.flags[i] |= READY_FOR_DELETION;
+        break;
+      case CollisionMode::FadeOut:
+        p.step[i] = 0.f;
+        p.lifetime[i] = 0.f;
         break;
-      case RotationMode::Fixed:
-      default:
-        particle->angle_speed += particle->angle_acc * dt_sec;
-        particle->angle_speed *= 1.f - particle->angle_decc * dt_sec;
-        particle->angle += particle->angle_speed * dt_sec;
       }
     }
+  }
 
-  } // For each particle.
+  {
+    float* x = p.x.data();
+    float* y = p.y.data();
+    const float* speed_x = p.speed_x.data();
+    const float* speed_y = p.speed_y.data();
+    const float* step = p.step.data();
+    for (size_t i = 0; i < count; ++i) {
+      x[i] = (step[i] != 0.f) ? x[i] + speed_x[i] * dt_sec : x[i];
+      y[i] = (step[i] != 0.f) ? y[i] + speed_y[i] * dt_sec : y[i];
+    }
+  }
 
+  // Rotation. RotationMode::Fixed is integrated like the speeds, the
+  // other modes need a call per particle.
+  {
+    float* angle = p.angle.data();
+    float* angle_speed = p.angle_speed.data();
+    const float* angle_acc = p.angle_acc.data();
+    const float* angle_decc = p.angle_decc.data();
+    const float* moving = p.moving.data();
+    const float* spin = p.spin.data();
+    for (size_t i = 0; i < count; ++i) {
+      const bool turns = moving[i] != 0.f && spin[i] != 0.f;
+      const float new_speed = (angle_speed[i] + angle_acc[i] * dt_sec) * (1.f - angle_decc[i] * dt_sec);
+      angle_speed[i] = turns ? new_speed : angle_speed[i];
+      angle[i] = turns ? angle[i] + new_speed * dt_sec : angle[i];
+    }
+  }
 
-  // Clear dead particles
-  // We iterate through the vector backwards because removing an element affects
-  // the index of all elements after it, which can lead to buggy behavior.
-  for (int i = static_cast<int>(custom_particles.size()) - 1; i >= 0; --i) {
-    auto particle = dynamic_cast<CustomParticle*>(custom_particles.at(i).get());
+  for (size_t i = 0; i < count; ++i) {
+    if (p.spin[i] != 0.f || p.moving[i] == 0.f) {
+      continue;
+    }
 
-    if (particle->ready_for_deletion) {
-      custom_particles.erase(custom_particles.begin()+i);
+    switch(p.modes[i].angle_mode) {
+    case RotationMode::Facing:
+      p.angle[i] = atanf(p.speed_y[i] / p.speed_x[i]) * 180.f / math::PI;
+      break;
+    case RotationMode::Wiggling:
+      p.angle[i] += graphicsRandom.randf(-p.angle_speed[i] / 2.f,
+                                         p.angle_speed[i] / 2.f) * dt_sec;
+      break;
+    case RotationMode::Fixed:
+    default:
+      break;
+    }
+  }
+
+  // Clear dead particles. Going backwards, every particle swapped into
+  // a freed slot has already been checked.
+  for (size_t i = count; i-- > 0;) {
+    if (p.flags[i] & READY_FOR_DELETION) {
+      p.remove(i);
     }
   }
 
@@ -832,7 +878,7 @@ CustomParticleSystem::update(float dt_sec)
       }
       real_max *= i;
     }
-    while (remaining > m_delay && int(custom_particles.size()) < real_max)
+    while (remaining > m_delay && int(m_particles.size()) < real_max)
     {
       spawn_particles(remaining);
       remaining -= m_delay;
@@ -856,54 +902,33 @@ CustomParticleSystem::draw(DrawingContext& context)
 
   context.push_transform();
 
-  std::unordered_map<SpriteProperties*, SurfaceBatch> batches;
-  for (const auto& particle : custom_particles) {
-    auto it = batches.find(&(particle->props));
+  // Fading particles each have their own alpha, so batch by texture and
+  // by the alpha rounded to what the framebuffer can hold.
+  std::unordered_map<uint32_t, SurfaceBatch> batches;
+  const auto& p = m_particles;
+  for (size_t i = 0; i < p.size(); ++i) {
+    const SpriteProperties& props = m_particle_textures[p.texture[i]];
+    const uint32_t alpha = static_cast<uint32_t>(math::clamp(p.alpha[i], 0.f, 1.f) * 255.f + 0.5f);
+    const uint32_t key = (p.texture[i] << 8) | alpha;
+
+    auto it = batches.find(key);
     if (it == batches.end()) {
-      const auto& batch_it = batches.emplace(&(particle->props),
-        SurfaceBatch(particle->props.texture, particle->props.color));
-      batch_it.first->second.draw(Rectf(Vector(
-                                               particle->pos.x - particle->scale
-                                                 * static_cast<float>(
-                                                 particle->props.texture->get_width()
-                                               ) * particle->props.scale.x / 2,
-                                               particle->pos.y - particle->scale
-                                                 * static_cast<float>(
-                                                 particle->props.texture->get_height()
-                                               ) * particle->props.scale.y / 2
-                                        ),
-                                        Vector(
-                                               particle->pos.x + particle->scale
-                                                 * static_cast<float>(
-                                                 particle->props.texture->get_width()
-                                               ) * particle->props.scale.x / 2,
-                                               particle->pos.y + particle->scale
-                                                 * static_cast<float>(
-                                                 particle->props.texture->get_height()
-                                               ) * particle->props.scale.y / 2
-                                        )
-                                 ), particle->angle);
-    } else {
-      it->second.draw(Rectf(particle->pos,
-                                        Vector(
-                                               particle->pos.x + particle->scale
-                                                 * static_cast<float>(
-                                                 particle->texture->get_width()
-                                               ) * particle->props.scale.x,
-                                               particle->pos.y + particle->scale
-                                                 * static_cast<float>(
-                                                 particle->texture->get_height()
-                                               ) * particle->props.scale.y
-                                        )
-                                 ), particle->angle);
+      Color color = props.color;
+      color.alpha *= static_cast<float>(alpha) / 255.f;
+      it = batches.emplace(key, SurfaceBatch(props.texture, color)).first;
     }
+
+    const float half_width = p.scale[i] * static_cast<float>(props.texture->get_width()) * props.scale.x / 2;
+    const float half_height = p.scale[i] * static_cast<float>(props.texture->get_height()) * props.scale.y / 2;
+    it->second.draw(Rectf(p.x[i] - half_width, p.y[i] - half_height,
+                          p.x[i] + half_width, p.y[i] + half_height), p.angle[i]);
   }
 
-  for(auto& it : batches) {
-    auto& surface = it.first->texture;
+  for (auto& it : batches) {
+    auto& surface = m_particle_textures[it.first >> 8].texture;
     auto& batch = it.second;
     context.color().draw_surface_batch(surface, batch.move_srcrects(),
-      batch.move_dstrects(), batch.move_angles(), it.first->color, z_pos);
+      batch.move_dstrects(), batch.move_angles(), batch.get_color(), z_pos);
   }
 
   context.pop_transform();
@@ -912,29 +937,29 @@ CustomParticleSystem::draw(DrawingContext& context)
 // Duplicated from ParticleSystem_Interactive because I intend to bring edits
 // sometime in the future, for even more flexibility with particles. (Semphris).
 int
-CustomParticleSystem::collision(Particle* object, const Vector& movement)
+CustomParticleSystem::particle_collision(size_t index, const Vector& movement) const
 {
   using namespace collision;
 
-  CustomParticle* particle = dynamic_cast<CustomParticle*>(object);
-  assert(particle);
+  const SpriteProperties& props = m_particle_textures[m_particles.texture[index]];
+  const Vector pos(m_particles.x[index], m_particles.y[index]);
 
   // Calculate rectangle where the object will move.
   float x1, x2;
   float y1, y2;
 
-  x1 = object->pos.x - particle->props.hb_scale.x * static_cast<float>(particle->props.texture->get_width()) / 2
-          + particle->props.hb_offset.x * static_cast<float>(particle->props.texture->get_width());
-  x2 = x1 + particle->props.hb_scale.x * static_cast<float>(particle->props.texture->get_width()) + movement.x;
+  x1 = pos.x - props.hb_scale.x * static_cast<float>(props.texture->get_width()) / 2
+          + props.hb_offset.x * static_cast<float>(props.texture->get_width());
+  x2 = x1 + props.hb_scale.x * static_cast<float>(props.texture->get_width()) + movement.x;
   if (x2 < x1) {
     float temp_x = x1;
     x1 = x2;
     x2 = temp_x;
   }
 
-  y1 = object->pos.y - particle->props.hb_scale.y * static_cast<float>(particle->props.texture->get_height()) / 2
-          + particle->props.hb_offset.y * static_cast<float>(particle->props.texture->get_height());
-  y2 = y1 + particle->props.hb_scale.y * static_cast<float>(particle->props.texture->get_height()) + movement.y;
+  y1 = pos.y - props.hb_scale.y * static_cast<float>(props.texture->get_height()) / 2
+          + props.hb_offset.y * static_cast<float>(props.texture->get_height());
+  y2 = y1 + props.hb_scale.y * static_cast<float>(props.texture->get_height()) + movement.y;
   if (y2 < y1) {
     float temp_y = y1;
     y1 = y2;
@@ -1001,27 +1026,27 @@ CustomParticleSystem::collision(Particle* object, const Vector& movement)
 }
 
 CollisionHit
-CustomParticleSystem::get_collision(Particle* object, const Vector& movement)
+CustomParticleSystem::get_particle_collision(size_t index, const Vector& movement) const
 {
   using namespace collision;
 
-  CustomParticle* particle = dynamic_cast<CustomParticle*>(object);
-  assert(particle);
+  const SpriteProperties& props = m_particle_textures[m_particles.texture[index]];
+  const Vector pos(m_particles.x[index], m_particles.y[index]);
 
   // Calculate rectangle where the object will move.
   float x1, x2;
   float y1, y2;
 
-  x1 = object->pos.x - particle->props.scale.x * static_cast<float>(particle->props.texture->get_width()) / 2;
-  x2 = x1 + particle->props.scale.x * static_cast<float>(particle->props.texture->get_width()) + movement.x;
+  x1 = pos.x - props.scale.x * static_cast<float>(props.texture->get_width()) / 2;
+  x2 = x1 + props.scale.x * static_cast<float>(props.texture->get_width()) + movement.x;
   if (x2 < x1) {
     float temp_x = x1;
     x1 = x2;
     x2 = temp_x;
   }
 
-  y1 = object->pos.y - particle->props.scale.y * static_cast<float>(particle->props.texture->get_height()) / 2;
-  y2 = y1 + particle->props.scale.y * static_cast<float>(particle->props.texture->get_height()) + movement.y;
+  y1 = pos.y - props.scale.y * static_cast<float>(props.texture->get_height()) / 2;
+  y2 = y1 + props.scale.y * static_cast<float>(props.texture->get_height()) + movement.y;
   if (y2 < y1) {
     float temp_y = y1;
     y1 = y2;
@@ -1069,19 +1094,41 @@ CustomParticleSystem::get_collision(Particle* object, const Vector& movement)
 // =============================================================================
 // LOCAL
 
-CustomParticleSystem::SpriteProperties
+size_t
 CustomParticleSystem::get_random_texture() const
 {
   float val = graphicsRandom.randf(texture_sum_odds);
-  for (const auto& texture : m_textures)
+  for (size_t i = 0; i < m_textures.size(); ++i)
   {
-    val -= texture.likeliness;
+    val -= m_textures[i].likeliness;
     if (val <= 0)
     {
-      return texture;
+      return i;
+    }
+  }
+  assert(!m_textures.empty());
+  return 0;
+}
+
+void
+CustomParticleSystem::sync_particle_textures()
+{
+  std::vector<SpriteProperties> textures;
+  std::vector<uint32_t> remap(m_particle_textures.size(), UINT32_MAX);
+  for (auto& index : m_particles.texture)
+  {
+    if (remap[index] == UINT32_MAX)
+    {
+      remap[index] = static_cast<uint32_t>(textures.size());
+      textures.push_back(m_particle_textures[index]);
     }
+    index = remap[index];
   }
-  return m_textures.at(0);
+
+  m_texture_base = textures.size();
+  textures.insert(textures.end(), m_textures.begin(), m_textures.end());
+  m_particle_textures = std::move(textures);
+  m_textures_dirty = false;
 }
 
 std::vector<ParticleZone::ZoneDetails>
@@ -1132,73 +1179,77 @@ CustomParticleSystem::get_abs_y() const
 void
 CustomParticleSystem::add_particle(float lifetime, float x, float y)
 {
-  auto particle = std::make_unique<CustomParticle>();
-  particle->original_props = get_random_texture();
-  particle->props = particle->original_props;
+  if (m_textures_dirty)
+    sync_particle_textures();
+
+  auto& p = m_particles;
+  const size_t i = p.add();
+  p.texture[i] = static_cast<uint32_t>(m_texture_base + get_random_texture());
 
-  particle->pos.x = x;
-  particle->pos.y = y;
+  p.x[i] = x;
+  p.y[i] = y;
 
   float life_elapsed = lifetime;
   float birth_delta = m_particle_birth_time_variation / 2;
-  particle->total_birth = m_particle_birth_time + graphicsRandom.randf(-birth_delta, birth_delta);
-  particle->birth_time = particle->total_birth - life_elapsed;
-  if (particle->birth_time < 0.f) {
-    life_elapsed = -particle->birth_time;
-    particle->birth_time = 0.f;
+  p.total_birth[i] = m_particle_birth_time + graphicsRandom.randf(-birth_delta, birth_delta);
+  p.birth_time[i] = p.total_birth[i] - life_elapsed;
+  if (p.birth_time[i] < 0.f) {
+    life_elapsed = -p.birth_time[i];
+    p.birth_time[i] = 0.f;
   } else {
     life_elapsed = 0.f;
   }
   float life_delta = m_particle_lifetime_variation / 2;
-  particle->lifetime = m_particle_lifetime - life_elapsed + graphicsRandom.randf(-life_delta, life_delta);
-  if (particle->lifetime < 0.f) {
-    life_elapsed = -particle->lifetime;
-    particle->lifetime = 0.f;
+  p.lifetime[i] = m_particle_lifetime - life_elapsed + graphicsRandom.randf(-life_delta, life_delta);
+  if (p.lifetime[i] < 0.f) {
+    life_elapsed = -p.lifetime[i];
+    p.lifetime[i] = 0.f;
   } else {
     life_elapsed = 0.f;
   }
   float death_delta = m_particle_death_time_variation / 2;
-  particle->total_death = m_particle_death_time + graphicsRandom.randf(-death_delta, death_delta);
-  particle->death_time = particle->total_death - life_elapsed;
+  p.total_death[i] = m_particle_death_time + graphicsRandom.randf(-death_delta, death_delta);
+  p.death_time[i] = p.total_death[i] - life_elapsed;
 
-  particle->birth_mode = m_particle_birth_mode;
-  particle->death_mode = m_particle_death_mode;
+  ParticleModes& modes = p.modes[i];
+  modes.birth_mode = m_particle_birth_mode;
+  modes.death_mode = m_particle_death_mode;
 
-  particle->birth_easing = m_particle_birth_easing;
-  particle->death_easing = m_particle_death_easing;
+  modes.birth_easing = m_particle_birth_easing;
+  modes.death_easing = m_particle_death_easing;
 
-  switch(particle->birth_mode) {
+  switch(modes.birth_mode) {
   case FadeMode::Shrink:
-    particle->scale = 0.f;
+    p.scale[i] = 0.f;
     break;
   default:
     break;
   }
 
   float speedx_delta = m_particle_speed_variation_x / 2;
-  particle->speedX = m_particle_speed_x + graphicsRandom.randf(-speedx_delta, speedx_delta);
+  p.speed_x[i] = m_particle_speed_x + graphicsRandom.randf(-speedx_delta, speedx_delta);
   float speedy_delta = m_particle_speed_variation_y / 2;
-  particle->speedY = m_particle_speed_y + graphicsRandom.randf(-speedy_delta, speedy_delta);
-  particle->accX = m_particle_acceleration_x;
-  particle->accY = m_particle_acceleration_y;
-  particle->frictionX = m_particle_friction_x;
-  particle->frictionY = m_particle_friction_y;
+  p.speed_y[i] = m_particle_speed_y + graphicsRandom.randf(-speedy_delta, speedy_delta);
+  p.acc_x[i] = m_particle_acceleration_x;
+  p.acc_y[i] = m_particle_acceleration_y;
+  p.friction_x[i] = m_particle_friction_x;
+  p.friction_y[i] = m_particle_friction_y;
 
-  particle->feather_factor = m_particle_feather_factor;
+  p.feather_factor[i] = m_particle_feather_factor;
 
   float angle_delta = m_particle_rotation_variation / 2;
-  particle->angle = m_particle_rotation + graphicsRandom.randf(-angle_delta, angle_delta);
+  p.angle[i] = m_particle_rotation + graphicsRandom.randf(-angle_delta, angle_delta);
   float angle_speed_delta = m_particle_rotation_speed_variation / 2;
-  particle->angle_speed = m_particle_rotation_speed + graphicsRandom.randf(-angle_speed_delta, angle_speed_delta);
-  particle->angle_acc = m_particle_rotation_acceleration;
-  particle->angle_decc = m_particle_rotation_decceleration;
-  particle->angle_mode = m_particle_rotation_mode;
-
-  particle->collision_mode = m_particle_collision_mode;
+  p.angle_speed[i] = m_particle_rotation_speed + graphicsRandom.randf(-angle_speed_delta, angle_speed_delta);
+  p.angle_acc[i] = m_particle_rotation_acceleration;
+  p.angle_decc[i] = m_particle_rotation_decceleration;
+  modes.angle_mode = m_particle_rotation_mode;
+  p.spin[i] = (modes.angle_mode == RotationMode::Facing
+               || modes.angle_mode == RotationMode::Wiggling) ? 0.f : 1.f;
 
-  particle->offscreen_mode = m_particle_offscreen_mode;
+  modes.collision_mode = m_particle_collision_mode;
 
-  custom_particles.push_back(std::move(particle));
+  modes.offscreen_mode = m_particle_offscreen_mode;
 }
 
 void
@@ -1222,6 +1273,102 @@ CustomParticleSystem::spawn_particles(float lifetime)
   }
 }
 
+// =============================================================================
+// PARTICLE DATA
+
+CustomParticleSystem::ParticleData::ParticleData() :
+  x(), y(),
+  speed_x(), speed_y(),
+  acc_x(), acc_y(),
+  friction_x(), friction_y(),
+  feather_factor(),
+  angle(), angle_speed(), angle_acc(), angle_decc(),
+  lifetime(), birth_time(), death_time(),
+  total_birth(), total_death(),
+  scale(), alpha(),
+  moving(),
+  step(),
+  spin(),
+  texture(),
+  modes(),
+  flags()
+{
+}
+
+template<typename F>
+void
+CustomParticleSystem::ParticleData::for_each_array(F func)
+{
+  func(x); func(y);
+  func(speed_x); func(speed_y);
+  func(acc_x); func(acc_y);
+  func(friction_x); func(friction_y);
+  func(feather_factor);
+  func(angle); func(angle_speed); func(angle_acc); func(angle_decc);
+  func(lifetime); func(birth_time); func(death_time);
+  func(total_birth); func(total_death);
+  func(scale); func(alpha);
+  func(moving);
+  func(step);
+  func(spin);
+  func(texture);
+  func(modes);
+  func(flags);
+}
+
+namespace {
+
+struct AppendElement
+{
+  template<typename T>
+  void operator()(std::vector<T>& array) const { array.emplace_back(); }
+};
+
+/** Moves the last element into 'index' and drops the last one. */
+struct RemoveElement
+{
+  size_t index;
+
+  template<typename T>
+  void operator()(std::vector<T>& array) const
+  {
+    array[index] = std::move(array.back());
+    array.pop_back();
+  }
+};
+
+struct ClearArray
+{
+  template<typename T>
+  void operator()(std::vector<T>& array) const { array.clear(); }
+};
+
+} // namespace
+
+size_t
+CustomParticleSystem::ParticleData::add()
+{
+  const size_t index = size();
+  for_each_array(AppendElement());
+  scale[index] = 1.f;
+  alpha[index] = 1.f;
+  moving[index] = 1.f;
+  step[index] = 1.f;
+  return index;
+}
+
+void
+CustomParticleSystem::ParticleData::remove(size_t index)
+{
+  for_each_array(RemoveElement{ index });
+}
+
+void
+CustomParticleSystem::ParticleData::clear()
+{
+  for_each_array(ClearArray());
+}
+
 // SCRIPTING
 
 void
@@ -18,6 +18,9 @@
 
 #include "object/particlesystem_interactive.hpp"
 
+#include <stdint.h>
+#include <vector>
+
 #include "math/easing.hpp"
 #include "math/vector.hpp"
 #include "object/particle_zone.hpp"
@@ -62,10 +65,6 @@ public:
 
   //void fade_amount(int new_amount, float fade_time);
 
-protected:
-  virtual int collision(Particle* particle, const Vector& movement) override;
-  CollisionHit get_collision(Particle* particle, const Vector& movement);
-
 private:
   struct ease_request
   {
@@ -97,7 +96,7 @@ public:
    * @scripting
    * @description Instantly removes all particles of that type on the screen.
    */
-  inline void clear() { custom_particles.clear(); }
+  inline void clear() { m_particles.clear(); }
 
   /**
    * @scripting
@@ -774,66 +773,100 @@ private:
     }
   };
 
-  SpriteProperties get_random_texture() const;
+  /** Returns an index into m_textures, picked by likeliness. */
+  size_t get_random_texture() const;
 
-  class CustomParticle : public Particle
+  /** Per-particle copy of the system settings at the time the
+      particle was spawned. Only read by the non-integration passes. */
+  struct ParticleModes
   {
-  public:
-    SpriteProperties original_props, props;
-    float lifetime, birth_time, death_time,
-          total_birth, total_death;
     FadeMode birth_mode, death_mode;
     EasingMode birth_easing, death_easing;
-    bool ready_for_deletion;
-    float speedX, speedY,
-          accX, accY,
-          frictionX, frictionY;
-    float feather_factor;
-    float angle_speed, angle_acc,
-          angle_decc;
     RotationMode angle_mode;
     CollisionMode collision_mode;
     OffscreenMode offscreen_mode;
-    bool has_been_on_screen;
-    bool has_been_in_life_zone;
-    bool last_life_zone_required_instakill;
-    bool stuck;
-
-    CustomParticle() :
-      original_props(),
-      props(),
-      lifetime(),
-      birth_time(),
-      death_time(),
-      total_birth(),
-      total_death(),
-      birth_mode(),
-      death_mode(),
-      birth_easing(),
-      death_easing(),
-      ready_for_deletion(false),
-      speedX(),
-      speedY(),
-      accX(),
-      accY(),
-      frictionX(),
-      frictionY(),
-      feather_factor(),
-      angle_speed(),
-      angle_acc(),
-      angle_decc(),
-      angle_mode(),
-      collision_mode(),
-      offscreen_mode(),
-      has_been_on_screen(),
-      has_been_in_life_zone(false),
-      last_life_zone_required_instakill(false),
-      stuck(false)
-    {}
   };
 
+  enum ParticleFlags : uint8_t
+  {
+    READY_FOR_DELETION = 1 << 0,
+    HAS_BEEN_ON_SCREEN = 1 << 1,
+    HAS_BEEN_IN_LIFE_ZONE = 1 << 2,
+    LAST_LIFE_ZONE_REQUIRED_INSTAKILL = 1 << 3
+  };
+
+  /** Particle state, one array per field, so that the integration
+      pass runs over contiguous floats and can be vectorized by the
+      compiler. Dead particles are removed by swapping in the last one. */
+  class ParticleData final
+  {
+  public:
+    std::vector<float> x, y;
+    std::vector<float> speed_x, speed_y;
+    std::vector<float> acc_x, acc_y;
+    std::vector<float> friction_x, friction_y;
+    std::vector<float> feather_factor;
+    std::vector<float> angle, angle_speed, angle_acc, angle_decc;
+    std::vector<float> lifetime, birth_time, death_time;
+    std::vector<float> total_birth, total_death;
+    std::vector<float> scale, alpha;
+
+    /** 1 while the particle can move, 0 once it got stuck. */
+    std::vector<float> moving;
+
+    /** 1 if the particle moves by its speed this frame, 0 if a
+        collision holds it in place. */
+    std::vector<float> step;
+
+    /** 1 if the particle turns by its angular speed, which is the case
+        for RotationMode::Fixed, 0 otherwise. */
+    std::vector<float> spin;
+
+    /** Index into m_particle_textures. */
+    std::vector<uint32_t> texture;
+
+    std::vector<ParticleModes> modes;
+    std::vector<uint8_t> flags;
+
+  public:
+    ParticleData();
+
+    inline size_t size() const { return x.size(); }
+
+    /** Appends a particle with every field zeroed, except for
+        scale, alpha, moving and step which start at 1. Returns its
+        index. */
+    size_t add();
+    void remove(size_t index);
+    void clear();
+
+  private:
+    template<typename F>
+    void for_each_array(F func);
+
+  private:
+    ParticleData(const ParticleData&) = delete;
+    ParticleData& operator=(const ParticleData&) = delete;
+  };
+
+  /** Copies the textures that new particles should use into
+      m_particle_textures, keeping those still in use by live particles
+      and renumbering them. */
+  void sync_particle_textures();
+
+  int particle_collision(size_t index, const Vector& movement) const;
+  CollisionHit get_particle_collision(size_t index, const Vector& movement) const;
+
   std::vector<SpriteProperties> m_textures;
-  std::vector<std::unique_ptr<CustomParticle> > custom_particles;
+
+  /** Texture properties referenced by live particles, so that editing
+      m_textures doesn't change the particles already spawned. The
+      entries starting at m_texture_base mirror m_textures. */
+  std::vector<SpriteProperties> m_particle_textures;
+  size_t m_texture_base;
+  bool m_textures_dirty;
+
+  ParticleData m_particles;
 
   std::string m_particle_main_texture;
 
@@ -1073,6 +1106,7 @@ public:
     m_textures.clear();
     for (auto& texture : props->m_textures)
       m_textures.push_back(texture);
+    m_textures_dirty = true;
     m_particle_main_texture = props->m_particle_main_texture;
     m_max_amount = props->m_max_amount;
     m_delay = props->m_delay;
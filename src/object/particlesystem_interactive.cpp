@@ -22,6 +22,7 @@
 #include "supertux/globals.hpp"
 #include "supertux/sector.hpp"
 #include "supertux/tile.hpp"
+#include "supertux/tile_attribute_grid.hpp"
 #include "video/drawing_context.hpp"
 #include "video/surface_batch.hpp"
 #include "video/video_system.hpp"
@@ -116,10 +117,20 @@ ParticleSystem_Interactive::collision(Particle* object, const Vector& movement)
   dest.move(movement);
   Constraints constraints;
 
+  const TileAttributeGrid& attributes = Sector::get().get_solid_tile_attributes();
+
   for (const auto& solids : Sector::get().get_solid_tilemaps()) {
+    int ax, ay;
+    const bool merged = attributes.get_tilemap_position(*solids, ax, ay);
+
     // FIXME Handle a nonzero tilemap offset
     for (int x = starttilex; x*32 < max_x; ++x) {
       for (int y = starttiley; y*32 < max_y; ++y) {
+        // get_tile() clamps, so only cells inside the tilemap can be skipped.
+        if (merged && x >= 0 && y >= 0 && x < solids->get_width() && y < solids->get_height() &&
+            !(attributes.get(ax + x, ay + y) & (Tile::WATER | Tile::SOLID)))
+          continue;
+
         const Tile& tile = solids->get_tile(x, y);
 
         // skip non-solid tiles, except water
@@ -16,8 +16,6 @@
 
 #include "object/tilemap.hpp"
 
-#include <tuple>
-
 #include <simplesquirrel/class.hpp>
 #include <simplesquirrel/vm.hpp>
 
@@ -46,6 +44,10 @@ TileMap::TileMap(const TileSet *new_tileset) :
   m_editor_active(true),
   m_tileset(new_tileset),
   m_tiles(),
+  m_revision(0),
+  m_chunks(),
+  m_chunks_revision(0),
+  m_chunks_editor(false),
   m_real_solid(false),
   m_effective_solid(false),
   m_speed_x(1),
@@ -80,6 +82,10 @@ TileMap::TileMap(const TileSet *tileset_, const ReaderMapping& reader) :
   m_editor_active(true),
   m_tileset(tileset_),
   m_tiles(),
+  m_revision(0),
+  m_chunks(),
+  m_chunks_revision(0),
+  m_chunks_editor(false),
   m_real_solid(false),
   m_effective_solid(false),
   m_speed_x(1),
@@ -186,6 +192,7 @@ TileMap::parse_tiles(const ReaderMapping& reader)
     if (static_cast<int>(m_tiles.size()) != m_width * m_height)
       throw std::runtime_error("wrong number of tiles in tilemap.");
   }
+  ++m_revision;
 
   bool empty = true;
 
@@ -546,27 +553,66 @@ TileMap::draw(DrawingContext& context)
   const float trans_y = context.get_translation().y;
   context.set_translation(Vector(trans_x * speed_x, trans_y * speed_y));
 
-  Rectf draw_rect = context.get_cliprect();
-  Rect t_draw_rect = get_tiles_overlapping(draw_rect);
-  Vector start = get_tile_position(t_draw_rect.left, t_draw_rect.top);
+  const bool editor = Editor::is_active();
+  update_chunks(editor);
 
-  Vector pos(0.0f, 0.0f);
-  int tx, ty;
+  const Rect t_draw_rect = get_tiles_overlapping(context.get_cliprect());
+  const int chunks_x = (m_width + CHUNK_SIZE - 1) / CHUNK_SIZE;
+
+  if ((g_debug.show_collision_rects && m_real_solid) ||
+      (editor && m_editor_active && g_config->editor_show_deprecated_tiles))
+    draw_tile_overlays(context, t_draw_rect);
 
-  std::unordered_map<SurfacePtr,
-                     std::tuple<std::vector<Rectf>,
-                                std::vector<Rectf>>> batches;
+  // The cached rects are relative to tile (0, 0), so move the
+  // translation instead of each rect.
+  context.set_translation(context.get_translation() - get_tile_position(0, 0));
 
-  for (pos.x = start.x, tx = t_draw_rect.left; tx < t_draw_rect.right; pos.x += 32, ++tx) {
-    for (pos.y = start.y, ty = t_draw_rect.top; ty < t_draw_rect.bottom; pos.y += 32, ++ty) {
-      int index = ty*m_width + tx;
-      assert (index >= 0);
-      assert (index < (m_width * m_height));
+  Canvas& canvas = context.get_canvas(m_draw_target);
 
-      if (m_tiles[index] == 0) continue;
-      const Tile& tile = m_tileset->get(m_tiles[index]);
+  const int chunk_right = t_draw_rect.left < t_draw_rect.right ? (t_draw_rect.right - 1) / CHUNK_SIZE : -1;
+  const int chunk_bottom = t_draw_rect.top < t_draw_rect.bottom ? (t_draw_rect.bottom - 1) / CHUNK_SIZE : -1;
+
+  for (int cy = t_draw_rect.top / CHUNK_SIZE; cy <= chunk_bottom; ++cy) {
+    for (int cx = t_draw_rect.left / CHUNK_SIZE; cx <= chunk_right; ++cx) {
+      Chunk& chunk = m_chunks[cy * chunks_x + cx];
+
+      if (!chunk.dirty) {
+        for (const auto& animated : chunk.animated) {
+          const SurfacePtr surface = editor ? animated.first->get_current_editor_surface()
+                                            : animated.first->get_current_surface();
+          if (surface.get() != animated.second) {
+            chunk.dirty = true;
+            break;
+          }
+        }
+      }
+
+      if (chunk.dirty)
+        build_chunk(cx, cy, editor);
+
+      for (const auto& batch : chunk.batches) {
+        canvas.draw_surface_batch(batch.surface, batch.srcrects, batch.dstrects,
+                                  m_current_tint, m_z_pos);
+      }
+    }
+  }
 
-	  if (g_debug.show_collision_rects && m_real_solid) {
+  context.pop_transform();
+}
+
+void
+TileMap::draw_tile_overlays(DrawingContext& context, const Rect& tiles) const
+{
+  Vector pos;
+  int tx, ty;
+  const Vector start = get_tile_position(tiles.left, tiles.top);
+  for (pos.x = start.x, tx = tiles.left; tx < tiles.right; pos.x += 32, ++tx) {
+    for (pos.y = start.y, ty = tiles.top; ty < tiles.bottom; pos.y += 32, ++ty) {
+      const uint32_t id = m_tiles[ty * m_width + tx];
+      if (id == 0) continue;
+      const Tile& tile = m_tileset->get(id);
+
+      if (g_debug.show_collision_rects && m_real_solid) {
         tile.draw_debug(context.color(), pos, LAYER_FOREGROUND1);
       }
 
@@ -577,31 +623,80 @@ TileMap::draw(DrawingContext& context)
         context.color().draw_text(Resources::normal_font, "!", pos + Vector(16, 8),
                                   ALIGN_CENTER, LAYER_GUI - 10, Color::RED);
       }
-
-      const SurfacePtr& surface = Editor::is_active() ? tile.get_current_editor_surface() : tile.get_current_surface();
-      if (surface) {
-        std::get<0>(batches[surface]).emplace_back(surface->get_region());
-        std::get<1>(batches[surface]).emplace_back(pos,
-                                                   Sizef(static_cast<float>(surface->get_width()),
-                                                         static_cast<float>(surface->get_height())));
-      }
     }
   }
+}
 
-  Canvas& canvas = context.get_canvas(m_draw_target);
+void
+TileMap::invalidate_chunk(int x, int y)
+{
+  // A single changed tile only costs its own chunk, as long as the
+  // chunks were up to date before.
+  const bool chunks_valid = (m_chunks_revision == m_revision);
+  ++m_revision;
+  if (!chunks_valid || m_chunks.empty())
+    return;
 
-  for (auto& it : batches)
-  {
-    const SurfacePtr& surface = it.first;
-    if (surface) {
-      canvas.draw_surface_batch(surface,
-                                std::move(std::get<0>(it.second)),
-                                std::move(std::get<1>(it.second)),
-                                m_current_tint, m_z_pos);
+  m_chunks_revision = m_revision;
+  m_chunks[(y / CHUNK_SIZE) * ((m_width + CHUNK_SIZE - 1) / CHUNK_SIZE) + x / CHUNK_SIZE].dirty = true;
+}
+
+void
+TileMap::update_chunks(bool editor)
+{
+  const size_t count = static_cast<size_t>((m_width + CHUNK_SIZE - 1) / CHUNK_SIZE) *
+                       static_cast<size_t>((m_height + CHUNK_SIZE - 1) / CHUNK_SIZE);
+
+  if (m_chunks_revision == m_revision && m_chunks_editor == editor && m_chunks.size() == count)
+    return;
+
+  m_chunks.clear();
+  m_chunks.resize(count);
+  m_chunks_revision = m_revision;
+  m_chunks_editor = editor;
+}
+
+void
+TileMap::build_chunk(int chunk_x, int chunk_y, bool editor)
+{
+  Chunk& chunk = m_chunks[chunk_y * ((m_width + CHUNK_SIZE - 1) / CHUNK_SIZE) + chunk_x];
+  chunk.batches.clear();
+  chunk.animated.clear();
+
+  const int right = std::min(m_width, (chunk_x + 1) * CHUNK_SIZE);
+  const int bottom = std::min(m_height, (chunk_y + 1) * CHUNK_SIZE);
+
+  // Keep the column major order the tiles were always drawn in.
+  for (int tx = chunk_x * CHUNK_SIZE; tx < right; ++tx) {
+    for (int ty = chunk_y * CHUNK_SIZE; ty < bottom; ++ty) {
+      const uint32_t id = m_tiles[ty * m_width + tx];
+      if (id == 0) continue;
+      const Tile& tile = m_tileset->get(id);
+
+      const SurfacePtr surface = editor ? tile.get_current_editor_surface() : tile.get_current_surface();
+      if (tile.is_animated())
+        chunk.animated.emplace_back(&tile, surface.get());
+      if (!surface) continue;
+
+      // Surfaces in the texture atlas share their texture, those can all
+      // go into the same batch.
+      auto batch = std::find_if(chunk.batches.begin(), chunk.batches.end(),
+                                [&surface](const Chunk::Batch& b) {
+                                  return b.surface->get_texture() == surface->get_texture() &&
+                                         b.surface->get_displacement_texture() == surface->get_displacement_texture() &&
+                                         b.surface->get_flip() == surface->get_flip();
+                                });
+      if (batch == chunk.batches.end())
+        batch = chunk.batches.insert(chunk.batches.end(), Chunk::Batch{ surface, {}, {} });
+
+      batch->srcrects.emplace_back(surface->get_region());
+      batch->dstrects.emplace_back(Vector(static_cast<float>(tx), static_cast<float>(ty)) * 32.0f,
+                                   Sizef(static_cast<float>(surface->get_width()),
+                                         static_cast<float>(surface->get_height())));
     }
   }
 
-  context.pop_transform();
+  chunk.dirty = false;
 }
 
 void
@@ -616,6 +711,7 @@ TileMap::set(int newwidth, int newheight, const std::vector<unsigned int>&newt,
 
   m_tiles.resize(newt.size());
   m_tiles = newt;
+  ++m_revision;
 
   if (new_z_pos > (LAYER_GUI - 100))
     m_z_pos = LAYER_GUI - 100;
@@ -675,6 +771,7 @@ TileMap::resize(int new_width, int new_height, int fill_id,
     apply_offset_x(fill_id, xoffset);
   if (!offset_finished_y)
     apply_offset_y(fill_id, yoffset);
+  ++m_revision;
 }
 
 void TileMap::resize(const Size& newsize, const Size& resize_offset) {
@@ -778,12 +875,20 @@ TileMap::change(int x, int y, uint32_t newtile)
     return;
 
   m_tiles[y*m_width + x] = newtile;
+  invalidate_chunk(x, y);
+
+  if (GameObjectManager* parent = get_parent())
+    parent->update_solid_tile(*this, x, y);
 }
 
 void
 TileMap::change(int idx, uint32_t newtile)
 {
   m_tiles[idx] = newtile;
+  invalidate_chunk(idx % m_width, idx / m_width);
+
+  if (GameObjectManager* parent = get_parent())
+    parent->update_solid_tile(*this, idx % m_width, idx / m_width);
 }
 
 void
@@ -818,6 +923,8 @@ TileMap::autotile(const Vector& pos, uint32_t tile, AutotileSet* autotileset)
   if (!autotileset || !autotileset->is_member(tile))
     return;
 
+  ++m_revision;
+
   if (pos.x < 0.f || pos.x >= static_cast<float>(m_width) ||
       pos.y < 0.f || pos.y >= static_cast<float>(m_height))
     return;
@@ -923,6 +1030,8 @@ TileMap::autotile_erase(const Vector& pos, AutotileSet* autotileset)
   if (!autotileset)
     return;
 
+  ++m_revision;
+
   if (pos.x < 0.f || pos.x >= static_cast<float>(m_width) ||
       pos.y < 0.f || pos.y >= static_cast<float>(m_height))
     return;
@@ -30,11 +30,13 @@
 #include "video/color.hpp"
 #include "video/flip.hpp"
 #include "video/drawing_target.hpp"
+#include "video/surface_ptr.hpp"
 
 class AutotileSet;
 class CollisionObject;
 class CollisionGroundMovementManager;
 class DrawingContext;
+class Surface;
 class Tile;
 class TileSet;
 
@@ -265,10 +267,15 @@ public:
 
   inline float get_target_alpha() const { return m_alpha; }
 
-  inline void set_tileset(const TileSet* tileset) { m_tileset = tileset; }
+  inline void set_tileset(const TileSet* tileset) { m_tileset = tileset; ++m_revision; }
+  inline const TileSet* get_tileset() const { return m_tileset; }
 
   inline const std::vector<uint32_t>& get_tiles() const { return m_tiles; }
 
+  /** Incremented on every modification of the tiles, used to detect
+      stale caches of the tile data. */
+  inline uint32_t get_revision() const { return m_revision; }
+
 private:
   void update_effective_solid(bool update_manager = true);
   void float_channel(float target, float &current, float remaining_time, float dt_sec);
@@ -293,6 +300,39 @@ private:
   void apply_offset_x(int fill_id, int xoffset);
   void apply_offset_y(int fill_id, int yoffset);
 
+  /** Drops the cached draw geometry of all chunks that is out of date
+      with the tiles, tileset or editor mode. */
+  void update_chunks(bool editor);
+  /** Bumps the revision for a change of tile (x, y), which only has to
+      rebuild the chunk containing it. */
+  void invalidate_chunk(int x, int y);
+  void build_chunk(int chunk_x, int chunk_y, bool editor);
+  void draw_tile_overlays(DrawingContext& context, const Rect& tiles) const;
+
+private:
+  /** Tiles are drawn in square chunks of this many tiles per side. */
+  static const int CHUNK_SIZE = 16;
+
+  /** Draw batches of a chunk, built once and kept until one of its
+      tiles changes. */
+  struct Chunk
+  {
+    struct Batch
+    {
+      SurfacePtr surface;
+      std::vector<Rectf> srcrects;
+      /** Relative to the position of tile (0, 0). */
+      std::vector<Rectf> dstrects;
+    };
+
+    bool dirty = true;
+    std::vector<Batch> batches;
+
+    /** Animated tiles in the chunk and the surface they were batched
+        with, the chunk gets rebuilt once any of them moves on. */
+    std::vector<std::pair<const Tile*, const Surface*>> animated;
+  };
+
 public:
   bool m_editor_active;
 
@@ -301,6 +341,11 @@ private:
 
   typedef std::vector<uint32_t> Tiles;
   Tiles m_tiles;
+  uint32_t m_revision;
+
+  std::vector<Chunk> m_chunks;
+  uint32_t m_chunks_revision;
+  bool m_chunks_editor;
 
 #ifdef DOXYGEN_SCRIPTING
   /**
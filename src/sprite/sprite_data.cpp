@@ -81,6 +81,39 @@ LinkedSpritesContainer::parse_linked_sprites(const ReaderMapping& mapping)
 }
 
 
+namespace {
+
+void get_linked_sprite_files(const ReaderMapping& mapping, std::vector<std::string>& sprites)
+{
+  auto iter = mapping.get_iter();
+  while (iter.next())
+  {
+    std::string file;
+    if (!iter.as_mapping().get("file", file))
+      continue;
+
+    // Same as LinkedSpritesContainer::parse_linked_sprites().
+    std::string filepath = FileSystem::join(mapping.get_doc().get_directory(), file);
+    if (!PHYSFS_exists(filepath.c_str()))
+      filepath = file;
+    sprites.push_back(filepath);
+  }
+}
+
+void get_surface_files(const ReaderMapping& mapping, std::vector<std::string>& images)
+{
+  for (const char* texture : { "diffuse-texture", "displacement-texture" })
+  {
+    std::optional<ReaderMapping> texture_mapping;
+    std::string file;
+    if (mapping.get(texture, texture_mapping) && texture_mapping->get("file", file))
+      images.push_back(FileSystem::join(mapping.get_doc().get_directory(), file));
+  }
+}
+
+} // namespace
+
+
 SpriteData::Action::Action() :
   name(),
   x_offset(0),
@@ -115,6 +148,63 @@ SpriteData::Action::reset(SurfacePtr surface)
 }
 
 
+void
+SpriteData::get_files(const ReaderDocument& doc,
+                      std::vector<std::string>& images,
+                      std::vector<std::string>& sprites)
+{
+  auto root = doc.get_root();
+  if (root.get_name() != "supertux-sprite")
+    return;
+
+  const std::string directory = doc.get_directory();
+  auto iter = root.get_mapping().get_iter();
+  while (iter.next())
+  {
+    if (iter.get_key() == "linked-sprites")
+    {
+      get_linked_sprite_files(iter.as_mapping(), sprites);
+      continue;
+    }
+    else if (iter.get_key() != "action")
+    {
+      continue;
+    }
+
+    // Mirrored, flipped and cloned actions reuse the images of an
+    // action from the same file.
+    auto mapping = iter.as_mapping();
+    std::optional<ReaderMapping> linked_sprites_mapping;
+    if (mapping.get("linked-sprites", linked_sprites_mapping))
+      get_linked_sprite_files(*linked_sprites_mapping, sprites);
+
+    std::optional<ReaderMapping> regions_mapping;
+    std::vector<std::string> action_images;
+    std::optional<ReaderCollection> surfaces_collection;
+    if (mapping.get("regions", regions_mapping))
+    {
+      auto region_iter = regions_mapping->get_iter();
+      while (region_iter.next())
+      {
+        const auto& sx = region_iter.as_mapping().get_sexp();
+        if (region_iter.get_key() == "region" && sx.is_array() &&
+            sx.as_array().size() == 6 && sx.as_array()[1].is_string())
+          images.push_back(FileSystem::join(directory, sx.as_array()[1].as_string()));
+      }
+    }
+    else if (mapping.get("images", action_images))
+    {
+      for (const auto& image : action_images)
+        images.push_back(FileSystem::join(directory, image));
+    }
+    else if (mapping.get("surfaces", surfaces_collection))
+    {
+      for (const auto& surface : surfaces_collection->get_objects())
+        get_surface_files(surface.get_mapping(), images);
+    }
+  }
+}
+
 SpriteData::SpriteData(const std::string& filename) :
   m_filename(filename),
   m_load_successful(false),
@@ -123,8 +213,22 @@ SpriteData::SpriteData(const std::string& filename) :
   load();
 }
 
+SpriteData::SpriteData(const ReaderDocument& doc) :
+  m_filename(doc.get_filename()),
+  m_load_successful(false),
+  actions()
+{
+  load(&doc);
+}
+
 void
 SpriteData::load()
+{
+  load(nullptr);
+}
+
+void
+SpriteData::load(const ReaderDocument* doc)
 {
   // Reset all existing actions to a dummy texture
   if (!actions.empty())
@@ -138,8 +242,13 @@ SpriteData::load()
   {
     try
     {
-      auto doc = ReaderDocument::from_file(m_filename);
-      auto root = doc.get_root();
+      std::optional<ReaderDocument> file_doc;
+      if (!doc)
+      {
+        file_doc = ReaderDocument::from_file(m_filename);
+        doc = &*file_doc;
+      }
+      auto root = doc->get_root();
 
       if (root.get_name() != "supertux-sprite")
       {
@@ -27,6 +27,7 @@
 #include "video/color.hpp"
 #include "video/surface_ptr.hpp"
 
+class ReaderDocument;
 class ReaderMapping;
 
 class LinkedSpritesContainer
@@ -60,8 +61,17 @@ class SpriteData final : public LinkedSpritesContainer
 {
   friend class Sprite;
 
+public:
+  /** Lists the image files and the linked sprite files that the
+      sprite in 'doc' uses, resolved the way load() resolves them. */
+  static void get_files(const ReaderDocument& doc,
+                        std::vector<std::string>& images,
+                        std::vector<std::string>& sprites);
+
 public:
   SpriteData(const std::string& filename);
+  /** Loads the ".sprite" file that 'doc' was parsed from. */
+  SpriteData(const ReaderDocument& doc);
 
   void load();
 
@@ -111,6 +121,8 @@ private:
   };
 
 private:
+  /** 'doc' is the already parsed sprite file, if any. */
+  void load(const ReaderDocument* doc);
   void parse(const ReaderMapping& mapping);
   void parse_action(const ReaderMapping& mapping);
 
@@ -17,7 +17,12 @@
 
 #include "sprite/sprite_manager.hpp"
 
+#include <unordered_set>
+
 #include "sprite/sprite.hpp"
+#include "util/reader_document.hpp"
+#include "util/string_util.hpp"
+#include "video/texture_manager.hpp"
 
 SpriteManager::SpriteManager() :
   m_sprites()
@@ -49,6 +54,46 @@ SpriteManager::load(const std::string& filename)
   return m_sprites[filename].get();
 }
 
+void
+SpriteManager::prefetch(const std::vector<std::string>& filenames)
+{
+  std::vector<std::string> pending = filenames;
+  std::unordered_set<std::string> seen;
+  std::vector<std::string> images;
+  std::vector<ReaderDocument> docs;
+  while (!pending.empty())
+  {
+    const std::string filename = std::move(pending.back());
+    pending.pop_back();
+    if (m_sprites.find(filename) != m_sprites.end() || !seen.insert(filename).second)
+      continue;
+
+    // Plain images are loaded as sprites once they are used.
+    if (!StringUtil::has_suffix(filename, ".sprite"))
+    {
+      images.push_back(filename);
+      continue;
+    }
+
+    try
+    {
+      auto doc = ReaderDocument::from_file(filename);
+      SpriteData::get_files(doc, images, pending);
+      docs.push_back(std::move(doc));
+    }
+    catch (const std::exception&)
+    {
+      // Broken sprites get reported by create().
+    }
+  }
+
+  if (TextureManager* texture_manager = TextureManager::current())
+    texture_manager->prefetch(images);
+
+  for (const auto& doc : docs)
+    m_sprites[doc.get_filename()] = std::make_unique<SpriteData>(doc);
+}
+
 void
 SpriteManager::reload()
 {
@@ -22,6 +22,7 @@
 #include <unordered_map>
 #include <memory>
 #include <string>
+#include <vector>
 
 #include "sprite/sprite_ptr.hpp"
 
@@ -39,6 +40,11 @@ public:
   /** Loads a sprite. */
   SpritePtr create(const std::string& filename);
 
+  /** Loads the given sprites and the sprites they link to, unless
+      they are loaded already. Their images are handed to the
+      TextureManager to decode in the background first. */
+  void prefetch(const std::vector<std::string>& filenames);
+
   /** Reloads all sprites. */
   void reload();
 
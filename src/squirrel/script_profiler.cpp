@@ -0,0 +1,139 @@
+//  SuperTux
+//  Copyright (C) 2026 SuperTux Development Team
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#include "squirrel/script_profiler.hpp"
+
+#include <algorithm>
+
+#include "util/log.hpp"
+
+ScriptProfiler::Scope::Scope(ScriptProfiler& profiler, const std::string& sourcename) :
+  m_profiler(profiler),
+  m_outer(profiler.m_current),
+  m_sourcename(sourcename),
+  m_start(std::chrono::steady_clock::now())
+{
+  m_profiler.m_current = this;
+}
+
+ScriptProfiler::Scope::Scope(ScriptProfiler& profiler, HSQUIRRELVM thread) :
+  Scope(profiler, get_thread_source(thread))
+{
+}
+
+ScriptProfiler::Scope::~Scope()
+{
+  const std::chrono::duration<double, std::milli> duration = std::chrono::steady_clock::now() - m_start;
+  m_profiler.m_current = m_outer;
+  m_profiler.add_time(m_sourcename, duration.count());
+}
+
+std::string
+ScriptProfiler::get_thread_source(HSQUIRRELVM thread)
+{
+  const SQChar* source = nullptr;
+  SQStackInfos info;
+  for (SQInteger level = 0; SQ_SUCCEEDED(sq_stackinfos(thread, level, &info)); ++level)
+  {
+    if (info.source)
+      source = info.source;
+  }
+  return source ? source : "(unknown)";
+}
+
+ScriptProfiler::ScriptProfiler() :
+  m_stats(),
+  m_current(nullptr),
+  m_budget_ms(0.0f),
+  m_frame_ms(0.0),
+  m_current_frame_ms(0.0)
+{
+}
+
+void
+ScriptProfiler::new_frame()
+{
+  m_frame_ms = m_current_frame_ms;
+  m_current_frame_ms = 0.0;
+}
+
+bool
+ScriptProfiler::is_over_budget() const
+{
+  return m_budget_ms > 0.0f && m_current_frame_ms >= static_cast<double>(m_budget_ms);
+}
+
+bool
+ScriptProfiler::is_runaway() const
+{
+  if (m_budget_ms <= 0.0f || !m_current)
+    return false;
+
+  const std::chrono::duration<double, std::milli> duration = std::chrono::steady_clock::now() - m_current->m_start;
+  return duration.count() > static_cast<double>(m_budget_ms);
+}
+
+std::string
+ScriptProfiler::get_current_source() const
+{
+  return m_current ? m_current->m_sourcename : std::string();
+}
+
+std::vector<std::pair<std::string, ScriptProfiler::Stats>>
+ScriptProfiler::get_top(size_t count) const
+{
+  std::vector<std::pair<std::string, Stats>> top(m_stats.begin(), m_stats.end());
+  std::sort(top.begin(), top.end(),
+            [](const std::pair<std::string, Stats>& lhs, const std::pair<std::string, Stats>& rhs) {
+              return lhs.second.total_ms > rhs.second.total_ms;
+            });
+  if (top.size() > count)
+    top.resize(count);
+  return top;
+}
+
+void
+ScriptProfiler::print_stats() const
+{
+  log_info << "Script time of the last frame: " << m_frame_ms << " ms, budget: "
+           << (m_budget_ms > 0.0f ? std::to_string(m_budget_ms) + " ms" : "none") << std::endl;
+  for (const auto& [sourcename, stats] : get_top(m_stats.size()))
+  {
+    log_info << "  " << sourcename << ": " << stats.calls << " runs, "
+             << stats.total_ms << " ms total, "
+             << stats.total_ms / stats.calls << " ms avg, "
+             << stats.max_ms << " ms max" << std::endl;
+  }
+}
+
+void
+ScriptProfiler::reset()
+{
+  m_stats.clear();
+}
+
+void
+ScriptProfiler::add_time(const std::string& sourcename, double ms)
+{
+  Stats& stats = m_stats[sourcename];
+  stats.calls += 1;
+  stats.total_ms += ms;
+  stats.max_ms = std::max(stats.max_ms, ms);
+
+  // Nested scripts are already part of the time of the outer one.
+  if (!m_current)
+    m_current_frame_ms += ms;
+}
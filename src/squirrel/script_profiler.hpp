@@ -0,0 +1,110 @@
+//  SuperTux
+//  Copyright (C) 2026 SuperTux Development Team
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#pragma once
+
+#include <chrono>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include <squirrel.h>
+
+/** Measures how long scripts run, aggregated by the source name they
+    were started with, and tracks the per-frame script time budget. */
+class ScriptProfiler final
+{
+public:
+  struct Stats
+  {
+    int calls = 0;
+    double total_ms = 0.0;
+    double max_ms = 0.0;
+  };
+
+  /** Times a single run or resume of a script thread. Scopes may
+      nest, when a script runs another one. */
+  class Scope final
+  {
+  public:
+    Scope(ScriptProfiler& profiler, const std::string& sourcename);
+    /** Attributes the time to the script 'thread' was started with. */
+    Scope(ScriptProfiler& profiler, HSQUIRRELVM thread);
+    ~Scope();
+
+  private:
+    friend class ScriptProfiler;
+
+    ScriptProfiler& m_profiler;
+    const Scope* m_outer;
+    std::string m_sourcename;
+    std::chrono::steady_clock::time_point m_start;
+
+  private:
+    Scope(const Scope&) = delete;
+    Scope& operator=(const Scope&) = delete;
+  };
+
+public:
+  /** Returns the source name of the outermost function on the call
+      stack of 'thread'. */
+  static std::string get_thread_source(HSQUIRRELVM thread);
+
+public:
+  ScriptProfiler();
+
+  /** Closes the frame, the script time of the frame that was
+      measured becomes the one returned by get_frame_time(). */
+  void new_frame();
+
+  /** True once the scripts of the current frame ran for longer than
+      the budget, scheduled threads should then wait for the next. */
+  bool is_over_budget() const;
+
+  /** True if the innermost running script alone has exceeded the
+      budget. */
+  bool is_runaway() const;
+
+  /** Source name of the innermost running script. */
+  std::string get_current_source() const;
+
+  /** Budget in milliseconds per frame, 0 disables it. */
+  inline void set_budget(float budget_ms) { m_budget_ms = budget_ms; }
+  inline float get_budget() const { return m_budget_ms; }
+
+  inline double get_frame_time() const { return m_frame_ms; }
+
+  /** The 'count' scripts that took the longest overall. */
+  std::vector<std::pair<std::string, Stats>> get_top(size_t count) const;
+
+  void print_stats() const;
+  void reset();
+
+private:
+  void add_time(const std::string& sourcename, double ms);
+
+private:
+  std::unordered_map<std::string, Stats> m_stats;
+  const Scope* m_current;
+  float m_budget_ms;
+  double m_frame_ms;
+  double m_current_frame_ms;
+
+private:
+  ScriptProfiler(const ScriptProfiler&) = delete;
+  ScriptProfiler& operator=(const ScriptProfiler&) = delete;
+};
@@ -17,6 +17,7 @@
 #include "squirrel/squirrel_environment.hpp"
 
 #include <algorithm>
+#include <sstream>
 
 #include <simplesquirrel/class.hpp>
 #include <simplesquirrel/vm.hpp>
@@ -26,11 +27,20 @@
 #include "supertux/globals.hpp"
 #include "util/log.hpp"
 
+namespace {
+
+/** Levels have a few dozen distinct scripts, more than this means
+    scripts are generated at runtime. */
+const size_t s_max_compiled_scripts = 256;
+
+} // namespace
+
 SquirrelEnvironment::SquirrelEnvironment(ssq::VM& vm, const std::string& name) :
   m_vm(vm),
   m_table(m_vm.newTable()),
   m_name(name),
   m_scripts(),
+  m_compiled(),
   m_scheduler(std::make_unique<SquirrelScheduler>(m_vm))
 {
   // Set the root table as delegate.
@@ -40,6 +50,7 @@ SquirrelEnvironment::SquirrelEnvironment(ssq::VM& vm, const std::string& name) :
 SquirrelEnvironment::~SquirrelEnvironment()
 {
   m_scripts.clear();
+  m_compiled.clear();
   m_table.reset();
 }
 
@@ -90,12 +101,11 @@ SquirrelEnvironment::unexpose(const std::string& name)
 }
 
 void
-SquirrelEnvironment::run_script(const std::string& script, const std::string& sourcename)
+SquirrelEnvironment::run_script(std::istream& in, const std::string& sourcename)
 {
-  if (script.empty()) return;
-
-  std::istringstream stream(script);
-  run_script(stream, sourcename);
+  std::ostringstream script;
+  script << in.rdbuf();
+  run_script(script.str(), sourcename);
 }
 
 void
@@ -110,8 +120,10 @@ SquirrelEnvironment::garbage_collect()
 }
 
 void
-SquirrelEnvironment::run_script(std::istream& in, const std::string& sourcename)
+SquirrelEnvironment::run_script(const std::string& script, const std::string& sourcename)
 {
+  if (script.empty()) return;
+
   garbage_collect();
 
   try
@@ -120,7 +132,13 @@ SquirrelEnvironment::run_script(std::istream& in, const std::string& sourcename)
     thread.setForeignPtr(this);
     thread.setRootTable(m_table);
 
-    thread.run(thread.compileSource(in, sourcename.c_str()), true);
+    // Held here as running the script may run others, which can
+    // clear the cache.
+    const std::shared_ptr<ssq::Script> compiled = get_compiled(thread, script, sourcename);
+    {
+      ScriptProfiler::Scope scope(SquirrelVirtualMachine::current()->get_profiler(), sourcename);
+      thread.run(*compiled, true);
+    }
 
     m_scripts.push_back(std::move(thread));
   }
@@ -130,6 +148,43 @@ SquirrelEnvironment::run_script(std::istream& in, const std::string& sourcename)
   }
 }
 
+std::shared_ptr<ssq::Script>
+SquirrelEnvironment::get_compiled(ssq::VM& thread, const std::string& script,
+                                  const std::string& sourcename)
+{
+  std::string key = sourcename;
+  key += '\0';
+  key += script;
+
+  auto it = m_compiled.find(key);
+  if (it != m_compiled.end())
+    return it->second;
+
+  if (m_compiled.size() >= s_max_compiled_scripts)
+    m_compiled.clear();
+
+  // Closures pick up the root table of the thread they are created
+  // in, which is m_table here. The cached reference is held by the
+  // main VM, as 'thread' is gone once the script is done.
+  auto compiled = std::make_shared<ssq::Script>(m_vm.getHandle());
+  auto vm = SquirrelVirtualMachine::current();
+  if (vm && vm->push_precompiled(thread.getHandle(), script, sourcename))
+  {
+    sq_getstackobj(thread.getHandle(), -1, &compiled->getRaw());
+    sq_addref(m_vm.getHandle(), &compiled->getRaw());
+    sq_pop(thread.getHandle(), 1);
+  }
+  else
+  {
+    ssq::Script source = thread.compileSource(script.c_str(), sourcename.c_str());
+    compiled->getRaw() = source.getRaw();
+    sq_addref(m_vm.getHandle(), &compiled->getRaw());
+  }
+
+  m_compiled.emplace(std::move(key), compiled);
+  return compiled;
+}
+
 SQInteger
 SquirrelEnvironment::wait_for_seconds(HSQUIRRELVM vm, float seconds)
 {
@@ -17,7 +17,9 @@
 
 #pragma once
 
+#include <memory>
 #include <string>
+#include <unordered_map>
 #include <vector>
 
 #include <simplesquirrel/vm.hpp>
@@ -47,14 +49,15 @@ public:
   void expose(ExposableClass& object, const std::string& name);
   void unexpose(const std::string& name);
 
-  /** Convenience function that takes an std::string instead of an
-      std::istream& */
-  void run_script(const std::string& script, const std::string& sourcename);
-
   /** Runs a script in the context of the SquirrelEnvironment (m_table will
       be the roottable of this squirrel VM) and keeps a reference to
       the script so the script gets destroyed when the SquirrelEnvironment is
-      destroyed). */
+      destroyed). The compiled script is cached, running the same
+      script again only starts a new thread. */
+  void run_script(const std::string& script, const std::string& sourcename);
+
+  /** Convenience function that takes an std::istream& instead of an
+      std::string */
   void run_script(std::istream& in, const std::string& sourcename);
 
   void update(float dt_sec);
@@ -64,11 +67,21 @@ public:
 private:
   void garbage_collect();
 
+  /** Returns the compiled 'script', compiling it in 'thread' if it
+      isn't cached yet. */
+  std::shared_ptr<ssq::Script> get_compiled(ssq::VM& thread, const std::string& script,
+                                            const std::string& sourcename);
+
 private:
   ssq::VM& m_vm;
   ssq::Table m_table;
   std::string m_name;
   std::vector<ssq::VM> m_scripts;
+
+  /** Compiled scripts, keyed by source name and source text. Their
+      root table is m_table, so the cache can't be shared with other
+      environments. */
+  std::unordered_map<std::string, std::shared_ptr<ssq::Script>> m_compiled;
   std::unique_ptr<SquirrelScheduler> m_scheduler;
 
 private:
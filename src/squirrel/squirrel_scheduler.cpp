@@ -34,12 +34,25 @@ SquirrelScheduler::SquirrelScheduler(ssq::VM& vm) :
 void
 SquirrelScheduler::update(float time)
 {
+  ScriptProfiler& profiler = SquirrelVirtualMachine::current()->get_profiler();
+
   while (!schedule.empty() &&
          (schedule.front().wakeup_time < time ||
           (schedule.front().skippable && Level::current() &&
            Level::current()->m_skip_cutscene)))
   {
-    HSQOBJECT thread_ref = schedule.front().thread_ref;
+    // Threads that are due once the budget is used up wait for the
+    // next frame.
+    if (profiler.is_over_budget())
+      break;
+
+    // The woken thread may schedule itself again, so the entry has to
+    // be off the heap before.
+    const ScheduleEntry entry = schedule.front();
+    std::pop_heap(schedule.begin(), schedule.end());
+    schedule.pop_back();
+
+    HSQOBJECT thread_ref = entry.thread_ref;
 
     sq_pushobject(m_vm.getHandle(), thread_ref);
     sq_getweakrefval(m_vm.getHandle(), -1);
@@ -47,7 +60,13 @@ SquirrelScheduler::update(float time)
     HSQUIRRELVM scheduled_vm;
     if (sq_gettype(m_vm.getHandle(), -1) == OT_THREAD &&
        SQ_SUCCEEDED(sq_getthread(m_vm.getHandle(), -1, &scheduled_vm))) {
-      if (SQ_FAILED(sq_wakeupvm(scheduled_vm, SQFalse, SQFalse, SQTrue, SQFalse))) {
+      ScriptProfiler::Scope scope(profiler, scheduled_vm);
+
+      // A runaway thread is resumed with an error, which unwinds it.
+      if (entry.runaway)
+        sq_throwerror(scheduled_vm, "script exceeded the time budget");
+
+      if (SQ_FAILED(sq_wakeupvm(scheduled_vm, SQFalse, SQFalse, SQTrue, entry.runaway ? SQTrue : SQFalse))) {
         std::ostringstream msg;
         msg << "Error waking VM: ";
         sq_getlasterror(scheduled_vm);
@@ -65,9 +84,6 @@ SquirrelScheduler::update(float time)
 
     sq_release(m_vm.getHandle(), &thread_ref);
     sq_pop(m_vm.getHandle(), 2);
-
-    std::pop_heap(schedule.begin(), schedule.end());
-    schedule.pop_back();
   }
 }
 
@@ -86,6 +102,14 @@ SquirrelScheduler::schedule_thread(HSQUIRRELVM scheduled_vm, float time, bool sk
   entry.wakeup_time = time;
   entry.skippable = skippable;
 
+  const ScriptProfiler& profiler = SquirrelVirtualMachine::current()->get_profiler();
+  entry.runaway = profiler.is_runaway();
+  if (entry.runaway)
+  {
+    log_warning << "Script '" << profiler.get_current_source() << "' ran for longer than the budget of "
+                << profiler.get_budget() << " ms, stopping it" << std::endl;
+  }
+
   sq_addref(m_vm.getHandle(), & entry.thread_ref);
   sq_pop(m_vm.getHandle(), 2);
 
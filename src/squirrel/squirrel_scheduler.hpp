@@ -41,6 +41,8 @@ private:
     float wakeup_time;
     // true if calling force_wake_up should wake this entry up
     bool skippable;
+    /// true if the thread ran over the time budget before waiting
+    bool runaway;
 
     bool operator<(const ScheduleEntry& other) const
     {
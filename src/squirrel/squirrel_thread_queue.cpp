@@ -54,6 +54,8 @@ SquirrelThreadQueue::wakeup()
   SquirrelObjectList threads = std::move(m_threads);
   m_threads.clear();
 
+  ScriptProfiler& profiler = SquirrelVirtualMachine::current()->get_profiler();
+
   for (HSQOBJECT& object : threads)
   {
     sq_pushobject(m_vm.getHandle(), object);
@@ -63,6 +65,7 @@ SquirrelThreadQueue::wakeup()
     if (sq_gettype(m_vm.getHandle(), -1) == OT_THREAD &&
        SQ_SUCCEEDED(sq_getthread(m_vm.getHandle(), -1, &scheduled_vm)))
     {
+      ScriptProfiler::Scope scope(profiler, scheduled_vm);
       if (SQ_FAILED(sq_wakeupvm(scheduled_vm, SQFalse, SQFalse, SQTrue, SQFalse))) {
         log_warning << "Couldn't wakeup scheduled squirrel VM" << std::endl;
       }
@@ -16,6 +16,7 @@
 
 #include "squirrel/squirrel_virtual_machine.hpp"
 
+#include <algorithm>
 #include <cstring>
 #include <stdarg.h>
 #include <stdio.h>
@@ -27,6 +28,7 @@
 #include "squirrel/supertux_api.hpp"
 #include "supertux/console.hpp"
 #include "supertux/globals.hpp"
+#include "util/job_system.hpp"
 #include "util/log.hpp"
 
 #ifdef ENABLE_SQDBG
@@ -57,10 +59,40 @@ static void printFunc(HSQUIRRELVM, const char* fmt, ...)
 
 static const char* DEFAULT_SCRIPT_FILE = "scripts/default.nut";
 
+namespace {
+
+struct BytecodeReader
+{
+  const std::string& data;
+  size_t pos;
+};
+
+SQInteger
+write_bytecode(SQUserPointer user, SQUserPointer data, SQInteger size)
+{
+  static_cast<std::string*>(user)->append(static_cast<const char*>(data), static_cast<size_t>(size));
+  return size;
+}
+
+SQInteger
+read_bytecode(SQUserPointer user, SQUserPointer data, SQInteger size)
+{
+  auto& reader = *static_cast<BytecodeReader*>(user);
+  const size_t count = std::min(static_cast<size_t>(size), reader.data.size() - reader.pos);
+  memcpy(data, reader.data.data() + reader.pos, count);
+  reader.pos += count;
+  return static_cast<SQInteger>(count);
+}
+
+} // namespace
+
 SquirrelVirtualMachine::SquirrelVirtualMachine(bool enable_debugger) :
   m_vm(64, ssq::Libs::BLOB | ssq::Libs::MATH | ssq::Libs::STRING),
   m_screenswitch_queue(),
-  m_scheduler()
+  m_scheduler(),
+  m_profiler(),
+  m_precompile(!enable_debugger),
+  m_precompiled(std::make_shared<PrecompiledScripts>())
 {
   m_vm.setForeignPtr(this);
 
@@ -118,6 +150,7 @@ SquirrelVirtualMachine::~SquirrelVirtualMachine()
 void
 SquirrelVirtualMachine::update(float dt_sec)
 {
+  m_profiler.new_frame();
   update_debugger();
   m_scheduler->update(g_game_time);
 }
@@ -154,3 +187,63 @@ SquirrelVirtualMachine::wakeup_screenswitch()
 {
   m_screenswitch_queue->wakeup();
 }
+
+std::string
+SquirrelVirtualMachine::get_precompiled_key(const std::string& script, const std::string& sourcename)
+{
+  // The closure keeps the name it got compiled with, a script run
+  // under another name has to be compiled again.
+  std::string key = sourcename;
+  key += '\0';
+  key += script;
+  return key;
+}
+
+void
+SquirrelVirtualMachine::precompile(std::vector<std::pair<std::string, std::string>> scripts)
+{
+  m_precompiled = std::make_shared<PrecompiledScripts>();
+
+  JobSystem* job_system = JobSystem::current();
+  if (!m_precompile || !job_system || scripts.empty())
+    return;
+
+  job_system->submit([precompiled = m_precompiled, scripts = std::move(scripts)] {
+    // The worker gets a VM of its own, compiled closures don't depend
+    // on the VM state they were compiled in. Scripts that don't
+    // compile are left to run_script(), which reports the error.
+    HSQUIRRELVM vm = sq_open(64);
+    for (const auto& [sourcename, script] : scripts)
+    {
+      if (SQ_FAILED(sq_compilebuffer(vm, script.c_str(), static_cast<SQInteger>(script.size()),
+                                     sourcename.c_str(), SQFalse)))
+        continue;
+
+      std::string bytecode;
+      if (SQ_SUCCEEDED(sq_writeclosure(vm, &write_bytecode, &bytecode)))
+      {
+        std::lock_guard<std::mutex> lock(precompiled->mutex);
+        precompiled->bytecode.emplace(get_precompiled_key(script, sourcename), std::move(bytecode));
+      }
+      sq_pop(vm, 1);
+    }
+    sq_close(vm);
+  });
+}
+
+bool
+SquirrelVirtualMachine::push_precompiled(HSQUIRRELVM vm, const std::string& script,
+                                         const std::string& sourcename)
+{
+  std::string bytecode;
+  {
+    std::lock_guard<std::mutex> lock(m_precompiled->mutex);
+    auto it = m_precompiled->bytecode.find(get_precompiled_key(script, sourcename));
+    if (it == m_precompiled->bytecode.end())
+      return false;
+    bytecode = it->second;
+  }
+
+  BytecodeReader reader{ bytecode, 0 };
+  return SQ_SUCCEEDED(sq_readclosure(vm, &read_bytecode, &reader));
+}
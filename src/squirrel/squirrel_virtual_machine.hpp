@@ -17,9 +17,15 @@
 #pragma once
 
 #include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
 
 #include <simplesquirrel/vm.hpp>
 
+#include "squirrel/script_profiler.hpp"
 #include "util/currenton.hpp"
 
 class SquirrelThreadQueue;
@@ -27,11 +33,22 @@ class SquirrelScheduler;
 
 class SquirrelVirtualMachine final : public Currenton<SquirrelVirtualMachine>
 {
+private:
+  /** Bytecode of precompiled scripts, keyed by their source name and
+      text, see get_precompiled_key(). Filled in by a worker, shared with it so that it outlives a
+      later precompile() call. */
+  struct PrecompiledScripts
+  {
+    std::mutex mutex;
+    std::unordered_map<std::string, std::string> bytecode;
+  };
+
 public:
   SquirrelVirtualMachine(bool enable_debugger);
   ~SquirrelVirtualMachine() override;
 
   inline ssq::VM& get_vm() { return m_vm; }
+  inline ScriptProfiler& get_profiler() { return m_profiler; }
 
   SQInteger wait_for_seconds(HSQUIRRELVM vm, float seconds);
   SQInteger skippable_wait_for_seconds(HSQUIRRELVM vm, float seconds);
@@ -43,7 +60,19 @@ public:
   /** wakes up threads waiting for a screen switch event */
   void wakeup_screenswitch();
 
+  /** Compiles the given (sourcename, script) pairs to bytecode on a
+      worker thread, replacing the previously precompiled scripts. */
+  void precompile(std::vector<std::pair<std::string, std::string>> scripts);
+
+  /** Pushes the precompiled closure of 'script' onto the stack of
+      'vm', its root table being the one of 'vm'. Returns false if
+      'script' wasn't precompiled (yet) under 'sourcename', which the
+      closure reports its errors with. */
+  bool push_precompiled(HSQUIRRELVM vm, const std::string& script, const std::string& sourcename);
+
 private:
+  static std::string get_precompiled_key(const std::string& script, const std::string& sourcename);
+
   void update_debugger();
 
 private:
@@ -51,6 +80,11 @@ private:
 
   std::unique_ptr<SquirrelThreadQueue> m_screenswitch_queue;
   std::unique_ptr<SquirrelScheduler> m_scheduler;
+  ScriptProfiler m_profiler;
+
+  /** Precompiled bytecode lacks the line ops the debugger needs. */
+  bool m_precompile;
+  std::shared_ptr<PrecompiledScripts> m_precompiled;
 
 private:
   SquirrelVirtualMachine(const SquirrelVirtualMachine&) = delete;
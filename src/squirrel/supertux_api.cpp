@@ -16,6 +16,8 @@
 
 #include "squirrel/supertux_api.hpp"
 
+#include <algorithm>
+
 #include <simplesquirrel/table.hpp>
 #include <simplesquirrel/vm.hpp>
 #include <sqstdaux.h>
@@ -477,6 +479,50 @@ static void play_sound(const std::string& filename)
 {
   SoundManager::current()->play(filename);
 }
+/**
+ * @scripting
+ * @description Prints how much memory the loaded sounds use, and how often they were reused, loaded and freed.
+ */
+static void debug_sound_buffers()
+{
+  SoundManager::current()->print_buffer_stats();
+}
+/**
+ * @scripting
+ * @description Prints how often and how long each script ran, by source name.
+ */
+static void debug_script_timings()
+{
+  SquirrelVirtualMachine::current()->get_profiler().print_stats();
+}
+/**
+ * @scripting
+ * @description Clears the collected script timings.
+ */
+static void debug_reset_script_timings()
+{
+  SquirrelVirtualMachine::current()->get_profiler().reset();
+}
+/**
+ * @scripting
+ * @description Enables/disables drawing of the scripts that took the longest.
+ * @param bool $enable
+ */
+static void debug_show_script_timings(bool enable)
+{
+  g_config->show_script_timings = enable;
+}
+/**
+ * @scripting
+ * @description Sets how many milliseconds per frame scheduled scripts may run for, 0 disables the budget.
+                Scripts that exceed the budget on their own are stopped.
+ * @param float $budget
+ */
+static void debug_script_budget(float budget)
+{
+  g_config->script_budget = std::max(budget, 0.0f);
+  SquirrelVirtualMachine::current()->get_profiler().set_budget(g_config->script_budget);
+}
 
 /**
  * @scripting
@@ -856,6 +902,11 @@ void register_supertux_scripting_api(ssq::VM& vm)
   vm.addFunc("resume_music", &scripting::Globals::resume_music);
   vm.addFunc("pause_music", &scripting::Globals::pause_music);
   vm.addFunc("play_sound", &scripting::Globals::play_sound);
+  vm.addFunc("debug_sound_buffers", &scripting::Globals::debug_sound_buffers);
+  vm.addFunc("debug_script_timings", &scripting::Globals::debug_script_timings);
+  vm.addFunc("debug_reset_script_timings", &scripting::Globals::debug_reset_script_timings);
+  vm.addFunc("debug_show_script_timings", &scripting::Globals::debug_show_script_timings);
+  vm.addFunc("debug_script_budget", &scripting::Globals::debug_script_budget);
   vm.addFunc("grease", &scripting::Globals::grease);
   vm.addFunc("invincible", &scripting::Globals::invincible);
   vm.addFunc("ghost", &scripting::Globals::ghost);
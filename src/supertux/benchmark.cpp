@@ -0,0 +1,287 @@
+//  SuperTux
+//  Copyright (C) 2026 SuperTux Development Team
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#include "supertux/benchmark.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <iomanip>
+#include <numeric>
+#include <stdexcept>
+
+#include "control/codecontroller.hpp"
+#include "control/input_manager.hpp"
+#include "object/player.hpp"
+#include "supertux/constants.hpp"
+#include "supertux/game_session.hpp"
+#include "supertux/screen_manager.hpp"
+#include "supertux/sector.hpp"
+#include "util/log.hpp"
+#include "util/reader_collection.hpp"
+#include "util/reader_document.hpp"
+#include "util/reader_mapping.hpp"
+#include "video/compositor.hpp"
+#include "video/texture.hpp"
+
+namespace {
+
+/** Returns the value below which 'percentile' percent of the sorted
+    'values' lie, using the nearest rank method. */
+double get_percentile(const std::vector<double>& values, double percentile)
+{
+  if (values.empty())
+    return 0.0;
+
+  const size_t rank = static_cast<size_t>(std::ceil(percentile / 100.0 * static_cast<double>(values.size())));
+  return values[std::min(std::max<size_t>(rank, 1), values.size()) - 1];
+}
+
+void print_row(std::ostream& out, const char* name, std::vector<double> values)
+{
+  std::sort(values.begin(), values.end());
+
+  const double total = std::accumulate(values.begin(), values.end(), 0.0);
+  const double mean = values.empty() ? 0.0 : total / static_cast<double>(values.size());
+
+  out << std::left << std::setw(12) << name << std::right
+      << std::setw(10) << total
+      << std::setw(10) << mean
+      << std::setw(10) << get_percentile(values, 50.0)
+      << std::setw(10) << get_percentile(values, 90.0)
+      << std::setw(10) << get_percentile(values, 99.0)
+      << std::setw(10) << (values.empty() ? 0.0 : values.back())
+      << "\n";
+}
+
+} // namespace
+
+const char*
+Benchmark::get_section_name(Section section)
+{
+  switch (section)
+  {
+    case SECTION_SCRIPT:
+      return "script";
+    case SECTION_UPDATE:
+      return "update";
+    case SECTION_COLLISION:
+      return "collision";
+    case SECTION_DRAW:
+      return "draw";
+    case SECTION_RENDER:
+      return "render";
+    default:
+      return "unknown";
+  }
+}
+
+Benchmark::Benchmark(const std::string& levelfile, int frames,
+                     const std::string& input_filename) :
+  m_levelfile(levelfile),
+  m_frames(frames),
+  m_controller(new CodeController()),
+  m_input(),
+  m_input_pos(0),
+  m_input_step(0),
+  m_current_frame(),
+  m_frame_times(),
+  m_total_times(),
+  m_level_loads(),
+  m_total_requests(0),
+  m_total_draw_calls(0),
+  m_textures_created(0)
+{
+  if (input_filename.empty())
+  {
+    // Run to the right and jump every second.
+    m_input.push_back({ 40, { Control::RIGHT } });
+    m_input.push_back({ 20, { Control::RIGHT, Control::JUMP } });
+  }
+  else
+  {
+    load_input(input_filename);
+  }
+
+  m_frame_times.reserve(m_frames);
+  m_total_times.reserve(m_frames);
+}
+
+Benchmark::~Benchmark()
+{
+}
+
+void
+Benchmark::load_input(const std::string& filename)
+{
+  // The input file lists the controls to hold down and for how many
+  // steps, it is repeated from the start when it runs out:
+  //
+  //   (supertux-benchmark-input
+  //     (step (steps 40) (controls "right"))
+  //     (step (steps 20) (controls "right" "jump")))
+  std::ifstream in(filename);
+  if (!in)
+    throw std::runtime_error("Couldn't open benchmark input file '" + filename + "'");
+
+  auto doc = ReaderDocument::from_stream(in, filename);
+  auto root = doc.get_root();
+  if (root.get_name() != "supertux-benchmark-input")
+    throw std::runtime_error("'" + filename + "' is not a supertux-benchmark-input file");
+
+  for (const auto& step_node : root.get_collection().get_objects())
+  {
+    if (step_node.get_name() != "step")
+    {
+      log_warning << "Unknown token in benchmark input: " << step_node.get_name() << std::endl;
+      continue;
+    }
+
+    auto mapping = step_node.get_mapping();
+
+    InputStep step;
+    mapping.get("steps", step.steps, 1);
+
+    std::vector<std::string> controls;
+    mapping.get("controls", controls);
+    for (const auto& control_text : controls)
+    {
+      if (const auto control = Control_from_string(control_text))
+        step.controls.push_back(*control);
+      else
+        log_warning << "Unknown control in benchmark input: " << control_text << std::endl;
+    }
+
+    if (step.steps > 0)
+      m_input.push_back(std::move(step));
+  }
+
+  if (m_input.empty())
+    throw std::runtime_error("Benchmark input file '" + filename + "' contains no steps");
+}
+
+void
+Benchmark::apply_input(GameSession& session)
+{
+  m_controller->update();
+
+  const InputStep& step = m_input[m_input_pos];
+  for (const auto& control : step.controls)
+    m_controller->press(control);
+
+  if (++m_input_step >= step.steps)
+  {
+    m_input_step = 0;
+    m_input_pos = (m_input_pos + 1) % m_input.size();
+  }
+
+  // Players get recreated when the level restarts, so attach the
+  // controller again, but leave players alone that scripts are driving.
+  for (auto* player : session.get_current_sector().get_players())
+  {
+    if (player->get_id() == 0 &&
+        &player->get_controller() == &InputManager::current()->get_controller(0))
+      player->set_controller(m_controller.get());
+  }
+}
+
+void
+Benchmark::add_time(Section section, std::chrono::steady_clock::duration duration)
+{
+  m_current_frame[section] += std::chrono::duration<double, std::milli>(duration).count();
+}
+
+void
+Benchmark::add_level_load(std::chrono::steady_clock::duration duration)
+{
+  m_level_loads.push_back(std::chrono::duration<double, std::milli>(duration).count());
+}
+
+void
+Benchmark::run(ScreenManager& screen_manager, std::unique_ptr<GameSession> session)
+{
+  session->skip_level_intro();
+  screen_manager.push_screen(std::move(session));
+
+  log_info << "Benchmarking " << m_levelfile << " for " << m_frames << " frames" << std::endl;
+
+  const int textures_before = Texture::s_created;
+
+  for (int frame = 0; frame < m_frames; ++frame)
+  {
+    m_current_frame.fill(0.0);
+    const auto start = std::chrono::steady_clock::now();
+
+    if (GameSession* current_session = GameSession::current())
+      apply_input(*current_session);
+
+    if (!screen_manager.step())
+    {
+      log_info << "Level ended after " << frame << " frames" << std::endl;
+      break;
+    }
+
+    m_total_times.push_back(std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count());
+    m_frame_times.push_back(m_current_frame);
+    m_total_requests += Compositor::s_frame_requests;
+    m_total_draw_calls += Compositor::s_frame_draw_calls;
+  }
+
+  m_textures_created = Texture::s_created - textures_before;
+}
+
+void
+Benchmark::print_report(std::ostream& out) const
+{
+  out << "Benchmark: " << m_levelfile << ", " << m_frame_times.size() << " frames\n"
+      << std::left << std::setw(12) << "section" << std::right
+      << std::setw(10) << "total"
+      << std::setw(10) << "mean"
+      << std::setw(10) << "p50"
+      << std::setw(10) << "p90"
+      << std::setw(10) << "p99"
+      << std::setw(10) << "max"
+      << "\n"
+      << std::fixed << std::setprecision(3);
+
+  std::vector<double> values(m_frame_times.size());
+  for (int section = 0; section < SECTION_COUNT; ++section)
+  {
+    std::transform(m_frame_times.begin(), m_frame_times.end(), values.begin(),
+                   [section](const FrameTimes& times) { return times[section]; });
+    print_row(out, get_section_name(static_cast<Section>(section)), values);
+  }
+  print_row(out, "frame", m_total_times);
+  if (m_level_loads.size() > 1)
+    print_row(out, "restart", std::vector<double>(m_level_loads.begin() + 1, m_level_loads.end()));
+
+  out << "(times in milliseconds)\n";
+
+  if (!m_level_loads.empty())
+    out << "level load: " << m_level_loads.front() << " ms, "
+        << m_level_loads.size() - 1 << " restarts\n";
+
+  if (!m_frame_times.empty())
+  {
+    const double frames = static_cast<double>(m_frame_times.size());
+    out << "draw calls per frame: " << static_cast<double>(m_total_draw_calls) / frames
+        << " (from " << static_cast<double>(m_total_requests) / frames << " requests)\n";
+
+    const double minutes = frames / LOGICAL_FPS / 60.0;
+    out << "textures created per minute: " << static_cast<double>(m_textures_created) / minutes << "\n";
+  }
+  out << std::flush;
+}
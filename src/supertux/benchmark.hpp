@@ -0,0 +1,138 @@
+//  SuperTux
+//  Copyright (C) 2026 SuperTux Development Team
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <memory>
+#include <ostream>
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+#include "control/controller.hpp"
+#include "util/currenton.hpp"
+
+class CodeController;
+class GameSession;
+class ScreenManager;
+
+/**
+ * Runs a level headless for a fixed number of logical steps, feeding
+ * Tux from a scripted input stream, and collects per-frame timings of
+ * the main subsystems, as well as the time the level takes to load
+ * and to restart.
+ *
+ * While a Benchmark is current, BenchmarkTimer instances placed in the
+ * game loop add their time to the frame that is being measured.
+ */
+class Benchmark final : public Currenton<Benchmark>
+{
+public:
+  enum Section
+  {
+    SECTION_SCRIPT,
+    SECTION_UPDATE,
+    SECTION_COLLISION,
+    SECTION_DRAW,
+    SECTION_RENDER,
+    SECTION_COUNT
+  };
+
+  static const char* get_section_name(Section section);
+
+private:
+  /** Controls held down for a number of consecutive steps. */
+  struct InputStep
+  {
+    int steps;
+    std::vector<Control> controls;
+  };
+
+  typedef std::array<double, SECTION_COUNT> FrameTimes;
+
+public:
+  /** 'input_filename' may be empty, in which case Tux just runs to the
+      right and jumps in regular intervals. */
+  Benchmark(const std::string& levelfile, int frames,
+            const std::string& input_filename = {});
+  ~Benchmark() override;
+
+  /** Runs the level until all frames are done or the session ends. */
+  void run(ScreenManager& screen_manager, std::unique_ptr<GameSession> session);
+
+  void add_time(Section section, std::chrono::steady_clock::duration duration);
+
+  /** Records how long GameSession::restart_level() took, the first
+      call is the initial load of the level. */
+  void add_level_load(std::chrono::steady_clock::duration duration);
+
+  void print_report(std::ostream& out) const;
+
+private:
+  void load_input(const std::string& filename);
+  void apply_input(GameSession& session);
+
+private:
+  const std::string m_levelfile;
+  const int m_frames;
+
+  std::unique_ptr<CodeController> m_controller;
+  std::vector<InputStep> m_input;
+  size_t m_input_pos;
+  int m_input_step;
+
+  FrameTimes m_current_frame;
+  std::vector<FrameTimes> m_frame_times;
+  std::vector<double> m_total_times;
+  std::vector<double> m_level_loads;
+  int64_t m_total_requests;
+  int64_t m_total_draw_calls;
+  int m_textures_created;
+
+private:
+  Benchmark(const Benchmark&) = delete;
+  Benchmark& operator=(const Benchmark&) = delete;
+};
+
+/** Adds the time between construction and destruction to the given
+    section of the current Benchmark. Does nothing when not benchmarking. */
+class BenchmarkTimer final
+{
+public:
+  BenchmarkTimer(Benchmark::Section section) :
+    m_benchmark(Benchmark::current()),
+    m_section(section),
+    m_start(m_benchmark ? std::chrono::steady_clock::now() : std::chrono::steady_clock::time_point())
+  {
+  }
+
+  ~BenchmarkTimer()
+  {
+    if (m_benchmark)
+      m_benchmark->add_time(m_section, std::chrono::steady_clock::now() - m_start);
+  }
+
+private:
+  Benchmark* const m_benchmark;
+  const Benchmark::Section m_section;
+  const std::chrono::steady_clock::time_point m_start;
+
+private:
+  BenchmarkTimer(const BenchmarkTimer&) = delete;
+  BenchmarkTimer& operator=(const BenchmarkTimer&) = delete;
+};
@@ -50,7 +50,10 @@ CommandLineArguments::CommandLineArguments() :
   christmas_mode(),
   repository_url(),
   editor(),
-  resave()
+  resave(),
+  benchmark(),
+  benchmark_frames(),
+  benchmark_input()
 {
 }
 
@@ -123,6 +126,11 @@ CommandLineArguments::print_help(const char* arg0) const
     << _("  --sector SECTOR              Spawn Tux in SECTOR\n") << "\n"
     << _("  --spawnpoint SPAWNPOINT      Spawn Tux at SPAWNPOINT\n") << "\n"
     << "\n"
+    << _("Benchmark Options:") << "\n"
+    << _("  --benchmark LEVELFILE        Run the level headless and print frame timings") << "\n"
+    << _("  --frames N                   Number of frames to benchmark (default: 3600)") << "\n"
+    << _("  --benchmark-input FILE       Read Tux's input for the benchmark from FILE") << "\n"
+    << "\n"
     << _("Directory Options:") << "\n"
     << _("  --datadir DIR                Set the directory for the games datafiles") << "\n"
     << _("  --userdir DIR                Set the directory for user data (savegames, etc.)") << "\n"
@@ -367,6 +375,43 @@ CommandLineArguments::parse_args(int argc, char** argv)
     {
       resave = true;
     }
+    else if (arg == "--benchmark")
+    {
+      if (i + 1 >= argc)
+      {
+        throw std::runtime_error("Need to specify a level for --benchmark");
+      }
+      else
+      {
+        benchmark = true;
+        filenames.push_back(argv[++i]);
+      }
+    }
+    else if (arg == "--frames")
+    {
+      if (i + 1 >= argc)
+      {
+        throw std::runtime_error("Need to specify a number of frames for --frames");
+      }
+      else
+      {
+        int frames;
+        if (sscanf(argv[++i], "%9d", &frames) != 1 || frames <= 0)
+          throw std::runtime_error("Invalid number of frames, should be a positive integer");
+        benchmark_frames = frames;
+      }
+    }
+    else if (arg == "--benchmark-input")
+    {
+      if (i + 1 >= argc)
+      {
+        throw std::runtime_error("Need to specify a file for --benchmark-input");
+      }
+      else
+      {
+        benchmark_input = argv[++i];
+      }
+    }
     else if (arg[0] != '-')
     {
       filenames.push_back(arg);
@@ -381,6 +426,10 @@ CommandLineArguments::parse_args(int argc, char** argv)
   if (filenames.size() > 1 && !(resave && *resave)) {
     throw std::runtime_error("Only one filename allowed for the given options");
   }
+
+  if ((benchmark_frames || benchmark_input) && !benchmark) {
+    throw std::runtime_error("--frames and --benchmark-input require --benchmark");
+  }
 }
 
 void
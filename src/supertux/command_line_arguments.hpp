@@ -79,6 +79,10 @@ public:
   std::optional<bool> editor;
   std::optional<bool> resave;
 
+  std::optional<bool> benchmark;
+  std::optional<int> benchmark_frames;
+  std::optional<std::string> benchmark_input;
+
   // std::optional<std::string> locale;
 
 public:
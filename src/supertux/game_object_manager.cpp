@@ -50,6 +50,7 @@ GameObjectManager::GameObjectManager(bool undo_tracking) :
   m_moved_object_uids(),
   m_solid_tilemaps(),
   m_all_tilemaps(),
+  m_solid_tile_attributes(),
   m_objects_by_name(),
   m_objects_by_uid(),
   m_objects_by_type_index(),
@@ -319,6 +320,21 @@ GameObjectManager::update_solid(TileMap* tm) {
   }
 }
 
+const TileAttributeGrid&
+GameObjectManager::get_solid_tile_attributes() const
+{
+  if (!m_solid_tile_attributes.is_up_to_date(m_solid_tilemaps))
+    m_solid_tile_attributes.rebuild(m_solid_tilemaps);
+
+  return m_solid_tile_attributes;
+}
+
+void
+GameObjectManager::update_solid_tile(const TileMap& tilemap, int x, int y)
+{
+  m_solid_tile_attributes.update_tile(tilemap, x, y);
+}
+
 void
 GameObjectManager::update_tilemaps()
 {
@@ -28,6 +28,7 @@
 
 #include "supertux/game_object.hpp"
 #include "supertux/game_object_change.hpp"
+#include "supertux/tile_attribute_grid.hpp"
 #include "util/uid_generator.hpp"
 
 class DrawingContext;
@@ -257,6 +258,13 @@ public:
 
   void update_solid(TileMap* solid);
 
+  /** Returns the merged tile attributes of all static solid tilemaps,
+      rebuilding them first if the tilemaps changed. */
+  const TileAttributeGrid& get_solid_tile_attributes() const;
+
+  /** Called by TileMap::change() to keep the merged tile attributes in sync. */
+  void update_solid_tile(const TileMap& tilemap, int x, int y);
+
   /** Toggle object change tracking for undo/redo. */
   void toggle_undo_tracking(bool enabled);
   inline bool undo_tracking_enabled() const { return m_undo_tracking; }
@@ -364,6 +372,9 @@ private:
   /** Fast access to all tilemaps */
   std::vector<TileMap*> m_all_tilemaps;
 
+  /** Merged attributes of the solid tilemaps, lazily rebuilt */
+  mutable TileAttributeGrid m_solid_tile_attributes;
+
   std::unordered_map<std::string, GameObject*> m_objects_by_name;
   std::unordered_map<UID, GameObject*> m_objects_by_uid;
   std::unordered_map<std::type_index, std::vector<GameObject*> > m_objects_by_type_index;
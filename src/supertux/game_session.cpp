@@ -17,6 +17,7 @@
 #include "supertux/game_session.hpp"
 
 #include <cfloat>
+#include <chrono>
 #include <fmt/format.h>
 #include <stdexcept>
 
@@ -35,10 +36,12 @@
 #include "object/textscroller.hpp"
 #include "sdk/integration.hpp"
 #include "squirrel/squirrel_virtual_machine.hpp"
+#include "supertux/benchmark.hpp"
 #include "supertux/constants.hpp"
 #include "supertux/fadetoblack.hpp"
 #include "supertux/gameconfig.hpp"
 #include "supertux/level.hpp"
+#include "supertux/level_cache.hpp"
 #include "supertux/level_parser.hpp"
 #include "supertux/levelintro.hpp"
 #include "supertux/levelset_screen.hpp"
@@ -48,6 +51,7 @@
 #include "supertux/sector.hpp"
 #include "supertux/shrinkfade.hpp"
 #include "util/file_system.hpp"
+#include "util/reader_document.hpp"
 #include "video/compositor.hpp"
 #include "video/drawing_context.hpp"
 #include "video/surface.hpp"
@@ -70,6 +74,7 @@ GameSession::GameSession(const std::string& levelfile_, Savegame& savegame, Stat
   m_game_pause(false),
   m_speed_before_pause(ScreenManager::current()->get_speed()),
   m_levelfile(levelfile_),
+  m_level_document(),
   m_spawnpoints(),
   m_activated_checkpoint(),
   m_newsector(),
@@ -98,6 +103,10 @@ GameSession::GameSession(const std::string& levelfile_, Savegame& savegame, Stat
   m_data_table.clear();
 }
 
+GameSession::~GameSession()
+{
+}
+
 void
 GameSession::reset_level()
 {
@@ -159,6 +168,8 @@ GameSession::on_player_removed(int id)
 void
 GameSession::restart_level(bool after_death, bool preserve_music)
 {
+  const auto load_start = std::chrono::steady_clock::now();
+
   const PlayerStatus& currentStatus = m_savegame.get_player_status();
   m_coins_at_start = currentStatus.coins;
   m_boni_at_start = currentStatus.bonus;
@@ -194,7 +205,15 @@ GameSession::restart_level(bool after_death, bool preserve_music)
   }
 
   try {
-    m_level = LevelParser::from_file(m_levelfile, false, false);
+    // Images and scripts stay loaded between tries, so only the first
+    // one has to prefetch them.
+    const bool first_try = !m_level_document;
+    if (first_try)
+      m_level_document = std::make_unique<ReaderDocument>(LevelCache::load(m_levelfile));
+
+    // Statistics need the totals of every sector, once the previous try
+    // has counted them, sectors are only created when Tux gets there.
+    m_level = LevelParser::from_document(*m_level_document, false, false, m_level.get(), first_try);
 
     /* Determine the spawnpoint to spawn/respawn Tux to. */
     const GameSession::SpawnPoint* spawnpoint = nullptr;
@@ -281,6 +300,9 @@ GameSession::restart_level(bool after_death, bool preserve_music)
   {
     level_time.set_time(level_time.get_time() - m_play_time);
   }
+
+  if (Benchmark* benchmark = Benchmark::current())
+    benchmark->add_level_load(std::chrono::steady_clock::now() - load_start);
 }
 
 void
@@ -41,6 +41,7 @@ class DrawingContext;
 class EndSequence;
 class Level;
 class Player;
+class ReaderDocument;
 class Sector;
 class Statistics;
 class Savegame;
@@ -78,6 +79,7 @@ private:
 
 public:
   GameSession(const std::string& levelfile, Savegame& savegame, Statistics* statistics = nullptr);
+  ~GameSession() override;
 
   virtual void draw(Compositor& compositor) override;
   virtual void update(float dt_sec, const Controller& controller) override;
@@ -98,6 +100,9 @@ public:
   void on_player_added(int id);
   bool on_player_removed(int id);
 
+  /** Start the level right away, without showing the LevelIntro screen. */
+  inline void skip_level_intro() { m_levelintro_shown = true; }
+
   void set_start_point(const std::string& sector, const std::string& spawnpoint);
   void set_start_pos(const std::string& sector, const Vector& pos);
   inline void set_respawn_point(const std::string& sector, const std::string& spawnpoint)
@@ -170,6 +175,10 @@ private:
 
   std::string m_levelfile;
 
+  /** The parsed level file, kept so that restarts only have to
+      recreate the objects. */
+  std::unique_ptr<ReaderDocument> m_level_document;
+
   // Spawnpoints
   std::vector<SpawnPoint> m_spawnpoints;
   const SpawnPoint* m_activated_checkpoint;
@@ -58,14 +58,17 @@ Config::Config() :
   show_fps(false),
   show_player_pos(false),
   show_controller(false),
+  show_script_timings(false),
   camera_peek_multiplier(0.03f),
   sound_enabled(true),
   music_enabled(true),
   sound_volume(100),
   music_volume(50),
+  sound_buffer_budget(64),
   flash_intensity(50),
   random_seed(0), // Set by time(), by default (unless in config).
   enable_script_debugger(false),
+  script_budget(0.0f),
   tux_spawn_pos(),
   locale(),
   keyboard_config(),
@@ -148,6 +151,8 @@ Config::load()
   config_mapping.get("show_fps", show_fps);
   config_mapping.get("show_player_pos", show_player_pos);
   config_mapping.get("show_controller", show_controller);
+  config_mapping.get("show_script_timings", show_script_timings);
+  config_mapping.get("script_budget", script_budget);
   config_mapping.get("camera_peek_multiplier", camera_peek_multiplier);
   config_mapping.get("developer", developer_mode);
   config_mapping.get("confirmation_dialog", confirmation_dialog);
@@ -306,6 +311,7 @@ Config::load()
     config_audio_mapping->get("music_enabled", music_enabled);
     config_audio_mapping->get("sound_volume", sound_volume);
     config_audio_mapping->get("music_volume", music_volume);
+    config_audio_mapping->get("sound_buffer_budget", sound_buffer_budget);
   }
 
   std::optional<ReaderMapping> config_control_mapping;
@@ -370,6 +376,8 @@ Config::save()
   writer.write("show_fps", show_fps);
   writer.write("show_player_pos", show_player_pos);
   writer.write("show_controller", show_controller);
+  writer.write("show_script_timings", show_script_timings);
+  writer.write("script_budget", script_budget);
   writer.write("camera_peek_multiplier", camera_peek_multiplier);
   writer.write("developer", developer_mode);
   writer.write("confirmation_dialog", confirmation_dialog);
@@ -464,6 +472,7 @@ Config::save()
   writer.write("music_enabled", music_enabled);
   writer.write("sound_volume", sound_volume);
   writer.write("music_volume", music_volume);
+  writer.write("sound_buffer_budget", sound_buffer_budget);
   writer.end_list("audio");
 
   writer.start_list("control");
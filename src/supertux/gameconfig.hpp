@@ -72,11 +72,14 @@ public:
   bool show_fps;
   bool show_player_pos;
   bool show_controller;
+  bool show_script_timings;
   float camera_peek_multiplier;
   bool sound_enabled;
   bool music_enabled;
   int sound_volume;
   int music_volume;
+  /** How many megabytes of decoded sounds may stay loaded. */
+  int sound_buffer_budget;
   int flash_intensity;
 
   /** initial random seed.  0 ==> set from time() */
@@ -84,6 +87,10 @@ public:
 
   bool enable_script_debugger;
 
+  /** Milliseconds per frame scheduled scripts may run for, scripts
+      that exceed it on their own are stopped. 0 disables the budget. */
+  float script_budget;
+
   /** this variable is set if tux should spawn somewhere which isn't the "main" spawn point*/
   std::optional<Vector> tux_spawn_pos;
 
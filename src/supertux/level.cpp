@@ -16,7 +16,7 @@
 
 #include "supertux/level.hpp"
 
-#include <numeric>
+#include <algorithm>
 
 #include <physfs.h>
 
@@ -27,9 +27,11 @@
 #include "supertux/player_status_hud.hpp"
 #include "supertux/savegame.hpp"
 #include "supertux/sector.hpp"
+#include "supertux/sector_parser.hpp"
 #include "trigger/secretarea_trigger.hpp"
 #include "util/file_system.hpp"
 #include "util/log.hpp"
+#include "util/reader_mapping.hpp"
 #include "util/string_util.hpp"
 #include "util/writer.hpp"
 
@@ -54,7 +56,10 @@ Level::Level(bool worldmap) :
   m_skip_cutscene(false),
   m_icon(),
   m_icon_locked(),
-  m_wmselect_bkg()
+  m_wmselect_bkg(),
+  m_lazy_sectors(),
+  m_sector_totals(),
+  m_hud_player_status()
 {
   s_current = this;
 
@@ -75,6 +80,9 @@ Level::initialize()
   if (m_sectors.empty())
     throw std::runtime_error("Level has no sectors!");
 
+  for (const auto& sector : m_sectors)
+    m_sector_totals[sector->get_name()] = count_totals(*sector);
+
   m_stats.init(*this);
 
   Savegame* savegame = (GameSession::current() && !Editor::is_active() ?
@@ -87,6 +95,7 @@ Level::initialize()
   if ((!savegame || !savegame->is_title_screen()) &&
       !m_suppress_pause_menu && !Editor::is_active())
   {
+    m_hud_player_status = &player_status;
     for (auto& sector : m_sectors)
       sector->add<PlayerStatusHUD>(player_status);
   }
@@ -262,68 +271,133 @@ Level::get_setting_from_name(const std::string& setting)
 void
 Level::add_sector(std::unique_ptr<Sector> sector)
 {
-  Sector* test = get_sector(sector->get_name());
-  if (test != nullptr) {
+  if (has_sector(sector->get_name())) {
     throw std::runtime_error("Trying to add 2 sectors with same name");
   } else {
     m_sectors.push_back(std::move(sector));
   }
 }
 
+void
+Level::add_lazy_sector(const std::string& name, const ReaderMapping& reader, const SectorTotals& totals)
+{
+  if (has_sector(name))
+    throw std::runtime_error("Trying to add 2 sectors with same name");
+
+  m_lazy_sectors.push_back({ name, &reader.get_doc(), &reader.get_sexp(), get_sector_count() });
+  m_sector_totals[name] = totals;
+}
+
+bool
+Level::has_sector(const std::string& name) const
+{
+  return std::any_of(m_sectors.begin(), m_sectors.end(), [&name] (const std::unique_ptr<Sector>& sector) {
+           return sector->get_name() == name;
+         }) ||
+         std::any_of(m_lazy_sectors.begin(), m_lazy_sectors.end(), [&name] (const LazySector& sector) {
+           return sector.name == name;
+         });
+}
+
 Sector*
-Level::get_sector(const std::string& name_) const
+Level::create_lazy_sector(size_t index)
+{
+  const LazySector lazy = m_lazy_sectors.at(index);
+  m_lazy_sectors.erase(m_lazy_sectors.begin() + index);
+
+  auto sector = SectorParser::from_reader(*this, ReaderMapping(*lazy.doc, *lazy.sx), false);
+  if (m_hud_player_status)
+    sector->add<PlayerStatusHUD>(*m_hud_player_status);
+
+  // m_lazy_sectors is in file order, so 'index' of the sectors before
+  // this one are still lazy and the others are in m_sectors already.
+  return m_sectors.insert(m_sectors.begin() + (lazy.position - index), std::move(sector))->get();
+}
+
+Sector*
+Level::get_sector(const std::string& name_)
 {
   auto _sector = std::find_if(m_sectors.begin(), m_sectors.end(), [name_] (const std::unique_ptr<Sector>& sector) {
     return sector->get_name() == name_;
   });
-  if(_sector == m_sectors.end())
-    return nullptr;
-  return _sector->get();
+  if (_sector != m_sectors.end())
+    return _sector->get();
+
+  for (size_t i = 0; i < m_lazy_sectors.size(); ++i)
+  {
+    if (m_lazy_sectors[i].name == name_)
+      return create_lazy_sector(i);
+  }
+  return nullptr;
 }
 
 size_t
 Level::get_sector_count() const
 {
-  return m_sectors.size();
+  return m_sectors.size() + m_lazy_sectors.size();
 }
 
 Sector*
-Level::get_sector(size_t num) const
+Level::get_sector(size_t num)
+{
+  size_t created = num;
+  for (size_t i = 0; i < m_lazy_sectors.size() && m_lazy_sectors[i].position <= num; ++i)
+  {
+    if (m_lazy_sectors[i].position == num)
+      return create_lazy_sector(i);
+    created -= 1;
+  }
+
+  return m_sectors.at(created).get();
+}
+
+Level::SectorTotals
+Level::count_totals(const Sector& sector)
 {
-  return m_sectors.at(num).get();
+  SectorTotals totals;
+  for (const auto& obj : sector.get_objects())
+    totals.coins += obj->get_coins_worth();
+
+  totals.badguys = sector.get_object_count<BadGuy>([] (const BadGuy& badguy) {
+    return badguy.m_countMe;
+  });
+  totals.secrets = sector.get_object_count<SecretAreaTrigger>();
+  return totals;
+}
+
+Level::SectorTotals
+Level::get_totals() const
+{
+  SectorTotals totals;
+  const auto add = [&totals](const SectorTotals& sector) {
+    totals.coins += sector.coins;
+    totals.badguys += sector.badguys;
+    totals.secrets += sector.secrets;
+  };
+
+  for (const auto& sector : m_sectors)
+    add(count_totals(*sector));
+  for (const auto& sector : m_lazy_sectors)
+    add(m_sector_totals.at(sector.name));
+  return totals;
 }
 
 int
 Level::get_total_coins() const
 {
-  int total_coins = 0;
-  for (auto const& sector : m_sectors)
-  {
-    for (const auto& obj : sector->get_objects())
-      total_coins += obj->get_coins_worth();
-  }
-  return total_coins;
+  return get_totals().coins;
 }
 
 int
 Level::get_total_badguys() const
 {
-  int total_badguys = 0;
-  for (auto const& sector : m_sectors) {
-    total_badguys += sector->get_object_count<BadGuy>([] (const BadGuy& badguy) {
-      return badguy.m_countMe;
-    });
-  }
-  return total_badguys;
+  return get_totals().badguys;
 }
 
 int
 Level::get_total_secrets() const
 {
-  auto get_secret_count = [](int accumulator, const std::unique_ptr<Sector>& sector) {
-    return accumulator + sector->get_object_count<SecretAreaTrigger>();
-  };
-  return std::accumulate(m_sectors.begin(), m_sectors.end(), 0, get_secret_count);
+  return get_totals().secrets;
 }
 
 std::vector<Player*>
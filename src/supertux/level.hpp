@@ -16,10 +16,17 @@
 
 #pragma once
 
+#include <unordered_map>
+
 #include "supertux/statistics.hpp"
 
+namespace sexp {
+class Value;
+} // namespace sexp
+
 class Player;
 class PlayerStatus;
+class ReaderDocument;
 class ReaderMapping;
 class Sector;
 class Writer;
@@ -37,6 +44,17 @@ public:
 private:
   static Level* s_current;
 
+public:
+  /** What a sector adds to the level statistics, as counted when the
+      sector got created. */
+  struct SectorTotals
+  {
+    int coins = 0;
+    int badguys = 0;
+    int secrets = 0;
+  };
+  using SectorTotalsMap = std::unordered_map<std::string, SectorTotals>;
+
 public:
   explicit Level(bool m_is_worldmap);
   ~Level();
@@ -46,15 +64,29 @@ public:
   void save(std::ostream& stream);
 
   void add_sector(std::unique_ptr<Sector> sector);
+
+  /** Adds a sector that only gets created from 'reader' once it is
+      asked for, 'totals' stand in for it in the statistics until then.
+      The document of 'reader' has to outlive the level. */
+  void add_lazy_sector(const std::string& name, const ReaderMapping& reader, const SectorTotals& totals);
   inline const std::string& get_name() const { return m_name; }
   inline const std::string& get_author() const { return m_author; }
 
-  Sector* get_sector(const std::string& name) const;
+  /** Creates the sector first if it was added lazily. */
+  Sector* get_sector(const std::string& name);
 
   size_t get_sector_count() const;
-  Sector* get_sector(size_t num) const;
+  /** Sectors are numbered in the order of the level file, lazily
+      added ones included. Creates the sector first if it was added
+      lazily. */
+  Sector* get_sector(size_t num);
+  /** Only the sectors that have been created so far. */
   inline const std::vector<std::unique_ptr<Sector>>& get_sectors() const { return m_sectors; }
 
+  /** Totals of every sector of the level, to create the level again
+      with LevelParser::from_document() without creating all sectors. */
+  inline const SectorTotalsMap& get_sector_totals() const { return m_sector_totals; }
+
   std::vector<Player*> get_players() const;
 
   inline const std::string& get_tileset() const { return m_tileset; }
@@ -69,9 +101,26 @@ public:
 
   inline const std::string& get_license() const { return m_license; }
 
+private:
+  struct LazySector
+  {
+    std::string name;
+    const ReaderDocument* doc;
+    const sexp::Value* sx;
+
+    /** Index of the sector in the level file. */
+    size_t position;
+  };
+
 private:
   void initialize();
 
+  bool has_sector(const std::string& name) const;
+  Sector* create_lazy_sector(size_t index);
+
+  static SectorTotals count_totals(const Sector& sector);
+  SectorTotals get_totals() const;
+
   void save(Writer& writer);
   void load_old_format(const ReaderMapping& reader);
 
@@ -113,6 +162,14 @@ public:
   std::string m_icon_locked;
   std::string m_wmselect_bkg;
 
+private:
+  /** Sectors that have not been created yet, see add_lazy_sector(). */
+  std::vector<LazySector> m_lazy_sectors;
+  SectorTotalsMap m_sector_totals;
+
+  /** Status the HUD of the sectors shows, nullptr if they have none. */
+  PlayerStatus* m_hud_player_status;
+
 private:
   Level(const Level&) = delete;
   Level& operator=(const Level&) = delete;
@@ -0,0 +1,210 @@
+//  SuperTux
+//  Copyright (C) 2026 SuperTux Development Team
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#include "supertux/level_cache.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <physfs.h>
+#include <sstream>
+#include <stdexcept>
+#include <stdint.h>
+#include <stdio.h>
+#include <vector>
+#include <version.h>
+
+#include "physfs/ifile_stream.hpp"
+#include "physfs/ofile_stream.hpp"
+#include "physfs/util.hpp"
+#include "supertux/gameconfig.hpp"
+#include "supertux/globals.hpp"
+#include "util/binary_sexp.hpp"
+#include "util/file_system.hpp"
+#include "util/log.hpp"
+#include "util/reader_document.hpp"
+
+namespace {
+
+const char* s_cache_directory = "cache/levels";
+const char* s_version_filename = "cache/levels/version";
+
+/** Around a hundred levels of the size of the bundled ones. */
+const PHYSFS_sint64 s_max_cache_size = 32 * 1024 * 1024;
+
+std::string
+read_file(const std::string& filename)
+{
+  IFileStream in(filename);
+  if (!in.good())
+    throw std::runtime_error("Parser problem: Couldn't open file '" + filename + "'.");
+
+  std::ostringstream content;
+  content << in.rdbuf();
+  return content.str();
+}
+
+} // namespace
+
+ReaderDocument
+LevelCache::load(const std::string& filename)
+{
+  const std::string content = read_file(filename);
+
+  // Levels in the user directory are most likely being worked on, and
+  // the binary form has no line numbers for error messages.
+  const char* realdir = PHYSFS_getRealDir(filename.c_str());
+  const char* writedir = PHYSFS_getWriteDir();
+  if (g_config->developer_mode ||
+      (realdir && writedir && strcmp(realdir, writedir) == 0))
+  {
+    return ReaderDocument::from_level_string(content, filename);
+  }
+
+  check_version();
+
+  const std::string cache_filename = get_cache_filename(content);
+  if (PHYSFS_exists(cache_filename.c_str()))
+  {
+    try
+    {
+      std::vector<std::vector<int>> integer_arrays;
+      sexp::Value sx = BinarySexp::read(read_file(cache_filename), integer_arrays);
+      return ReaderDocument(filename, std::move(sx), std::move(integer_arrays));
+    }
+    catch (const std::exception& err)
+    {
+      log_warning << "Couldn't read level cache '" << cache_filename << "': " << err.what() << std::endl;
+    }
+  }
+
+  auto doc = ReaderDocument::from_level_string(content, filename);
+  try
+  {
+    const std::string data = BinarySexp::write(doc.get_sexp(), doc.get_integer_arrays());
+    PHYSFS_mkdir(s_cache_directory);
+    {
+      OFileStream out(cache_filename);
+      out.write(data.data(), static_cast<std::streamsize>(data.size()));
+    }
+    prune();
+  }
+  catch (const std::exception& err)
+  {
+    log_warning << "Couldn't write level cache '" << cache_filename << "': " << err.what() << std::endl;
+  }
+  return doc;
+}
+
+std::string
+LevelCache::get_cache_filename(const std::string& content)
+{
+  // 64 bit FNV-1a
+  uint64_t hash = 14695981039346656037ULL;
+  const auto add = [&hash](const std::string& str) {
+    for (const char c : str)
+    {
+      hash ^= static_cast<unsigned char>(c);
+      hash *= 1099511628211ULL;
+    }
+  };
+  add(content);
+  add(PACKAGE_VERSION);
+
+  char name[32];
+  snprintf(name, sizeof(name), "%016llx.stlc", static_cast<unsigned long long>(hash));
+  return FileSystem::join(s_cache_directory, name);
+}
+
+void
+LevelCache::check_version()
+{
+  static bool s_checked = false;
+  if (s_checked)
+    return;
+  s_checked = true;
+
+  std::string version;
+  if (PHYSFS_exists(s_version_filename))
+  {
+    try
+    {
+      version = read_file(s_version_filename);
+    }
+    catch (const std::exception& err)
+    {
+      log_warning << "Couldn't read level cache version: " << err.what() << std::endl;
+    }
+  }
+
+  if (version == PACKAGE_VERSION)
+    return;
+
+  try
+  {
+    physfsutil::remove_content(s_cache_directory);
+    PHYSFS_mkdir(s_cache_directory);
+    OFileStream out(s_version_filename);
+    out << PACKAGE_VERSION;
+  }
+  catch (const std::exception& err)
+  {
+    log_warning << "Couldn't reset level cache: " << err.what() << std::endl;
+  }
+}
+
+void
+LevelCache::prune()
+{
+  struct CacheFile
+  {
+    std::string filename;
+    PHYSFS_sint64 size;
+    PHYSFS_sint64 modtime;
+  };
+
+  std::vector<CacheFile> files;
+  PHYSFS_sint64 total_size = 0;
+  physfsutil::enumerate_files(s_cache_directory, [&files, &total_size](const std::string& name) {
+    const std::string filename = FileSystem::join(s_cache_directory, name);
+    PHYSFS_Stat stat;
+    if (FileSystem::extension(name) == ".stlc" && PHYSFS_stat(filename.c_str(), &stat))
+    {
+      files.push_back({ filename, stat.filesize, stat.modtime });
+      total_size += stat.filesize;
+    }
+    return false;
+  });
+
+  if (total_size <= s_max_cache_size)
+    return;
+
+  std::sort(files.begin(), files.end(), [](const CacheFile& lhs, const CacheFile& rhs) {
+    return lhs.modtime < rhs.modtime;
+  });
+
+  for (const auto& file : files)
+  {
+    if (total_size <= s_max_cache_size)
+      break;
+
+    if (PHYSFS_delete(file.filename.c_str()) == 0)
+    {
+      log_warning << "Couldn't delete level cache '" << file.filename << "': " << physfsutil::get_last_error() << std::endl;
+      break;
+    }
+    total_size -= file.size;
+  }
+}
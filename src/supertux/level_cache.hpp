@@ -0,0 +1,47 @@
+//  SuperTux
+//  Copyright (C) 2026 SuperTux Development Team
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#pragma once
+
+#include <string>
+
+class ReaderDocument;
+
+/** Keeps parsed level files in the user directory in the binary form
+    of BinarySexp, which loads a lot faster than the text. Cache files
+    are named after a hash of the level content and the engine
+    version, edited levels and new releases get new entries. The cache
+    is emptied when the version changes, and the oldest entries go once
+    it grows past a size limit. */
+class LevelCache final
+{
+public:
+  /** Returns the parsed level file 'filename', from the cache if it
+      has an entry for it and adding one otherwise. */
+  static ReaderDocument load(const std::string& filename);
+
+private:
+  static std::string get_cache_filename(const std::string& content);
+
+  /** Empties the cache if it was written by another version. */
+  static void check_version();
+
+  /** Deletes the oldest entries until the cache is below its size limit. */
+  static void prune();
+
+private:
+  LevelCache() = delete;
+};
@@ -17,16 +17,105 @@
 #include "supertux/level_parser.hpp"
 
 #include <physfs.h>
+#include <sexp/value.hpp>
 #include <sstream>
+#include <unordered_map>
 
+#include "sprite/sprite_manager.hpp"
+#include "squirrel/squirrel_virtual_machine.hpp"
 #include "supertux/constants.hpp"
 #include "supertux/level.hpp"
+#include "supertux/level_cache.hpp"
 #include "supertux/sector.hpp"
 #include "supertux/sector_parser.hpp"
+#include "util/file_system.hpp"
 #include "util/log.hpp"
 #include "util/reader.hpp"
 #include "util/reader_document.hpp"
 #include "util/reader_mapping.hpp"
+#include "util/string_util.hpp"
+#include "video/texture_manager.hpp"
+
+namespace {
+
+void collect_images(const sexp::Value& sx, std::vector<std::string>& images)
+{
+  if (sx.is_array())
+  {
+    for (const auto& item : sx.as_array())
+      collect_images(item, images);
+  }
+  else if (sx.is_string())
+  {
+    const std::string& str = sx.as_string();
+    if (StringUtil::has_suffix(str, ".png") || StringUtil::has_suffix(str, ".jpg"))
+      images.push_back(str);
+  }
+}
+
+void collect_sprites(const sexp::Value& sx, std::vector<std::string>& sprites)
+{
+  if (sx.is_array())
+  {
+    for (const auto& item : sx.as_array())
+      collect_sprites(item, sprites);
+  }
+  else if (sx.is_string() && StringUtil::has_suffix(sx.as_string(), ".sprite"))
+  {
+    sprites.push_back(sx.as_string());
+  }
+}
+
+/** Returns 'filename' as given if it exists, relative to 'directory'
+    otherwise. */
+std::string resolve_path(const std::string& directory, const std::string& filename)
+{
+  if (PHYSFS_exists(filename.c_str()))
+    return filename;
+  return FileSystem::join(directory, filename);
+}
+
+/** Source names objects run their "script" property with, where it
+    isn't the property key. */
+const std::unordered_map<std::string, std::string> s_script_sourcenames = {
+  { "bonusblock", "BonusBlockScript" },
+  { "door", "Door" },
+  { "ispy", "Ispy" },
+  { "pushbutton", "PushButton" },
+  { "scripttrigger", "ScriptTrigger" },
+  { "secretarea", "SecretAreaScript" }
+};
+
+/** Collects the values of all '(*script "...")' properties, along with
+    the source name they get run with, which is mostly their key.
+    'object' is the name of the enclosing object. */
+void collect_scripts(const sexp::Value& sx, const std::string& object,
+                     std::vector<std::pair<std::string, std::string>>& scripts)
+{
+  if (!sx.is_array())
+    return;
+
+  const auto& items = sx.as_array();
+  if (items.size() == 2 && items[0].is_symbol() && items[1].is_string() &&
+      StringUtil::has_suffix(items[0].as_string(), "script"))
+  {
+    if (!items[1].as_string().empty())
+    {
+      auto it = s_script_sourcenames.find(object);
+      if (items[0].as_string() == "script" && it != s_script_sourcenames.end())
+        scripts.emplace_back(it->second, items[1].as_string());
+      else
+        scripts.emplace_back(items[0].as_string(), items[1].as_string());
+    }
+    return;
+  }
+
+  const std::string& name = (!items.empty() && items[0].is_symbol()) ? items[0].as_string() : object;
+  for (const auto& item : items)
+    collect_scripts(item, name, scripts);
+}
+
+} // namespace
 
 std::string
 LevelParser::get_level_name(const std::string& filename)
@@ -72,6 +161,19 @@ LevelParser::from_file(const std::string& filename, bool worldmap, bool editable
   return level;
 }
 
+std::unique_ptr<Level>
+LevelParser::from_document(const ReaderDocument& doc, bool worldmap, bool editable,
+                           const Level* previous, bool prefetch)
+{
+  auto level = std::make_unique<Level>(worldmap);
+  LevelParser parser(*level, worldmap, editable);
+  if (!worldmap && !editable)
+    parser.m_previous = previous;
+  parser.m_prefetch = prefetch;
+  parser.load_document(doc);
+  return level;
+}
+
 std::unique_ptr<Level>
 LevelParser::from_nothing(const std::string& basedir)
 {
@@ -118,7 +220,9 @@ LevelParser::from_nothing_worldmap(const std::string& basedir, const std::string
 LevelParser::LevelParser(Level& level, bool worldmap, bool editable) :
   m_level(level),
   m_worldmap(worldmap),
-  m_editable(editable)
+  m_editable(editable),
+  m_previous(),
+  m_prefetch(true)
 {
 }
 
@@ -135,7 +239,7 @@ LevelParser::load(const std::string& filepath)
   m_level.m_filename = filepath;
   register_translation_directory(filepath);
   try {
-    auto doc = ReaderDocument::from_file(filepath);
+    auto doc = LevelCache::load(filepath);
     load(doc);
   } catch(std::exception& e) {
     std::stringstream msg;
@@ -144,6 +248,14 @@ LevelParser::load(const std::string& filepath)
   }
 }
 
+void
+LevelParser::load_document(const ReaderDocument& doc)
+{
+  m_level.m_filename = doc.get_filename();
+  register_translation_directory(m_level.m_filename);
+  load(doc);
+}
+
 void
 LevelParser::load(const ReaderDocument& doc)
 {
@@ -152,6 +264,12 @@ LevelParser::load(const ReaderDocument& doc)
   if (root.get_name() != "supertux-level")
     throw std::runtime_error("file is not a supertux-level file.");
 
+  if (m_prefetch)
+  {
+    prefetch_images(doc);
+    precompile_scripts(doc);
+  }
+
   auto level = root.get_mapping();
 
   int version = 1;
@@ -189,7 +307,22 @@ LevelParser::load(const ReaderDocument& doc)
     {
       if (iter.get_key() == "sector")
       {
-        auto sector = SectorParser::from_reader(m_level, iter.as_mapping(), m_editable);
+        auto reader = iter.as_mapping();
+
+        // The first sector always gets created, the players start out in it.
+        std::string name;
+        if (m_previous && !m_level.m_sectors.empty() && reader.get("name", name))
+        {
+          const auto& sector_totals = m_previous->get_sector_totals();
+          auto totals = sector_totals.find(name);
+          if (totals != sector_totals.end())
+          {
+            m_level.add_lazy_sector(name, reader, totals->second);
+            continue;
+          }
+        }
+
+        auto sector = SectorParser::from_reader(m_level, reader, m_editable);
         m_level.add_sector(std::move(sector));
       }
     }
@@ -231,3 +364,44 @@ LevelParser::create(const std::string& filepath, const std::string& levelname)
   sector->set_name(DEFAULT_SECTOR_NAME);
   m_level.add_sector(std::move(sector));
 }
+
+void
+LevelParser::prefetch_images(const ReaderDocument& doc)
+{
+  TextureManager* texture_manager = TextureManager::current();
+  if (!texture_manager)
+    return;
+
+  std::vector<std::string> images;
+  collect_images(doc.get_sexp(), images);
+
+  // Backgrounds and the like are mostly given relative to the data
+  // directory, but add-on levels may also refer to their own images.
+  const std::string directory = doc.get_directory();
+  for (auto& image : images)
+    image = resolve_path(directory, image);
+
+  texture_manager->prefetch(images);
+
+  // Objects given a custom sprite name the sprite file. The default
+  // sprites of objects aren't named in the level and are left to load
+  // when the objects get created.
+  if (SpriteManager* sprite_manager = SpriteManager::current())
+  {
+    std::vector<std::string> sprites;
+    collect_sprites(doc.get_sexp(), sprites);
+    sprite_manager->prefetch(sprites);
+  }
+}
+
+void
+LevelParser::precompile_scripts(const ReaderDocument& doc)
+{
+  SquirrelVirtualMachine* vm = SquirrelVirtualMachine::current();
+  if (!vm || m_editable)
+    return;
+
+  std::vector<std::pair<std::string, std::string>> scripts;
+  collect_scripts(doc.get_sexp(), std::string(), scripts);
+  vm->precompile(std::move(scripts));
+}
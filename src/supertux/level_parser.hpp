@@ -28,6 +28,16 @@ class LevelParser final
 public:
   static std::unique_ptr<Level> from_stream(std::istream& stream, const std::string& context, bool worldmap, bool editable);
   static std::unique_ptr<Level> from_file(const std::string& filename, bool worldmap, bool editable);
+  /** Creates the level from an already parsed level file, which can be
+      reused to create the same level again. When 'previous' is a level
+      created from 'doc' before, its sectors, apart from the first one,
+      are only created when the level asks for them, 'doc' has to
+      outlive the level then.
+      Without 'prefetch', the images and scripts of the level are
+      expected to be loaded already, by an earlier call with 'doc'. */
+  static std::unique_ptr<Level> from_document(const ReaderDocument& doc, bool worldmap, bool editable,
+                                              const Level* previous = nullptr,
+                                              bool prefetch = true);
   static std::unique_ptr<Level> from_nothing(const std::string& basedir);
   static std::unique_ptr<Level> from_nothing_worldmap(const std::string& basedir, const std::string& name);
 
@@ -39,13 +49,22 @@ private:
   void load(const ReaderDocument& doc);
   void load(std::istream& stream, const std::string& context);
   void load(const std::string& filepath);
+  void load_document(const ReaderDocument& doc);
   void load_old_format(const ReaderMapping& reader);
   void create(const std::string& filepath, const std::string& levelname);
 
+  /** Starts decoding all images the level refers to in the background. */
+  void prefetch_images(const ReaderDocument& doc);
+
+  /** Starts compiling all scripts of the level in the background. */
+  void precompile_scripts(const ReaderDocument& doc);
+
 private:
   Level& m_level;
   bool m_worldmap;
   bool m_editable;
+  const Level* m_previous;
+  bool m_prefetch;
 
 private:
   LevelParser(const LevelParser&) = delete;
@@ -18,6 +18,7 @@
 
 #include <config.h>
 #include <version.h>
+#include <algorithm>
 #include <filesystem>
 #include <fstream>
 
@@ -56,6 +57,7 @@ extern "C" {
 #include "sdk/integration.hpp"
 #include "sprite/sprite_data.hpp"
 #include "sprite/sprite_manager.hpp"
+#include "supertux/benchmark.hpp"
 #include "supertux/command_line_arguments.hpp"
 #include "supertux/constants.hpp"
 #include "supertux/console.hpp"
@@ -126,6 +128,7 @@ Main::Main() :
   m_physfs_subsystem(),
   m_config_subsystem(),
   m_sdl_subsystem(),
+  m_job_system(),
   m_console_buffer(),
   m_input_manager(),
   m_video_system(),
@@ -513,7 +516,15 @@ Main::launch_game(const CommandLineArguments& args)
       so re-mount the directories, containing those files. */
   m_physfs_subsystem->remount_datadir_static();
 
+  const bool benchmark = args.benchmark && *args.benchmark;
+  if (benchmark && !args.video)
+  {
+    // The null renderer doesn't need a display, so neither should SDL.
+    SDL_setenv("SDL_VIDEODRIVER", "dummy", 0);
+  }
+
   m_sdl_subsystem.reset(new SDLSubsystem());
+  m_job_system.reset(new JobSystem(JobSystem::default_worker_count()));
   m_console_buffer.reset(new ConsoleBuffer());
 #ifdef ENABLE_TOUCHSCREEN_SUPPORT
   if (getenv("ANDROID_TV")) {
@@ -528,7 +539,7 @@ Main::launch_game(const CommandLineArguments& args)
 
 #ifndef EMSCRIPTEN
   auto video = g_config->video;
-  if (args.resave && *args.resave) {
+  if ((args.resave && *args.resave) || benchmark) {
     if (args.video) {
       video = *args.video;
     } else {
@@ -548,13 +559,15 @@ Main::launch_game(const CommandLineArguments& args)
 
   s_timelog.log("audio");
   m_sound_manager.reset(new SoundManager());
-  m_sound_manager->enable_sound(g_config->sound_enabled);
-  m_sound_manager->enable_music(g_config->music_enabled);
+  m_sound_manager->enable_sound(g_config->sound_enabled && !benchmark);
+  m_sound_manager->enable_music(g_config->music_enabled && !benchmark);
   m_sound_manager->set_sound_volume(g_config->sound_volume);
   m_sound_manager->set_music_volume(g_config->music_volume);
+  m_sound_manager->set_buffer_budget(static_cast<size_t>(std::max(g_config->sound_buffer_budget, 0)) * 1024 * 1024);
 
   s_timelog.log("scripting");
   m_squirrel_virtual_machine.reset(new SquirrelVirtualMachine(g_config->enable_script_debugger));
+  m_squirrel_virtual_machine->get_profiler().set_budget(g_config->script_budget);
 
   s_timelog.log("resources");
   m_tile_manager.reset(new TileManager());
@@ -594,6 +607,23 @@ Main::launch_game(const CommandLineArguments& args)
       {
         resave(start_level, start_level);
       }
+      else if (benchmark)
+      {
+        // Created first, so that the initial load of the level is timed.
+        Benchmark runner(start_level, args.benchmark_frames.value_or(3600),
+                         args.benchmark_input.value_or(""));
+
+        auto session = std::make_unique<GameSession>(filename, *m_savegame);
+
+        // Fixed seeds, so that every run plays out the same way.
+        gameRandom.seed(1);
+        graphicsRandom.seed(1);
+        session->restart_level();
+
+        runner.run(*m_screen_manager, std::move(session));
+        runner.print_report(std::cout);
+        return;
+      }
       else if (args.editor)
       {
         if (PHYSFS_exists(start_level.c_str())) {
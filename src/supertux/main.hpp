@@ -36,6 +36,7 @@
 #include "supertux/screen_manager.hpp"
 #include "supertux/tile_manager.hpp"
 #include "supertux/tile_set.hpp"
+#include "util/job_system.hpp"
 #include "video/ttf_surface_manager.hpp"
 
 class ConfigSubsystem final
@@ -105,6 +106,8 @@ private:
   std::unique_ptr<PhysfsSubsystem> m_physfs_subsystem;
   std::unique_ptr<ConfigSubsystem> m_config_subsystem;
   std::unique_ptr<SDLSubsystem> m_sdl_subsystem;
+  // Declared early, so that it outlives everything that submits jobs
+  std::unique_ptr<JobSystem> m_job_system;
   std::unique_ptr<ConsoleBuffer> m_console_buffer;
   std::unique_ptr<InputManager> m_input_manager;
   std::unique_ptr<VideoSystem> m_video_system;
@@ -70,6 +70,7 @@ DebugMenu::DebugMenu() :
   add_toggle(-1, _("Show Framerate"), &g_config->show_fps);
   add_toggle(-1, _("Draw Redundant Frames"), &g_debug.draw_redundant_frames);
   add_toggle(-1, _("Show Player Position"), &g_config->show_player_pos);
+  add_toggle(-1, _("Show Script Timings"), &g_config->show_script_timings);
   add_toggle(-1, _("Use Bitmap Fonts"),
              []{ return g_debug.get_use_bitmap_fonts(); },
              [](bool value){ g_debug.set_use_bitmap_fonts(value); });
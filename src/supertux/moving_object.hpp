@@ -72,7 +72,7 @@ public:
   }
   virtual void move(const Vector& dist)
   {
-    m_col.m_bbox.move(dist);
+    m_col.move(dist);
   }
 
   Vector get_pos() const
@@ -156,7 +156,7 @@ public:
 protected:
   void set_group(CollisionGroup group)
   {
-    m_col.m_group = group;
+    m_col.set_group(group);
   }
 
 protected:
@@ -422,7 +422,7 @@ PlayerStatus::PocketPowerUp::update(float dt_sec)
   {
     m_visible = true;
     m_blink_timer.stop();
-    m_col.m_group = COLGROUP_TOUCHABLE;
+    set_group(COLGROUP_TOUCHABLE);
   }
 
   if (m_blink_timer.check())
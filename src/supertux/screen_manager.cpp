@@ -27,6 +27,7 @@
 #include "object/player.hpp"
 #include "sdk/integration.hpp"
 #include "squirrel/squirrel_virtual_machine.hpp"
+#include "supertux/benchmark.hpp"
 #include "supertux/console.hpp"
 #include "supertux/constants.hpp"
 #include "supertux/controller_hud.hpp"
@@ -231,6 +232,15 @@ ScreenManager::draw_fps(DrawingContext& context, FPS_Stats& fps_statistics)
   pos.x -= w2;
   context.color().draw_text(Resources::small_font, str1,
     pos, ALIGN_RIGHT, LAYER_HUD);
+
+  // Draw calls of the previous frame, after merging the requests
+  char str4[60];
+  snprintf(str4, sizeof(str4), "Draw calls: %d / %d",
+    Compositor::s_frame_draw_calls, Compositor::s_frame_requests);
+  pos.x = context.get_width() - BORDER_X;
+  pos.y += 15;
+  context.color().draw_text(Resources::small_font, str4,
+    pos, ALIGN_RIGHT, LAYER_HUD);
 }
 
 void
@@ -256,39 +266,69 @@ ScreenManager::draw_player_pos(DrawingContext& context)
   }
 }
 
+void
+ScreenManager::draw_script_timings(DrawingContext& context)
+{
+  const ScriptProfiler& profiler = SquirrelVirtualMachine::current()->get_profiler();
+
+  Vector pos(BORDER_X, BORDER_Y + 100);
+  char str[120];
+  snprintf(str, sizeof(str), "Scripts: %.2f ms", profiler.get_frame_time());
+  context.color().draw_text(Resources::small_font, str, pos, ALIGN_LEFT, LAYER_HUD);
+
+  // Runs, average and maximum time of the scripts that took the
+  // longest overall
+  for (const auto& [sourcename, stats] : profiler.get_top(5))
+  {
+    pos.y += 15;
+    snprintf(str, sizeof(str), "%s: %d / %.2f / %.2f ms", sourcename.c_str(), stats.calls,
+             stats.total_ms / stats.calls, stats.max_ms);
+    context.color().draw_text(Resources::small_font, str, pos, ALIGN_LEFT, LAYER_HUD);
+  }
+}
+
 void
 ScreenManager::draw(Compositor& compositor, FPS_Stats& fps_statistics)
 {
   assert(!m_screen_stack.empty());
 
-  // draw the actual screen
-  m_screen_stack.back()->draw(compositor);
+  {
+    BenchmarkTimer timer(Benchmark::SECTION_DRAW);
 
-  // draw effects and hud
-  auto& context = compositor.make_context(true);
-  m_menu_manager->draw(context);
+    // draw the actual screen
+    m_screen_stack.back()->draw(compositor);
 
-  if (m_screen_fade) {
-    m_screen_fade->draw(context);
-  }
+    // draw effects and hud
+    auto& context = compositor.make_context(true);
+    m_menu_manager->draw(context);
 
-  Console::current()->draw(context);
+    if (m_screen_fade) {
+      m_screen_fade->draw(context);
+    }
 
-  if (g_config->mobile_controls)
-    m_mobile_controller.draw(context);
+    Console::current()->draw(context);
 
-  if (g_config->show_fps)
-    draw_fps(context, fps_statistics);
+    if (g_config->mobile_controls)
+      m_mobile_controller.draw(context);
 
-  if (g_config->show_controller) {
-    m_controller_hud->draw(context);
-  }
+    if (g_config->show_fps)
+      draw_fps(context, fps_statistics);
 
-  if (g_config->show_player_pos) {
-    draw_player_pos(context);
+    if (g_config->show_controller) {
+      m_controller_hud->draw(context);
+    }
+
+    if (g_config->show_player_pos) {
+      draw_player_pos(context);
+    }
+
+    if (g_config->show_script_timings) {
+      draw_script_timings(context);
+    }
   }
 
   // render everything
+  BenchmarkTimer timer(Benchmark::SECTION_RENDER);
   compositor.render();
 }
 
@@ -303,7 +343,10 @@ ScreenManager::update_gamelogic(float dt_sec)
     m_mobile_controller.apply(controller);
   }
 
-  SquirrelVirtualMachine::current()->update(g_game_time);
+  {
+    BenchmarkTimer timer(Benchmark::SECTION_SCRIPT);
+    SquirrelVirtualMachine::current()->update(g_game_time);
+  }
 
   if (!m_screen_stack.empty())
   {
@@ -646,6 +689,27 @@ void ScreenManager::loop_iter()
 #endif
 }
 
+bool
+ScreenManager::step()
+{
+  handle_screen_switch();
+  if (m_screen_stack.empty())
+    return false;
+
+  float dtime = seconds_per_step * m_speed * g_debug.get_game_speed_multiplier();
+  g_game_time += dtime;
+  g_real_time += seconds_per_step;
+  process_events();
+  update_gamelogic(dtime);
+
+  Compositor compositor(m_video_system, 0.0f);
+  draw(compositor, *m_fps_statistics);
+  m_fps_statistics->report_frame();
+
+  SoundManager::current()->update();
+  return true;
+}
+
 #ifdef __EMSCRIPTEN__
 static void g_loop_iter() {
   auto screen_manager = ScreenManager::current();
@@ -61,12 +61,18 @@ public:
 
   void loop_iter();
 
+  /** Performs one logical game step and draws a frame, without waiting
+      for real time to pass. Used for benchmarking, returns false once
+      there is no screen left to run. */
+  bool step();
+
   inline const std::vector<std::unique_ptr<Screen>>& get_screen_stack() { return m_screen_stack; }
 
 private:
   struct FPS_Stats;
   void draw_fps(DrawingContext& context, FPS_Stats& fps_statistics);
   void draw_player_pos(DrawingContext& context);
+  void draw_script_timings(DrawingContext& context);
   void draw(Compositor& compositor, FPS_Stats& fps_statistics);
   void update_gamelogic(float dt_sec);
   void process_events();
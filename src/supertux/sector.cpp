@@ -46,6 +46,7 @@
 #include "object/vertical_stripes.hpp"
 #include "physfs/ifile_stream.hpp"
 #include "squirrel/squirrel_environment.hpp"
+#include "supertux/benchmark.hpp"
 #include "supertux/colorscheme.hpp"
 #include "supertux/constants.hpp"
 #include "supertux/debug.hpp"
@@ -371,12 +372,21 @@ Sector::update(float dt_sec)
   m_last_translation = camera.get_translation();
   m_last_dt = dt_sec;
 
-  m_squirrel_environment->update(dt_sec);
+  {
+    BenchmarkTimer timer(Benchmark::SECTION_SCRIPT);
+    m_squirrel_environment->update(dt_sec);
+  }
 
-  GameObjectManager::update(dt_sec);
+  {
+    BenchmarkTimer timer(Benchmark::SECTION_UPDATE);
+    GameObjectManager::update(dt_sec);
+  }
 
   /* Handle all possible collisions. */
-  m_collision_system->update();
+  {
+    BenchmarkTimer timer(Benchmark::SECTION_COLLISION);
+    m_collision_system->update();
+  }
   flush_game_objects();
 }
 
@@ -111,6 +111,9 @@ public:
   SurfacePtr get_current_surface() const;
   SurfacePtr get_current_editor_surface() const;
 
+  /** Returns true if the current surface changes over time. */
+  inline bool is_animated() const { return m_images.size() > 1 || m_editor_images.size() > 1; }
+
   inline uint32_t get_attributes() const { return m_attributes; }
   inline int get_data() const { return m_data; }
 
@@ -0,0 +1,254 @@
+//  SuperTux
+//  Copyright (C) 2026 SuperTux Development Team
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#include "supertux/tile_attribute_grid.hpp"
+
+#include <algorithm>
+#include <math.h>
+
+#include "math/rect.hpp"
+#include "math/rectf.hpp"
+#include "object/tilemap.hpp"
+#include "supertux/tile.hpp"
+
+namespace {
+
+/** Don't merge tilemaps that are spread so far apart that the grid
+    would become huge, 16M cells take up 32MB. */
+const int64_t MAX_CELLS = 16 * 1024 * 1024;
+
+/** Keeps tile coordinates far away from integer overflow. */
+const float MAX_TILE_COORD = 1.0e6f;
+
+bool is_mergeable(const TileMap& tilemap)
+{
+  if (tilemap.get_walker())
+    return false;
+
+  const Vector offset = tilemap.get_offset() / 32.0f;
+  return fabsf(offset.x) < MAX_TILE_COORD && fabsf(offset.y) < MAX_TILE_COORD &&
+         floorf(offset.x) == offset.x && floorf(offset.y) == offset.y;
+}
+
+uint16_t to_cell(uint32_t attributes)
+{
+  // Attributes that don't fit are never skipped.
+  return attributes > 0xFFFF ? 0xFFFF : static_cast<uint16_t>(attributes);
+}
+
+} // namespace
+
+TileAttributeGrid::TileAttributeGrid() :
+  m_solid_tilemaps(),
+  m_entries(),
+  m_left(0),
+  m_top(0),
+  m_width(0),
+  m_height(0),
+  m_cells()
+{
+}
+
+bool
+TileAttributeGrid::is_up_to_date(const std::vector<TileMap*>& solid_tilemaps) const
+{
+  if (solid_tilemaps != m_solid_tilemaps)
+    return false;
+
+  for (const auto& entry : m_entries)
+  {
+    const TileMap& tilemap = *entry.tilemap;
+    if (tilemap.get_revision() != entry.revision ||
+        tilemap.get_tileset() != entry.tileset ||
+        tilemap.get_offset() != entry.offset ||
+        tilemap.get_width() != entry.width ||
+        tilemap.get_height() != entry.height ||
+        tilemap.get_walker())
+      return false;
+  }
+
+  return true;
+}
+
+void
+TileAttributeGrid::rebuild(const std::vector<TileMap*>& solid_tilemaps)
+{
+  m_solid_tilemaps = solid_tilemaps;
+  m_entries.clear();
+  m_cells.clear();
+  m_left = 0;
+  m_top = 0;
+  m_width = 0;
+  m_height = 0;
+
+  int left = 0;
+  int top = 0;
+  int right = 0;
+  int bottom = 0;
+
+  for (const auto* tilemap : solid_tilemaps)
+  {
+    if (!is_mergeable(*tilemap))
+      continue;
+
+    Entry entry;
+    entry.tilemap = tilemap;
+    entry.tileset = tilemap->get_tileset();
+    entry.offset = tilemap->get_offset();
+    entry.width = tilemap->get_width();
+    entry.height = tilemap->get_height();
+    entry.revision = tilemap->get_revision();
+    entry.x = static_cast<int>(entry.offset.x / 32.0f);
+    entry.y = static_cast<int>(entry.offset.y / 32.0f);
+
+    if (m_entries.empty())
+    {
+      left = entry.x;
+      top = entry.y;
+      right = entry.x + entry.width;
+      bottom = entry.y + entry.height;
+    }
+    else
+    {
+      left = std::min(left, entry.x);
+      top = std::min(top, entry.y);
+      right = std::max(right, entry.x + entry.width);
+      bottom = std::max(bottom, entry.y + entry.height);
+    }
+
+    m_entries.push_back(entry);
+  }
+
+  if (m_entries.empty() ||
+      static_cast<int64_t>(right - left) * static_cast<int64_t>(bottom - top) > MAX_CELLS)
+  {
+    m_entries.clear();
+    return;
+  }
+
+  m_left = left;
+  m_top = top;
+  m_width = right - left;
+  m_height = bottom - top;
+  m_cells.resize(m_width * m_height, 0);
+
+  for (auto& entry : m_entries)
+  {
+    entry.x -= m_left;
+    entry.y -= m_top;
+
+    for (int y = 0; y < entry.height; ++y)
+    {
+      uint16_t* row = &m_cells[(entry.y + y) * m_width + entry.x];
+      for (int x = 0; x < entry.width; ++x)
+        row[x] = static_cast<uint16_t>(row[x] | to_cell(entry.tilemap->get_tile(x, y).get_attributes()));
+    }
+  }
+}
+
+void
+TileAttributeGrid::update_tile(const TileMap& tilemap, int x, int y)
+{
+  auto it = std::find_if(m_entries.begin(), m_entries.end(),
+                         [&tilemap](const Entry& entry) { return entry.tilemap == &tilemap; });
+  if (it == m_entries.end())
+    return;
+
+  // Only patch the grid if this change is the only thing it is missing.
+  if (it->revision + 1 != tilemap.get_revision())
+    return;
+
+  it->revision = tilemap.get_revision();
+
+  const int gx = it->x + x;
+  const int gy = it->y + y;
+  if (gx >= 0 && gy >= 0 && gx < m_width && gy < m_height)
+    m_cells[gy * m_width + gx] = get_merged_attributes(gx, gy);
+}
+
+bool
+TileAttributeGrid::get_tilemap_position(const TileMap& tilemap, int& x, int& y) const
+{
+  const Entry* entry = get_entry(tilemap);
+  if (!entry)
+    return false;
+
+  x = entry->x;
+  y = entry->y;
+  return true;
+}
+
+uint32_t
+TileAttributeGrid::get_attributes(const Rectf& rect) const
+{
+  const Rect tiles = get_cells_overlapping(rect);
+
+  uint32_t result = 0;
+  for (int y = tiles.top; y < tiles.bottom; ++y)
+  {
+    const uint16_t* row = &m_cells[y * m_width];
+    for (int x = tiles.left; x < tiles.right; ++x)
+      result |= row[x];
+  }
+  return result;
+}
+
+Rect
+TileAttributeGrid::get_cells_overlapping(const Rectf& rect) const
+{
+  // Grown a little, so that rounding can't make this miss a tile that
+  // TileMap::get_tiles_overlapping() reports for the same rect.
+  const float width = static_cast<float>(m_width);
+  const float height = static_cast<float>(m_height);
+  const float left = floorf((rect.get_left() - 1.0f) / 32.0f) - static_cast<float>(m_left);
+  const float right = ceilf((rect.get_right() + 1.0f) / 32.0f) - static_cast<float>(m_left);
+  const float top = floorf((rect.get_top() - 1.0f) / 32.0f) - static_cast<float>(m_top);
+  const float bottom = ceilf((rect.get_bottom() + 1.0f) / 32.0f) - static_cast<float>(m_top);
+
+  // Clamp while still in float, the rect may lie far outside of the
+  // grid. The argument order also maps NaN to 0.
+  return Rect(static_cast<int>(std::max(0.0f, std::min(left, width))),
+              static_cast<int>(std::max(0.0f, std::min(top, height))),
+              static_cast<int>(std::max(0.0f, std::min(right, width))),
+              static_cast<int>(std::max(0.0f, std::min(bottom, height))));
+}
+
+const TileAttributeGrid::Entry*
+TileAttributeGrid::get_entry(const TileMap& tilemap) const
+{
+  for (const auto& entry : m_entries)
+  {
+    if (entry.tilemap == &tilemap)
+      return &entry;
+  }
+  return nullptr;
+}
+
+uint16_t
+TileAttributeGrid::get_merged_attributes(int x, int y) const
+{
+  uint16_t result = 0;
+  for (const auto& entry : m_entries)
+  {
+    const int tx = x - entry.x;
+    const int ty = y - entry.y;
+    if (tx < 0 || ty < 0 || tx >= entry.width || ty >= entry.height)
+      continue;
+
+    result = static_cast<uint16_t>(result | to_cell(entry.tilemap->get_tile(tx, ty).get_attributes()));
+  }
+  return result;
+}
@@ -0,0 +1,103 @@
+//  SuperTux
+//  Copyright (C) 2026 SuperTux Development Team
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#pragma once
+
+#include <stdint.h>
+#include <vector>
+
+#include "math/vector.hpp"
+
+class Rect;
+class Rectf;
+class TileMap;
+class TileSet;
+
+/**
+ * Tile attributes of all static solid tilemaps of a sector, merged
+ * into one flat array with one cell per 32x32 tile.
+ *
+ * A cell holds the union of Tile::get_attributes() of every merged
+ * tilemap at that position, which lets collision queries skip empty
+ * tiles without looking up the Tile objects. Tilemaps that follow a
+ * path or are not aligned to the tile grid are not merged, callers
+ * have to handle those the usual way.
+ */
+class TileAttributeGrid final
+{
+private:
+  struct Entry
+  {
+    const TileMap* tilemap;
+    const TileSet* tileset;
+    Vector offset;
+    int width;
+    int height;
+    uint32_t revision;
+
+    /** Position of the tilemap's tile (0, 0) in the grid. */
+    int x;
+    int y;
+  };
+
+public:
+  TileAttributeGrid();
+
+  /** Returns true if the grid still reflects the given solid tilemaps. */
+  bool is_up_to_date(const std::vector<TileMap*>& solid_tilemaps) const;
+
+  void rebuild(const std::vector<TileMap*>& solid_tilemaps);
+
+  /** Refreshes the cell under tile (x, y) of 'tilemap' after a single
+      tile change, so that it does not need a full rebuild. */
+  void update_tile(const TileMap& tilemap, int x, int y);
+
+  /** If 'tilemap' is merged into the grid, stores the grid position of
+      its tile (0, 0) in 'x' and 'y' and returns true. */
+  bool get_tilemap_position(const TileMap& tilemap, int& x, int& y) const;
+
+  /** Returns the merged attributes of the cell (x, y), 0 outside of the grid. */
+  inline uint32_t get(int x, int y) const
+  {
+    if (x < 0 || y < 0 || x >= m_width || y >= m_height)
+      return 0;
+    return m_cells[y * m_width + x];
+  }
+
+  /** Returns the union of the attributes of all cells overlapping
+      'rect', which is given in sector coordinates. */
+  uint32_t get_attributes(const Rectf& rect) const;
+
+private:
+  Rect get_cells_overlapping(const Rectf& rect) const;
+  const Entry* get_entry(const TileMap& tilemap) const;
+  uint16_t get_merged_attributes(int x, int y) const;
+
+private:
+  std::vector<TileMap*> m_solid_tilemaps;
+  std::vector<Entry> m_entries;
+
+  /** Position of the grid's cell (0, 0) in the sector, in tiles. */
+  int m_left;
+  int m_top;
+  int m_width;
+  int m_height;
+  std::vector<uint16_t> m_cells;
+
+private:
+  TileAttributeGrid(const TileAttributeGrid&) = delete;
+  TileAttributeGrid& operator=(const TileAttributeGrid&) = delete;
+};
@@ -0,0 +1,349 @@
+//  SuperTux
+//  Copyright (C) 2026 SuperTux Development Team
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#include "util/binary_sexp.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+#include <stdint.h>
+#include <unordered_map>
+#include <vector>
+
+namespace {
+
+const char s_magic[4] = { 'S', 'T', 'S', 'X' };
+const uint8_t s_format_version = 2;
+
+// Integer arrays are copied as they are.
+static_assert(sizeof(int) == sizeof(int32_t), "int must be 32 bits");
+
+/** Runs of at least this many integers are stored raw. */
+const size_t s_min_integer_run = 4;
+
+enum Tag : uint8_t
+{
+  TAG_NIL,
+  TAG_FALSE,
+  TAG_TRUE,
+  TAG_INTEGER,
+  TAG_REAL,
+  TAG_STRING,
+  TAG_SYMBOL,
+  TAG_SYMBOL_REF,
+  TAG_ARRAY,
+  TAG_INTEGER_RUN
+};
+
+class BinaryWriter final
+{
+public:
+  BinaryWriter() :
+    m_out(),
+    m_symbols()
+  {
+    m_out.append(s_magic, sizeof(s_magic));
+    write_raw<uint8_t>(s_format_version);
+  }
+
+  void write_value(const sexp::Value& sx)
+  {
+    switch (sx.get_type())
+    {
+      case sexp::Value::Type::NIL:
+        write_raw<uint8_t>(TAG_NIL);
+        break;
+
+      case sexp::Value::Type::BOOLEAN:
+        write_raw<uint8_t>(sx.as_bool() ? TAG_TRUE : TAG_FALSE);
+        break;
+
+      case sexp::Value::Type::INTEGER:
+        write_raw<uint8_t>(TAG_INTEGER);
+        write_raw<int32_t>(sx.as_int());
+        break;
+
+      case sexp::Value::Type::REAL:
+        write_raw<uint8_t>(TAG_REAL);
+        write_raw<float>(sx.as_float());
+        break;
+
+      case sexp::Value::Type::STRING:
+        write_raw<uint8_t>(TAG_STRING);
+        write_string(sx.as_string());
+        break;
+
+      case sexp::Value::Type::SYMBOL:
+      {
+        auto it = m_symbols.find(sx.as_string());
+        if (it != m_symbols.end())
+        {
+          write_raw<uint8_t>(TAG_SYMBOL_REF);
+          write_raw<uint32_t>(it->second);
+        }
+        else
+        {
+          m_symbols.emplace(sx.as_string(), static_cast<uint32_t>(m_symbols.size()));
+          write_raw<uint8_t>(TAG_SYMBOL);
+          write_string(sx.as_string());
+        }
+        break;
+      }
+
+      case sexp::Value::Type::ARRAY:
+        write_array(sx.as_array());
+        break;
+
+      default:
+        throw std::runtime_error("binary documents can't store cons cells");
+    }
+  }
+
+  void write_integer_arrays(const std::vector<std::vector<int>>& arrays)
+  {
+    write_raw<uint32_t>(static_cast<uint32_t>(arrays.size()));
+    for (const auto& array : arrays)
+    {
+      write_raw<uint32_t>(static_cast<uint32_t>(array.size()));
+      m_out.append(reinterpret_cast<const char*>(array.data()), array.size() * sizeof(int32_t));
+    }
+  }
+
+  std::string& get() { return m_out; }
+
+private:
+  void write_array(const std::vector<sexp::Value>& items)
+  {
+    write_raw<uint8_t>(TAG_ARRAY);
+    write_raw<uint32_t>(static_cast<uint32_t>(items.size()));
+
+    size_t i = 0;
+    while (i < items.size())
+    {
+      size_t run_end = i;
+      while (run_end < items.size() && items[run_end].is_integer())
+        ++run_end;
+
+      if (run_end - i >= s_min_integer_run)
+      {
+        write_raw<uint8_t>(TAG_INTEGER_RUN);
+        write_raw<uint32_t>(static_cast<uint32_t>(run_end - i));
+        for (; i < run_end; ++i)
+          write_raw<int32_t>(items[i].as_int());
+      }
+      else
+      {
+        write_value(items[i]);
+        ++i;
+      }
+    }
+  }
+
+  void write_string(const std::string& str)
+  {
+    write_raw<uint32_t>(static_cast<uint32_t>(str.size()));
+    m_out += str;
+  }
+
+  template<typename T>
+  void write_raw(T value)
+  {
+    m_out.append(reinterpret_cast<const char*>(&value), sizeof(T));
+  }
+
+private:
+  std::string m_out;
+  std::unordered_map<std::string, uint32_t> m_symbols;
+
+private:
+  BinaryWriter(const BinaryWriter&) = delete;
+  BinaryWriter& operator=(const BinaryWriter&) = delete;
+};
+
+class BinaryReader final
+{
+public:
+  BinaryReader(const std::string& data) :
+    m_data(data),
+    m_pos(0),
+    m_symbols()
+  {
+    require(sizeof(s_magic) + 1);
+    if (memcmp(m_data.data(), s_magic, sizeof(s_magic)) != 0)
+      throw std::runtime_error("not a binary document");
+    m_pos += sizeof(s_magic);
+
+    if (read_raw<uint8_t>() != s_format_version)
+      throw std::runtime_error("unsupported binary document version");
+  }
+
+  sexp::Value read_value()
+  {
+    switch (read_raw<uint8_t>())
+    {
+      case TAG_NIL:
+        return sexp::Value::nil();
+
+      case TAG_FALSE:
+        return sexp::Value::boolean(false);
+
+      case TAG_TRUE:
+        return sexp::Value::boolean(true);
+
+      case TAG_INTEGER:
+        return sexp::Value::integer(read_raw<int32_t>());
+
+      case TAG_REAL:
+        return sexp::Value::real(read_raw<float>());
+
+      case TAG_STRING:
+        return sexp::Value::string(read_string());
+
+      case TAG_SYMBOL:
+        m_symbols.push_back(read_string());
+        return sexp::Value::symbol(m_symbols.back());
+
+      case TAG_SYMBOL_REF:
+      {
+        const uint32_t index = read_raw<uint32_t>();
+        if (index >= m_symbols.size())
+          throw std::runtime_error("invalid symbol reference in binary document");
+        return sexp::Value::symbol(m_symbols[index]);
+      }
+
+      case TAG_ARRAY:
+        return read_array();
+
+      default:
+        throw std::runtime_error("invalid tag in binary document");
+    }
+  }
+
+  void read_integer_arrays(std::vector<std::vector<int>>& arrays)
+  {
+    const size_t count = read_raw<uint32_t>();
+    require(count * sizeof(uint32_t));
+    arrays.resize(count);
+    for (auto& array : arrays)
+    {
+      const size_t size = read_raw<uint32_t>();
+      require(size * sizeof(int32_t));
+      array.resize(size);
+      memcpy(array.data(), m_data.data() + m_pos, size * sizeof(int32_t));
+      m_pos += size * sizeof(int32_t);
+    }
+  }
+
+  bool at_end() const { return m_pos == m_data.size(); }
+
+private:
+  sexp::Value read_array()
+  {
+    const size_t count = read_raw<uint32_t>();
+
+    std::vector<sexp::Value> items;
+    // Every element takes at least one byte, don't trust the count
+    // any further than that.
+    items.reserve(std::min(count, m_data.size() - m_pos));
+    while (items.size() < count)
+    {
+      require(1);
+      if (m_data[m_pos] == static_cast<char>(TAG_INTEGER_RUN))
+      {
+        m_pos += 1;
+        const size_t run = read_raw<uint32_t>();
+        if (run > count - items.size())
+          throw std::runtime_error("integer run exceeds its array in binary document");
+
+        require(run * sizeof(int32_t));
+        for (size_t i = 0; i < run; ++i)
+          items.push_back(sexp::Value::integer(read_raw<int32_t>()));
+      }
+      else
+      {
+        items.push_back(read_value());
+      }
+    }
+    return sexp::Value::array(std::move(items));
+  }
+
+  std::string read_string()
+  {
+    const size_t size = read_raw<uint32_t>();
+    require(size);
+    std::string str(m_data, m_pos, size);
+    m_pos += size;
+    return str;
+  }
+
+  template<typename T>
+  T read_raw()
+  {
+    require(sizeof(T));
+    T value;
+    memcpy(&value, m_data.data() + m_pos, sizeof(T));
+    m_pos += sizeof(T);
+    return value;
+  }
+
+  void require(size_t size) const
+  {
+    if (m_data.size() - m_pos < size)
+      throw std::runtime_error("binary document is truncated");
+  }
+
+private:
+  const std::string& m_data;
+  size_t m_pos;
+  std::vector<std::string> m_symbols;
+
+private:
+  BinaryReader(const BinaryReader&) = delete;
+  BinaryReader& operator=(const BinaryReader&) = delete;
+};
+
+} // namespace
+
+namespace BinarySexp {
+
+std::string
+write(const sexp::Value& sx, const std::vector<std::vector<int>>& integer_arrays)
+{
+  BinaryWriter writer;
+  writer.write_value(sx);
+  writer.write_integer_arrays(integer_arrays);
+  return std::move(writer.get());
+}
+
+sexp::Value
+read(const std::string& data, std::vector<std::vector<int>>& integer_arrays)
+{
+  BinaryReader reader(data);
+  sexp::Value sx = reader.read_value();
+  reader.read_integer_arrays(integer_arrays);
+  if (!reader.at_end())
+    throw std::runtime_error("trailing data in binary document");
+  return sx;
+}
+
+sexp::Value
+read(const std::string& data)
+{
+  std::vector<std::vector<int>> integer_arrays;
+  return read(data, integer_arrays);
+}
+
+} // namespace BinarySexp
@@ -0,0 +1,40 @@
+//  SuperTux
+//  Copyright (C) 2026 SuperTux Development Team
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include <sexp/value.hpp>
+
+/** Compact binary form of parsed S-expressions. Symbols are stored
+    once and referred to by index afterwards, and runs of integers,
+    like the tiles of a tilemap, are stored as raw arrays. The format
+    uses the native byte order, it is meant for local caches only. */
+namespace BinarySexp {
+
+/** Stores 'sx' along with the integer arrays of its ReaderDocument.
+    Throws std::runtime_error if 'sx' contains values that can't be
+    stored, which are cons cells. */
+std::string write(const sexp::Value& sx, const std::vector<std::vector<int>>& integer_arrays = {});
+
+/** Throws std::runtime_error if 'data' isn't a complete document
+    written by write(). */
+sexp::Value read(const std::string& data, std::vector<std::vector<int>>& integer_arrays);
+sexp::Value read(const std::string& data);
+
+} // namespace BinarySexp
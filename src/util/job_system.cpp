@@ -0,0 +1,242 @@
+//  SuperTux
+//  Copyright (C) 2026 SuperTux Development Team
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#include "util/job_system.hpp"
+
+namespace {
+
+/** The JobSystem the current thread works for and its worker index. */
+thread_local const JobSystem* t_job_system = nullptr;
+thread_local int t_worker_index = -1;
+
+} // namespace
+
+int
+JobSystem::default_worker_count()
+{
+#ifdef __EMSCRIPTEN__
+  return 0;
+#else
+  const int cores = static_cast<int>(std::thread::hardware_concurrency());
+  return std::clamp(cores - 1, 1, 8);
+#endif
+}
+
+JobSystem::JobSystem(int num_workers) :
+  m_workers(),
+  m_sleep_mutex(),
+  m_wake(),
+  m_pending(0),
+  m_next_worker(0),
+  m_quit(false)
+{
+  for (int i = 0; i < num_workers; ++i)
+    m_workers.push_back(std::make_unique<Worker>());
+
+  // Only start them once all queues exist, as they steal from each other.
+  for (int i = 0; i < num_workers; ++i)
+    m_workers[i]->thread = std::thread(&JobSystem::run, this, i);
+}
+
+JobSystem::~JobSystem()
+{
+  shutdown();
+}
+
+void
+JobSystem::submit(Job job)
+{
+  if (m_workers.empty())
+  {
+    try
+    {
+      job();
+    }
+    catch (...)
+    {
+    }
+    return;
+  }
+
+  const int index = (t_job_system == this) ? t_worker_index :
+    static_cast<int>(m_next_worker++ % m_workers.size());
+
+  {
+    std::lock_guard<std::mutex> lock(m_workers[index]->mutex);
+    m_workers[index]->jobs.push_back(std::move(job));
+  }
+
+  {
+    // Counted under the lock, so that no worker can miss the wakeup.
+    std::lock_guard<std::mutex> lock(m_sleep_mutex);
+    ++m_pending;
+  }
+  m_wake.notify_one();
+}
+
+bool
+JobSystem::run_pending()
+{
+  Job job;
+  if (!take(t_job_system == this ? t_worker_index : -1, job))
+    return false;
+
+  try
+  {
+    job();
+  }
+  catch (...)
+  {
+  }
+  return true;
+}
+
+void
+JobSystem::shutdown()
+{
+  if (m_workers.empty())
+    return;
+
+  {
+    std::lock_guard<std::mutex> lock(m_sleep_mutex);
+    m_quit = true;
+  }
+  m_wake.notify_all();
+
+  for (auto& worker : m_workers)
+    worker->thread.join();
+
+  m_workers.clear();
+}
+
+void
+JobSystem::run(int index)
+{
+  t_job_system = this;
+  t_worker_index = index;
+
+  while (true)
+  {
+    Job job;
+    if (take(index, job))
+    {
+      try
+      {
+        job();
+      }
+      catch (...)
+      {
+      }
+      continue;
+    }
+
+    std::unique_lock<std::mutex> lock(m_sleep_mutex);
+    m_wake.wait(lock, [this] { return m_pending > 0 || m_quit; });
+    if (m_quit && m_pending == 0)
+      return;
+  }
+}
+
+bool
+JobSystem::take(int index, Job& job)
+{
+  if (index >= 0)
+  {
+    // Own queue from the back, the most recent job is the most likely
+    // to still be in the cache.
+    Worker& worker = *m_workers[index];
+    std::lock_guard<std::mutex> lock(worker.mutex);
+    if (!worker.jobs.empty())
+    {
+      job = std::move(worker.jobs.back());
+      worker.jobs.pop_back();
+      --m_pending;
+      return true;
+    }
+  }
+
+  const int count = static_cast<int>(m_workers.size());
+  for (int i = 1; i <= count; ++i)
+  {
+    Worker& victim = *m_workers[(std::max(index, 0) + i) % count];
+    std::lock_guard<std::mutex> lock(victim.mutex);
+    if (!victim.jobs.empty())
+    {
+      job = std::move(victim.jobs.front());
+      victim.jobs.pop_front();
+      --m_pending;
+      return true;
+    }
+  }
+
+  return false;
+}
+
+JobGroup::JobGroup(JobSystem& job_system) :
+  m_job_system(job_system),
+  m_pending(0),
+  m_error_mutex(),
+  m_error()
+{
+}
+
+JobGroup::~JobGroup()
+{
+  // The jobs refer to the group, so it must not go away before them.
+  while (m_pending > 0)
+  {
+    if (!m_job_system.run_pending())
+      std::this_thread::yield();
+  }
+}
+
+void
+JobGroup::run(JobSystem::Job job)
+{
+  ++m_pending;
+  m_job_system.submit([this, job = std::move(job)] {
+    try
+    {
+      job();
+    }
+    catch (...)
+    {
+      std::lock_guard<std::mutex> lock(m_error_mutex);
+      if (!m_error)
+        m_error = std::current_exception();
+    }
+    --m_pending;
+  });
+}
+
+void
+JobGroup::wait()
+{
+  while (m_pending > 0)
+  {
+    if (!m_job_system.run_pending())
+      std::this_thread::yield();
+  }
+
+  std::exception_ptr error;
+  {
+    std::lock_guard<std::mutex> lock(m_error_mutex);
+    std::swap(error, m_error);
+  }
+
+  if (error)
+    std::rethrow_exception(error);
+}
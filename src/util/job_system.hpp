@@ -0,0 +1,149 @@
+//  SuperTux
+//  Copyright (C) 2026 SuperTux Development Team
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "util/currenton.hpp"
+
+/**
+ * A fixed pool of worker threads shared by the engine's subsystems.
+ *
+ * Every worker has its own queue. Jobs submitted from a worker go to
+ * the back of its queue and are picked up from there again, idle
+ * workers steal from the front of the other queues. Without workers
+ * (e.g. on Emscripten) jobs run right away on the submitting thread.
+ *
+ * Jobs must not touch the console or the logging functions, as those
+ * are not thread safe.
+ */
+class JobSystem final : public Currenton<JobSystem>
+{
+public:
+  using Job = std::function<void ()>;
+
+private:
+  struct Worker
+  {
+    std::mutex mutex;
+    std::deque<Job> jobs;
+    std::thread thread;
+  };
+
+public:
+  /** One worker less than there are cores, none on Emscripten. */
+  static int default_worker_count();
+
+public:
+  explicit JobSystem(int num_workers);
+  ~JobSystem() override;
+
+  /** Queues 'job' to run on some worker. Jobs should not throw,
+      exceptions they do throw are dropped. */
+  void submit(Job job);
+
+  /** Runs a queued job on the calling thread, if there is one. Meant
+      for threads that wait on jobs. */
+  bool run_pending();
+
+  /** Finishes all queued jobs and stops the workers. Jobs submitted
+      afterwards run on the submitting thread. */
+  void shutdown();
+
+  inline int get_worker_count() const { return static_cast<int>(m_workers.size()); }
+
+  /** Calls 'func(chunk_begin, chunk_end)' for consecutive chunks of
+      up to 'grain' elements of [begin, end) in parallel, the calling
+      thread takes part. Returns when all chunks are done. */
+  template<typename Func>
+  void parallel_for(size_t begin, size_t end, size_t grain, const Func& func);
+
+private:
+  void run(int index);
+  bool take(int index, Job& job);
+
+private:
+  std::vector<std::unique_ptr<Worker>> m_workers;
+  std::mutex m_sleep_mutex;
+  std::condition_variable m_wake;
+  std::atomic<int> m_pending;
+  std::atomic<unsigned> m_next_worker;
+  bool m_quit;
+
+private:
+  JobSystem(const JobSystem&) = delete;
+  JobSystem& operator=(const JobSystem&) = delete;
+};
+
+/**
+ * Fork/join helper: jobs started with run() can be waited for
+ * together. The first exception thrown by one of them is rethrown by
+ * wait().
+ */
+class JobGroup final
+{
+public:
+  explicit JobGroup(JobSystem& job_system);
+  ~JobGroup();
+
+  void run(JobSystem::Job job);
+
+  /** Blocks until all jobs of the group are done, running queued jobs
+      on the calling thread in the meantime. */
+  void wait();
+
+private:
+  JobSystem& m_job_system;
+  std::atomic<int> m_pending;
+  std::mutex m_error_mutex;
+  std::exception_ptr m_error;
+
+private:
+  JobGroup(const JobGroup&) = delete;
+  JobGroup& operator=(const JobGroup&) = delete;
+};
+
+template<typename Func>
+void
+JobSystem::parallel_for(size_t begin, size_t end, size_t grain, const Func& func)
+{
+  if (end <= begin)
+    return;
+
+  grain = std::max<size_t>(grain, 1);
+
+  JobGroup group(*this);
+  size_t chunk = begin;
+  for (; end - chunk > grain; chunk += grain)
+  {
+    const size_t chunk_end = chunk + grain;
+    group.run([&func, chunk, chunk_end] { func(chunk, chunk_end); });
+  }
+
+  // The last chunk is done here instead of waiting idle.
+  func(chunk, end);
+  group.wait();
+}
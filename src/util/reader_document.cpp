@@ -16,6 +16,8 @@
 
 #include "util/reader_document.hpp"
 
+#include <algorithm>
+#include <ctype.h>
 #include <sexp/parser.hpp>
 #include <sstream>
 
@@ -23,6 +25,120 @@
 #include "util/file_system.hpp"
 #include "util/log.hpp"
 
+namespace {
+
+/** Parses the integers of the list starting at 'pos', right after
+    "(tiles", up to and including the closing parenthesis. Returns
+    false, leaving 'pos' alone, if the list holds anything else. */
+bool
+parse_integer_list(const std::string& text, size_t& pos, std::vector<int>& values, int& newlines)
+{
+  size_t i = pos;
+  while (true)
+  {
+    while (i < text.size() && isspace(static_cast<unsigned char>(text[i])))
+    {
+      if (text[i] == '\n')
+        newlines += 1;
+      ++i;
+    }
+
+    if (i >= text.size())
+      return false;
+
+    if (text[i] == ')')
+      break;
+
+    const bool negative = (text[i] == '-');
+    if (negative)
+      ++i;
+
+    // Anything that doesn't fit an int is left to the sexp parser.
+    long long value = 0;
+    const size_t digits_begin = i;
+    while (i < text.size() && isdigit(static_cast<unsigned char>(text[i])) && i - digits_begin < 10)
+    {
+      value = value * 10 + (text[i] - '0');
+      ++i;
+    }
+
+    if (i == digits_begin || value > 2147483647LL ||
+        (i < text.size() && text[i] != ')' && !isspace(static_cast<unsigned char>(text[i]))))
+      return false;
+
+    values.push_back(static_cast<int>(negative ? -value : value));
+  }
+
+  pos = i + 1;
+  return true;
+}
+
+/** Moves the integers of the '(tiles ...)' lists of 'text' into
+    'arrays'. The lists are replaced by '(tiles "<index>")', padded
+    with the newlines they spanned to keep line numbers intact. */
+std::string
+extract_integer_lists(const std::string& text, std::vector<std::vector<int>>& arrays)
+{
+  static const std::string s_key = "(tiles";
+
+  std::string result;
+  result.reserve(text.size());
+
+  size_t i = 0;
+  while (i < text.size())
+  {
+    const char c = text[i];
+    if (c == '"')
+    {
+      // Copy string literals as they are, escapes included.
+      size_t end = i + 1;
+      while (end < text.size() && text[end] != '"')
+        end += (text[end] == '\\') ? 2 : 1;
+      end = std::min(end + 1, text.size());
+      result.append(text, i, end - i);
+      i = end;
+    }
+    else if (c == ';')
+    {
+      size_t end = text.find('\n', i);
+      end = (end == std::string::npos) ? text.size() : end;
+      result.append(text, i, end - i);
+      i = end;
+    }
+    else if (c == '(' && text.compare(i, s_key.size(), s_key) == 0 &&
+             i + s_key.size() < text.size() && isspace(static_cast<unsigned char>(text[i + s_key.size()])))
+    {
+      size_t end = i + s_key.size();
+      std::vector<int> values;
+      int newlines = 0;
+      if (parse_integer_list(text, end, values, newlines) && !values.empty())
+      {
+        result += s_key;
+        result += " \"";
+        result += std::to_string(arrays.size());
+        result += '"';
+        result.append(newlines, '\n');
+        result += ')';
+        arrays.push_back(std::move(values));
+        i = end;
+      }
+      else
+      {
+        result += c;
+        ++i;
+      }
+    }
+    else
+    {
+      result += c;
+      ++i;
+    }
+  }
+  return result;
+}
+
+} // namespace
+
 ReaderDocument
 ReaderDocument::from_string(const std::string& string, const std::string& filename, int depth)
 {
@@ -52,9 +168,20 @@ ReaderDocument::from_file(const std::string& filename, int depth)
   }
 }
 
-ReaderDocument::ReaderDocument(const std::string& filename, sexp::Value sx) :
+ReaderDocument
+ReaderDocument::from_level_string(const std::string& string, const std::string& filename)
+{
+  std::vector<std::vector<int>> arrays;
+  std::istringstream stream(extract_integer_lists(string, arrays));
+  sexp::Value sx = sexp::Parser::from_stream(stream, sexp::Parser::USE_ARRAYS);
+  return ReaderDocument(filename, std::move(sx), std::move(arrays));
+}
+
+ReaderDocument::ReaderDocument(const std::string& filename, sexp::Value sx,
+                               std::vector<std::vector<int>> integer_arrays) :
   m_filename(filename),
-  m_sx(std::move(sx))
+  m_sx(std::move(sx)),
+  m_integer_arrays(std::move(integer_arrays))
 {
 }
 
@@ -75,3 +202,18 @@ ReaderDocument::get_directory() const
 {
   return FileSystem::dirname(m_filename);
 }
+
+const std::vector<int>*
+ReaderDocument::get_integer_array(const sexp::Value& sx) const
+{
+  if (!sx.is_string())
+    return nullptr;
+
+  const std::string& index = sx.as_string();
+  if (index.empty() || index.size() > 9 ||
+      index.find_first_not_of("0123456789") != std::string::npos)
+    return nullptr;
+
+  const size_t i = std::stoul(index);
+  return i < m_integer_arrays.size() ? &m_integer_arrays[i] : nullptr;
+}
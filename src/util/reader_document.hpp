@@ -18,6 +18,7 @@
 
 #include <istream>
 #include <sexp/value.hpp>
+#include <vector>
 
 #include "util/reader_object.hpp"
 
@@ -30,8 +31,15 @@ public:
   static ReaderDocument from_stream(std::istream& stream, const std::string& filename = "<stream>", int depth = -1);
   static ReaderDocument from_file(const std::string& filename, int depth = -1);
 
+  /** Like from_string(), but the integers of '(tiles ...)' lists,
+      which hold the tilemaps of level files, are read straight into
+      integer arrays instead of becoming sexp values. The lists refer
+      to their array by a string, see get_integer_array(). */
+  static ReaderDocument from_level_string(const std::string& string, const std::string& filename);
+
 public:
-  ReaderDocument(const std::string& filename, sexp::Value sx);
+  ReaderDocument(const std::string& filename, sexp::Value sx,
+                 std::vector<std::vector<int>> integer_arrays = {});
 
   /** Returns the root object */
   ReaderObject get_root() const;
@@ -44,7 +52,13 @@ public:
 
   inline const sexp::Value& get_sexp() const { return m_sx; }
 
+  /** Returns the integer array 'sx' refers to, nullptr if it isn't a
+      reference to one. */
+  const std::vector<int>* get_integer_array(const sexp::Value& sx) const;
+  inline const std::vector<std::vector<int>>& get_integer_arrays() const { return m_integer_arrays; }
+
 private:
   std::string m_filename;
   sexp::Value m_sx;
+  std::vector<std::vector<int>> m_integer_arrays;
 };
@@ -16,6 +16,7 @@
 
 #include "util/reader_mapping.hpp"
 
+#include <algorithm>
 #include <sexp/io.hpp>
 #include <sstream>
 #include <stdexcept>
@@ -25,12 +26,57 @@
 #include "util/reader_document.hpp"
 #include "util/reader_error.hpp"
 
+namespace {
+
+/** Mappings with fewer entries are faster to scan than to index. */
+const size_t s_min_indexed_size = 8;
+
+/** Appends the 'count' values returned by 'get' to 'value', using the
+    absolute value of negative ones as a repeater for the next value.
+    Returns the index of the value a repeater is missing at, if any. */
+template<typename Get>
+std::optional<size_t>
+decompress(size_t count, const Get& get, std::vector<unsigned int>& value)
+{
+  int repeater = 0;
+  for (size_t i = 0; i < count; ++i)
+  {
+    const int val = get(i);
+    if (repeater)
+    {
+      if (val < 0)
+        return i;
+
+      value.insert(value.end(), repeater, val);
+      repeater = 0;
+    }
+    else if (val < 0)
+    {
+      repeater = -val;
+    }
+    else
+    {
+      value.push_back(val);
+    }
+  }
+
+  if (repeater)
+    return count - 1;
+  return std::nullopt;
+}
+
+} // namespace
+
 bool ReaderMapping::s_translations_enabled = true;
+bool ReaderMapping::s_key_index_enabled = true;
 
 ReaderMapping::ReaderMapping(const ReaderDocument& doc, const sexp::Value& sx) :
   m_doc(doc),
   m_sx(sx),
-  m_arr([this]() -> decltype(m_arr){ assert_is_array(m_doc, m_sx); return m_sx.as_array();}())
+  m_arr([this]() -> decltype(m_arr){ assert_is_array(m_doc, m_sx); return m_sx.as_array();}()),
+  m_key_index(),
+  m_key_index_end(0),
+  m_key_indexed(false)
 {
 }
 
@@ -48,6 +94,25 @@ ReaderMapping::get_item(const char* key) const
   if (!key || !key[0]) // Check whether key is valid and non-empty
     return nullptr;
 
+  if (s_key_index_enabled && m_arr.size() > s_min_indexed_size)
+  {
+    if (!m_key_indexed)
+      build_key_index();
+
+    const std::string_view name(key);
+    auto it = std::lower_bound(m_key_index.begin(), m_key_index.end(), name,
+                               [](const std::pair<std::string_view, size_t>& entry, std::string_view rhs) {
+                                 return entry.first < rhs;
+                               });
+    if (it != m_key_index.end() && it->first == name)
+      return &m_arr[it->second];
+
+    // Without malformed entries the key just isn't there, otherwise
+    // the scan below reports the first one, as it always did.
+    if (m_key_index_end == m_arr.size())
+      return nullptr;
+  }
+
   for (size_t i = 1; i < m_arr.size(); ++i)
   {
     auto const& pair = m_arr[i];
@@ -66,6 +131,29 @@ ReaderMapping::get_item(const char* key) const
   return nullptr;
 }
 
+void
+ReaderMapping::build_key_index() const
+{
+  m_key_index.clear();
+  m_key_index.reserve(m_arr.size() - 1);
+
+  m_key_index_end = m_arr.size();
+  for (size_t i = 1; i < m_arr.size(); ++i)
+  {
+    const auto& pair = m_arr[i];
+    if (!pair.is_array() || pair.as_array().empty() || !pair.as_array()[0].is_symbol())
+    {
+      m_key_index_end = i;
+      break;
+    }
+    m_key_index.emplace_back(pair.as_array()[0].as_string(), i);
+  }
+
+  // Duplicate keys stay in order of position, lookups find the first.
+  std::sort(m_key_index.begin(), m_key_index.end());
+  m_key_indexed = true;
+}
+
 #define GET_VALUE_MACRO(type, checker, getter)                          \
   auto const sx = get_item(key);                                        \
   if (!sx) {                                                            \
@@ -215,36 +303,28 @@ ReaderMapping::get_compressed(const char* key, std::vector<unsigned int>& value,
   assert_is_array(m_doc, *sx);
   value.clear();
   const auto& item = sx->as_array();
-  value.reserve(item.size());
 
-  int repeater = 0;
-  for (size_t i = 1; i < item.size(); ++i)
+  // Tilemaps of level files were read into an integer array directly.
+  if (item.size() == 2)
   {
-    assert_is_integer(m_doc, item[i]);
-
-    const int val = item[i].as_int();
-    if (repeater)
-    {
-      if (val < 0)
-      {
-        raise_exception(m_doc, item[i], "expected positive integer after repeater");
-      }
-      value.insert(value.end(), repeater, val);
-      repeater = 0;
-    }
-    else if (val < 0)
-    {
-      repeater = -val;
-    }
-    else
+    if (const std::vector<int>* array = m_doc.get_integer_array(item[1]))
     {
-      value.push_back(val);
+      value.reserve(array->size());
+      if (decompress(array->size(), [array](size_t i) { return (*array)[i]; }, value))
+        raise_exception(m_doc, item[1], "expected positive integer after repeater");
+      return true;
     }
   }
-  if (repeater)
-  {
-    raise_exception(m_doc, item.back(), "expected positive integer after repeater");
-  }
+
+  value.reserve(item.size());
+  const auto error = decompress(item.size() - 1,
+                                [this, &item](size_t i) {
+                                  assert_is_integer(m_doc, item[i + 1]);
+                                  return item[i + 1].as_int();
+                                },
+                                value);
+  if (error)
+    raise_exception(m_doc, item[*error + 1], "expected positive integer after repeater");
   return true;
 }
 
@@ -18,6 +18,9 @@
 
 #include <cstdint>
 #include <optional>
+#include <string_view>
+#include <utility>
+#include <vector>
 
 #include "util/reader_iterator.hpp"
 #include "util/uid.hpp"
@@ -34,6 +37,10 @@ class ReaderMapping final
 public:
   static bool s_translations_enabled;
 
+  /** Whether larger mappings look keys up through a sorted index,
+      only meant to be turned off for benchmarking. */
+  static bool s_key_index_enabled;
+
 public:
   // sx should point to (section (name value)...)
   ReaderMapping(const ReaderDocument& doc, const sexp::Value& sx);
@@ -92,8 +99,16 @@ private:
   /** Returns pointer to (key value) */
   const sexp::Value* get_item(const char* key) const;
 
+  void build_key_index() const;
+
 private:
   const ReaderDocument& m_doc;
   const sexp::Value& m_sx;
   const std::vector<sexp::Value>& m_arr;
+
+  /** Keys and positions of the entries before the first malformed
+      one, sorted by key and then position. Built on the first lookup. */
+  mutable std::vector<std::pair<std::string_view, size_t>> m_key_index;
+  mutable size_t m_key_index_end;
+  mutable bool m_key_indexed;
 };
@@ -18,10 +18,15 @@
 
 #include <algorithm>
 #include <array>
+#include <assert.h>
+#include <memory>
+#include <new>
+#include <type_traits>
 
 #include "supertux/globals.hpp"
 #include "util/log.hpp"
 #include "util/obstackpp.hpp"
+#include "video/compositor.hpp"
 #include "video/drawing_context.hpp"
 #include "video/drawing_request.hpp"
 #include "video/painter.hpp"
@@ -32,7 +37,11 @@
 Canvas::Canvas(DrawingContext& context, obstack& obst) :
   m_context(context),
   m_obst(obst),
-  m_requests()
+  m_requests(),
+  m_merged(false),
+  m_sort_buckets(),
+  m_sorted_requests(),
+  m_pixel_outputs()
 {
   m_requests.reserve(500);
 }
@@ -45,23 +54,192 @@ Canvas::~Canvas()
 void
 Canvas::clear()
 {
-  for (const auto& request : m_requests)
+  // The requests and their arrays belong to the obstack and need no
+  // destruction.
+  m_requests.clear();
+  m_merged = false;
+  m_pixel_outputs.clear();
+}
+
+namespace {
+
+bool can_merge(const DrawingRequest& lhs, const DrawingRequest& rhs)
+{
+  if (lhs.get_type() != RequestType::TEXTURE || rhs.get_type() != RequestType::TEXTURE)
+    return false;
+
+  const auto& lhs_texture = static_cast<const TextureRequest&>(lhs);
+  const auto& rhs_texture = static_cast<const TextureRequest&>(rhs);
+
+  return lhs.layer == rhs.layer &&
+         lhs.flip == rhs.flip &&
+         lhs.blend == rhs.blend &&
+         lhs.viewport == rhs.viewport &&
+         lhs_texture.texture == rhs_texture.texture &&
+         lhs_texture.displacement_texture == rhs_texture.displacement_texture;
+}
+
+static_assert(std::is_trivially_destructible<TextureRequest>::value &&
+              std::is_trivially_destructible<GradientRequest>::value &&
+              std::is_trivially_destructible<FillRectRequest>::value &&
+              std::is_trivially_destructible<InverseEllipseRequest>::value &&
+              std::is_trivially_destructible<LineRequest>::value &&
+              std::is_trivially_destructible<TriangleRequest>::value &&
+              std::is_trivially_destructible<GetPixelRequest>::value,
+              "drawing requests are never destructed");
+
+} // namespace
+
+void
+Canvas::merge_requests()
+{
+  Compositor::s_frame_requests += static_cast<int>(m_requests.size());
+
+  size_t count = 0;
+  for (size_t begin = 0; begin < m_requests.size();)
   {
-    request->~DrawingRequest();
+    size_t end = begin + 1;
+    while (end < m_requests.size() && can_merge(*m_requests[begin], *m_requests[end]))
+      ++end;
+
+    if (end - begin > 1)
+      merge_run(begin, end);
+
+    m_requests[count++] = m_requests[begin];
+    begin = end;
   }
-  m_requests.clear();
+  m_requests.resize(count);
+
+  m_merged = true;
+}
+
+void
+Canvas::merge_run(size_t begin, size_t end)
+{
+  size_t size = 0;
+  for (size_t i = begin; i < end; ++i)
+    size += static_cast<const TextureRequest*>(m_requests[i])->srcrects.size();
+
+  auto srcrects = allocate_array<Rectf>(size);
+  auto dstrects = allocate_array<Rectf>(size);
+  auto angles = allocate_array<float>(size);
+  auto colors = allocate_array<Color>(size);
+
+  size_t pos = 0;
+  for (size_t i = begin; i < end; ++i)
+  {
+    const auto& request = static_cast<const TextureRequest&>(*m_requests[i]);
+    const size_t len = request.srcrects.size();
+
+    std::uninitialized_copy(request.srcrects.begin(), request.srcrects.end(), srcrects.data() + pos);
+    std::uninitialized_copy(request.dstrects.begin(), request.dstrects.end(), dstrects.data() + pos);
+    std::uninitialized_copy(request.angles.begin(), request.angles.end(), angles.data() + pos);
+
+    if (!request.colors.empty())
+    {
+      std::uninitialized_copy(request.colors.begin(), request.colors.end(), colors.data() + pos);
+    }
+    else
+    {
+      const Color color(request.color.red, request.color.green, request.color.blue,
+                        request.color.alpha * request.alpha);
+      std::uninitialized_fill_n(colors.data() + pos, len, color);
+    }
+
+    pos += len;
+  }
+
+  // The requests merged away stay in the obstack until it is freed.
+  auto& target = static_cast<TextureRequest&>(*m_requests[begin]);
+  target.srcrects = srcrects;
+  target.dstrects = dstrects;
+  target.angles = angles;
+  target.colors = colors;
+  target.color = Color::WHITE;
+  target.alpha = 1.0f;
+}
+
+void
+Canvas::sort_requests()
+{
+  // A frame only uses a handful of distinct layers, but the layer values
+  // themselves are arbitrary (tilemaps and the editor pick their own),
+  // so count the requests per distinct layer and scatter them into
+  // place. That keeps submission order within a layer without going
+  // through a comparison sort.
+  const int max_buckets = 128;
+
+  auto& buckets = m_sort_buckets;
+  buckets.clear();
+  size_t bucket = 0;
+  for (const auto* request : m_requests)
+  {
+    // Consecutive requests mostly share their layer.
+    if (buckets.empty() || buckets[bucket].first != request->layer)
+    {
+      auto it = std::find_if(buckets.begin(), buckets.end(),
+                             [request](const std::pair<int, size_t>& b) {
+                               return b.first == request->layer;
+                             });
+      if (it == buckets.end())
+      {
+        if (static_cast<int>(buckets.size()) == max_buckets)
+        {
+          std::stable_sort(m_requests.begin(), m_requests.end(),
+                           [](const DrawingRequest* r1, const DrawingRequest* r2){
+                             return r1->layer < r2->layer;
+                           });
+          return;
+        }
+        it = buckets.insert(buckets.end(), { request->layer, 0 });
+      }
+      bucket = it - buckets.begin();
+    }
+    buckets[bucket].second += 1;
+  }
+
+  if (buckets.size() < 2)
+    return;
+
+  std::sort(buckets.begin(), buckets.end());
+
+  // Turn the counts into the start offsets of each layer.
+  size_t offset = 0;
+  for (auto& b : buckets)
+  {
+    const size_t count = b.second;
+    b.second = offset;
+    offset += count;
+  }
+
+  auto& sorted = m_sorted_requests;
+  sorted.clear();
+  sorted.resize(m_requests.size());
+  bucket = 0;
+  for (auto* request : m_requests)
+  {
+    if (buckets[bucket].first != request->layer)
+    {
+      bucket = std::lower_bound(buckets.begin(), buckets.end(), request->layer,
+                                [](const std::pair<int, size_t>& b, int layer) {
+                                  return b.first < layer;
+                                }) - buckets.begin();
+    }
+    sorted[buckets[bucket].second++] = request;
+  }
+  m_requests.swap(sorted);
 }
 
 void
 Canvas::render(Renderer& renderer, Filter filter)
 {
-  // On a regular level, each frame has around 50-250 requests (before
-  // batching it was 1000-3000), the sort comparator function is
-  // called approximatly 3-7 times for each request.
-  std::stable_sort(m_requests.begin(), m_requests.end(),
-                   [](const DrawingRequest* r1, const DrawingRequest* r2){
-                     return r1->layer < r2->layer;
-                   });
+  // Requests only get added before the first render pass, so sorting
+  // and merging them once is enough for the passes that follow.
+  if (!m_merged)
+  {
+    sort_requests();
+    merge_requests();
+  }
 
   Painter& painter = renderer.get_painter();
 
@@ -74,6 +252,8 @@ Canvas::render(Renderer& renderer, Filter filter)
     else if (filter == ABOVE_LIGHTMAP && request.layer <= LAYER_LIGHTMAP)
       continue;
 
+    ++Compositor::s_frame_draw_calls;
+
     painter.set_clip_rect(request.viewport);
 
     switch (request.get_type())
@@ -133,11 +313,14 @@ Canvas::draw_surface(const SurfacePtr& surface,
   request->flip = m_context.transform().flip ^ surface->get_flip();
   request->blend = blend;
 
-  request->srcrects.emplace_back(Rectf(surface->get_region()));
-  request->dstrects.emplace_back(Rectf(apply_translate(position) * scale(),
-                                 Sizef(static_cast<float>(surface->get_width()) * scale(),
-                                       static_cast<float>(surface->get_height()) * scale())));
-  request->angles.emplace_back(angle);
+  request->srcrects = allocate_array<Rectf>(1);
+  new (request->srcrects.data()) Rectf(surface->get_region());
+  request->dstrects = allocate_array<Rectf>(1);
+  new (request->dstrects.data()) Rectf(apply_translate(position) * scale(),
+                                       Sizef(static_cast<float>(surface->get_width()) * scale(),
+                                             static_cast<float>(surface->get_height()) * scale()));
+  request->angles = allocate_array<float>(1);
+  request->angles[0] = angle;
   request->texture = surface->get_texture().get();
   request->displacement_texture = surface->get_displacement_texture().get();
   request->color = color;
@@ -172,9 +355,13 @@ Canvas::draw_surface_part(const SurfacePtr& surface, const Rectf& srcrect, const
   request->alpha = m_context.transform().alpha * style.get_alpha();
   request->blend = style.get_blend();
 
-  request->srcrects.emplace_back(srcrect);
-  request->dstrects.emplace_back(apply_translate(dstrect.p1())*scale(), dstrect.get_size()*scale());
-  request->angles.emplace_back(0.0f);
+  request->srcrects = allocate_array<Rectf>(1);
+  new (request->srcrects.data()) Rectf(srcrect.moved(Vector(static_cast<float>(surface->get_region().left),
+                                                            static_cast<float>(surface->get_region().top))));
+  request->dstrects = allocate_array<Rectf>(1);
+  new (request->dstrects.data()) Rectf(apply_translate(dstrect.p1())*scale(), dstrect.get_size()*scale());
+  request->angles = allocate_array<float>(1);
+  request->angles[0] = 0.0f;
   request->texture = surface->get_texture().get();
   request->displacement_texture = surface->get_displacement_texture().get();
   request->color = style.get_color();
@@ -184,28 +371,26 @@ Canvas::draw_surface_part(const SurfacePtr& surface, const Rectf& srcrect, const
 
 void
 Canvas::draw_surface_batch(const SurfacePtr& surface,
-                           std::vector<Rectf> srcrects,
-                           std::vector<Rectf> dstrects,
+                           const std::vector<Rectf>& srcrects,
+                           const std::vector<Rectf>& dstrects,
                            const Color& color,
                            int layer)
 {
-  const size_t len = srcrects.size();
-  draw_surface_batch(surface,
-                     std::move(srcrects),
-                     std::move(dstrects),
-                     std::vector<float>(len, 0.0f),
-                     color, layer);
+  draw_surface_batch(surface, srcrects, dstrects, {}, color, layer);
 }
 
 void
 Canvas::draw_surface_batch(const SurfacePtr& surface,
-                           std::vector<Rectf> srcrects,
-                           std::vector<Rectf> dstrects,
-                           std::vector<float> angles,
+                           const std::vector<Rectf>& srcrects,
+                           const std::vector<Rectf>& dstrects,
+                           const std::vector<float>& angles,
                            const Color& color,
                            int layer)
 {
-  if (!surface) return;
+  if (!surface || srcrects.empty()) return;
+
+  assert(srcrects.size() == dstrects.size());
+  assert(angles.empty() || angles.size() == srcrects.size());
 
   auto request = new(m_obst) TextureRequest(m_context.transform());
 
@@ -213,15 +398,22 @@ Canvas::draw_surface_batch(const SurfacePtr& surface,
   request->flip = m_context.transform().flip ^ surface->get_flip();
   request->color = color;
 
-  request->srcrects = std::move(srcrects);
-  request->dstrects = std::move(dstrects);
-  request->angles = std::move(angles);
+  request->srcrects = allocate_array<Rectf>(srcrects.size());
+  std::uninitialized_copy(srcrects.begin(), srcrects.end(), request->srcrects.data());
 
-  for (auto& dstrect : request->dstrects)
+  request->dstrects = allocate_array<Rectf>(dstrects.size());
+  for (size_t i = 0; i < dstrects.size(); ++i)
   {
-    dstrect = Rectf(apply_translate(dstrect.p1())*scale(), dstrect.get_size()*scale());
+    new (&request->dstrects[i]) Rectf(apply_translate(dstrects[i].p1())*scale(), dstrects[i].get_size()*scale());
   }
 
+  // No angles means none of the rects is rotated.
+  request->angles = allocate_array<float>(srcrects.size());
+  if (angles.empty())
+    std::uninitialized_fill_n(request->angles.data(), srcrects.size(), 0.0f);
+  else
+    std::uninitialized_copy(angles.begin(), angles.end(), request->angles.data());
+
   request->texture = surface->get_texture().get();
   request->displacement_texture = surface->get_displacement_texture().get();
 
@@ -373,7 +565,8 @@ Canvas::get_pixel(const Vector& position, const std::shared_ptr<Color>& color_ou
 
   request->layer = LAYER_GETPIXEL;
   request->pos = pos;
-  request->color_ptr = color_out;
+  request->color_ptr = color_out.get();
+  m_pixel_outputs.push_back(color_out);
 
   m_requests.push_back(request);
 }
@@ -18,6 +18,7 @@
 #pragma once
 
 #include <string>
+#include <utility>
 #include <vector>
 #include <memory>
 #include <obstack.h>
@@ -26,6 +27,7 @@
 #include "math/vector.hpp"
 #include "video/blend.hpp"
 #include "video/color.hpp"
+#include "video/drawing_request.hpp"
 #include "video/drawing_target.hpp"
 #include "video/font.hpp"
 #include "video/font_ptr.hpp"
@@ -37,7 +39,6 @@
 class DrawingContext;
 class Renderer;
 class VideoSystem;
-struct DrawingRequest;
 
 class Canvas final
 {
@@ -51,19 +52,21 @@ public:
   void draw_surface(const SurfacePtr& surface, const Vector& position, int layer);
   void draw_surface(const SurfacePtr& surface, const Vector& position, float angle, const Color& color, const Blend& blend,
                     int layer);
+  /** 'srcrect' is relative to the region of 'surface'. */
   void draw_surface_part(const SurfacePtr& surface, const Rectf& srcrect, const Rectf& dstrect,
                          int layer, const PaintStyle& style = PaintStyle());
   void draw_surface_scaled(const SurfacePtr& surface, const Rectf& dstrect,
                            int layer, const PaintStyle& style = PaintStyle());
+  /** The rects are copied, the vectors can be reused right away. */
   void draw_surface_batch(const SurfacePtr& surface,
-                          std::vector<Rectf> srcrects,
-                          std::vector<Rectf> dstrects,
+                          const std::vector<Rectf>& srcrects,
+                          const std::vector<Rectf>& dstrects,
                           const Color& color,
                           int layer);
   void draw_surface_batch(const SurfacePtr& surface,
-                          std::vector<Rectf> srcrects,
-                          std::vector<Rectf> dstrects,
-                          std::vector<float> angles,
+                          const std::vector<Rectf>& srcrects,
+                          const std::vector<Rectf>& dstrects,
+                          const std::vector<float>& angles,
                           const Color& color,
                           int layer);
   Rectf draw_text(const FontPtr& font, const std::string& text,
@@ -100,6 +103,22 @@ public:
   inline DrawingContext& get_context() { return m_context; }
 
 private:
+  /** Stable sort of the requests by layer, bucketed by distinct layer
+      value instead of comparing requests against each other. */
+  void sort_requests();
+
+  /** Merges runs of adjacent texture requests that share texture,
+      blend mode, flip, layer and viewport into a single request. */
+  void merge_requests();
+  void merge_run(size_t begin, size_t end);
+
+  /** Returns uninitialized room for 'size' elements in the obstack. */
+  template<typename T>
+  inline RequestArray<T> allocate_array(size_t size)
+  {
+    return RequestArray<T>(static_cast<T*>(obstack_alloc(&m_obst, static_cast<int>(sizeof(T) * size))), size);
+  }
+
   Vector apply_translate(const Vector& pos) const;
   float scale() const;
 
@@ -107,6 +126,14 @@ private:
   DrawingContext& m_context;
   obstack& m_obst;
   std::vector<DrawingRequest*> m_requests;
+  bool m_merged;
+
+  /** Scratch space of sort_requests(), kept to not allocate every frame. */
+  std::vector<std::pair<int, size_t>> m_sort_buckets;
+  std::vector<DrawingRequest*> m_sorted_requests;
+
+  /** Targets of the pending GetPixelRequests. */
+  std::vector<std::shared_ptr<Color>> m_pixel_outputs;
 
 private:
   Canvas(const Canvas&) = delete;
@@ -22,9 +22,12 @@
 #include "video/drawing_request.hpp"
 #include "video/painter.hpp"
 #include "video/renderer.hpp"
+#include "video/texture_manager.hpp"
 #include "video/video_system.hpp"
 
 bool Compositor::s_render_lighting = true;
+int Compositor::s_frame_requests = 0;
+int Compositor::s_frame_draw_calls = 0;
 
 Compositor::Compositor(VideoSystem& video_system, float time_offset) :
   m_video_system(video_system),
@@ -51,6 +54,11 @@ Compositor::make_context(bool overlay)
 void
 Compositor::render()
 {
+  s_frame_requests = 0;
+  s_frame_draw_calls = 0;
+
+  TextureManager::current()->update();
+
   auto& lightmap = m_video_system.get_lightmap();
 
   bool use_lightmap = std::any_of(m_drawing_contexts.begin(), m_drawing_contexts.end(),
@@ -112,11 +120,15 @@ Compositor::render()
 
         request.blend = Blend::MOD;
 
-        request.srcrects.emplace_back(0.0f, 0.0f,
-                                      static_cast<float>(texture->get_image_width()),
-                                      static_cast<float>(texture->get_image_height()));
-        request.dstrects.emplace_back(Vector(0.0f, 0.0f), lightmap.get_logical_size());
-        request.angles.emplace_back(0.0f);
+        Rectf srcrect(0.0f, 0.0f,
+                      static_cast<float>(texture->get_image_width()),
+                      static_cast<float>(texture->get_image_height()));
+        Rectf dstrect(Vector(0.0f, 0.0f), lightmap.get_logical_size());
+        float angle = 0.0f;
+
+        request.srcrects = RequestArray<Rectf>(&srcrect, 1);
+        request.dstrects = RequestArray<Rectf>(&dstrect, 1);
+        request.angles = RequestArray<float>(&angle, 1);
 
         request.texture = texture.get();
         request.color = Color::WHITE;
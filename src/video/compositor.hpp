@@ -31,6 +31,11 @@ public:
   /** Debug flag to disable lighting, used in the editor */
   static bool s_render_lighting;
 
+  /** Number of drawing requests and of the draw calls they got merged
+      into during the last render(), for the FPS display */
+  static int s_frame_requests;
+  static int s_frame_draw_calls;
+
 public:
   Compositor(VideoSystem& video_system, float time_offset);
   ~Compositor();
@@ -16,8 +16,8 @@
 
 #pragma once
 
+#include <stddef.h>
 #include <string>
-#include <memory>
 
 #include "math/rectf.hpp"
 #include "math/sizef.hpp"
@@ -35,8 +35,34 @@ enum class RequestType
   TEXTURE, GRADIENT, FILLRECT, INVERSEELLIPSE, GETPIXEL, LINE, TRIANGLE
 };
 
+/** View on an array whose memory is owned elsewhere, usually by the
+    obstack the Canvas allocates its requests from, so that requests
+    can stay trivially destructible. */
+template<typename T>
+class RequestArray final
+{
+public:
+  RequestArray() : m_data(nullptr), m_size(0) {}
+  RequestArray(T* data, size_t size) : m_data(data), m_size(size) {}
+
+  inline size_t size() const { return m_size; }
+  inline bool empty() const { return m_size == 0; }
+
+  inline T* data() const { return m_data; }
+  inline T* begin() const { return m_data; }
+  inline T* end() const { return m_data + m_size; }
+  inline T& operator[](size_t i) const { return m_data[i]; }
+
+private:
+  T* m_data;
+  size_t m_size;
+};
+
+/** Requests are allocated from an obstack and never destructed, so all
+    of them have to be trivially destructible. */
 struct DrawingRequest
 {
+  const RequestType type;
   int layer;
   Flip flip;
   float alpha;
@@ -44,39 +70,43 @@ struct DrawingRequest
   const Rect viewport;
 
   DrawingRequest() = delete;
-  DrawingRequest(const DrawingTransform& transform) :
+  DrawingRequest(RequestType type_, const DrawingTransform& transform) :
+    type(type_),
     layer(),
     flip(transform.flip),
     alpha(transform.alpha),
     blend(),
     viewport(transform.viewport)
   {}
-  virtual ~DrawingRequest() {}
 
-  virtual RequestType get_type() const = 0;
+  inline RequestType get_type() const { return type; }
 };
 
 struct TextureRequest : public DrawingRequest
 {
   TextureRequest(const DrawingTransform& transform) :
-    DrawingRequest(transform),
+    DrawingRequest(RequestType::TEXTURE, transform),
     texture(),
     displacement_texture(),
     srcrects(),
     dstrects(),
     angles(),
-    color(1.0f, 1.0f, 1.0f)
+    color(1.0f, 1.0f, 1.0f),
+    colors()
   {}
 
-  RequestType get_type() const override { return RequestType::TEXTURE; }
-
   const Texture* texture;
   const Texture* displacement_texture;
-  std::vector<Rectf> srcrects;
-  std::vector<Rectf> dstrects;
-  std::vector<float> angles;
+  RequestArray<Rectf> srcrects;
+  RequestArray<Rectf> dstrects;
+  RequestArray<float> angles;
   Color color;
 
+  /** Per-rect colors with the alpha already applied, filled in when
+      Canvas merges several requests into one. If not empty, 'color'
+      and 'alpha' are ignored. */
+  RequestArray<Color> colors;
+
 private:
   TextureRequest(const TextureRequest&) = delete;
   TextureRequest& operator=(const TextureRequest&) = delete;
@@ -84,8 +114,8 @@ private:
 
 struct GradientRequest : public DrawingRequest
 {
-  GradientRequest(const DrawingTransform& transform)  :
-    DrawingRequest(transform),
+  GradientRequest(const DrawingTransform& transform) :
+    DrawingRequest(RequestType::GRADIENT, transform),
     pos(0.0f, 0.0f),
     size(0.0f, 0.0f),
     top(),
@@ -94,8 +124,6 @@ struct GradientRequest : public DrawingRequest
     region()
   {}
 
-  RequestType get_type() const override { return RequestType::GRADIENT; }
-
   Vector pos;
   Vector size;
   Color top;
@@ -107,14 +135,12 @@ struct GradientRequest : public DrawingRequest
 struct FillRectRequest : public DrawingRequest
 {
   FillRectRequest(const DrawingTransform& transform) :
-    DrawingRequest(transform),
+    DrawingRequest(RequestType::FILLRECT, transform),
     rect(),
     color(),
     radius()
   {}
 
-  RequestType get_type() const override { return RequestType::FILLRECT; }
-
   Rectf rect;
   Color color;
   float radius;
@@ -123,14 +149,12 @@ struct FillRectRequest : public DrawingRequest
 struct InverseEllipseRequest : public DrawingRequest
 {
   InverseEllipseRequest(const DrawingTransform& transform) :
-    DrawingRequest(transform),
+    DrawingRequest(RequestType::INVERSEELLIPSE, transform),
     pos(0.0f, 0.0f),
     size(0.0f, 0.0f),
     color()
   {}
 
-  RequestType get_type() const override { return RequestType::INVERSEELLIPSE; }
-
   Vector pos;
   Vector size;
   Color color;
@@ -139,14 +163,12 @@ struct InverseEllipseRequest : public DrawingRequest
 struct LineRequest : public DrawingRequest
 {
   LineRequest(const DrawingTransform& transform) :
-    DrawingRequest(transform),
+    DrawingRequest(RequestType::LINE, transform),
     pos(0.0f, 0.0f),
     dest_pos(0.0f, 0.0f),
     color()
   {}
 
-  RequestType get_type() const override { return RequestType::LINE; }
-
   Vector pos;
   Vector dest_pos;
   Color color;
@@ -155,15 +177,13 @@ struct LineRequest : public DrawingRequest
 struct TriangleRequest : public DrawingRequest
 {
   TriangleRequest(const DrawingTransform& transform) :
-    DrawingRequest(transform),
+    DrawingRequest(RequestType::TRIANGLE, transform),
     pos1(0.0f, 0.0f),
     pos2(0.0f, 0.0f),
     pos3(0.0f, 0.0f),
     color()
   {}
 
-  RequestType get_type() const override { return RequestType::TRIANGLE; }
-
   Vector pos1, pos2, pos3;
   Color  color;
 };
@@ -171,15 +191,14 @@ struct TriangleRequest : public DrawingRequest
 struct GetPixelRequest : public DrawingRequest
 {
   GetPixelRequest(const DrawingTransform& transform) :
-    DrawingRequest(transform),
+    DrawingRequest(RequestType::GETPIXEL, transform),
     pos(0.0f, 0.0f),
     color_ptr()
   {}
 
-  RequestType get_type() const override { return RequestType::GETPIXEL; }
-
   Vector pos;
-  std::shared_ptr<Color> color_ptr;
+  /** Kept alive by the Canvas until the request is rendered. */
+  Color* color_ptr;
 
 private:
   GetPixelRequest(const GetPixelRequest&) = delete;
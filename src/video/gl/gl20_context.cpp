@@ -135,6 +135,26 @@ GL20Context::set_color(const Color& color)
   assert_gl();
 }
 
+GLint
+GL20Context::set_vertices(const GLVertex* data, size_t count)
+{
+  assert_gl();
+
+  // Client side arrays can simply point into the interleaved data.
+  glEnableClientState(GL_VERTEX_ARRAY);
+  glVertexPointer(2, GL_FLOAT, sizeof(GLVertex), &data->x);
+
+  glEnableClientState(GL_TEXTURE_COORD_ARRAY);
+  glTexCoordPointer(2, GL_FLOAT, sizeof(GLVertex), &data->u);
+
+  glEnableClientState(GL_COLOR_ARRAY);
+  glColorPointer(4, GL_FLOAT, sizeof(GLVertex), &data->r);
+
+  assert_gl();
+
+  return 0;
+}
+
 void
 GL20Context::bind_texture(const Texture& texture, const Texture* displacement_texture)
 {
@@ -42,11 +42,15 @@ public:
   virtual void set_colors(const float* data, size_t size) override;
   virtual void set_color(const Color& color) override;
 
+  virtual GLint set_vertices(const GLVertex* data, size_t count) override;
+
   virtual void bind_texture(const Texture& texture, const Texture* displacement_texture) override;
   virtual void bind_no_texture() override;
 
   virtual void draw_arrays(GLenum type, GLint first, GLsizei count) override;
 
+  virtual bool supports_instancing() const override { return false; }
+
   virtual bool supports_framebuffer() const override { return false; }
 
 private:
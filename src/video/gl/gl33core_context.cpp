@@ -176,6 +176,23 @@ GL33CoreContext::set_color(const Color& color)
   m_vertex_arrays->set_color(color);
 }
 
+GLint
+GL33CoreContext::set_vertices(const GLVertex* data, size_t count)
+{
+  return m_vertex_arrays->set_vertices(data, count);
+}
+
+void
+GL33CoreContext::draw_quads(const GLQuad* data, size_t count)
+{
+  assert_gl();
+
+  m_vertex_arrays->set_quads(data, count);
+  glDrawArraysInstanced(GL_TRIANGLES, 0, 6, static_cast<GLsizei>(count));
+
+  assert_gl();
+}
+
 void
 GL33CoreContext::bind_texture(const Texture& texture, const Texture* displacement_texture)
 {
@@ -47,12 +47,21 @@ public:
   virtual void set_colors(const float* data, size_t size) override;
   virtual void set_color(const Color& color) override;
 
+  virtual GLint set_vertices(const GLVertex* data, size_t count) override;
+
   virtual void bind_texture(const Texture& texture, const Texture* displacement_texture) override;
   virtual void bind_no_texture() override;
   virtual void draw_arrays(GLenum type, GLint first, GLsizei count) override;
+  virtual void draw_quads(const GLQuad* data, size_t count) override;
 
   virtual bool supports_framebuffer() const override { return true; }
 
+#if defined(USE_OPENGLES2)
+  virtual bool supports_instancing() const override { return false; }
+#else
+  virtual bool supports_instancing() const override { return true; }
+#endif
+
   inline GLProgram& get_program() const { return *m_program; }
   inline GLVertexArrays& get_vertex_arrays() const { return *m_vertex_arrays; }
   inline GLTexture& get_white_texture() const { return *m_white_texture; }
@@ -0,0 +1,64 @@
+//  SuperTux
+//  Copyright (C) 2026 SuperTux Development Team
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#include "video/gl/gl_context.hpp"
+
+#include <math.h>
+
+void
+GLContext::draw_quads(const GLQuad* data, size_t count)
+{
+  m_quad_vertices.clear();
+  m_quad_vertices.reserve(count * 6);
+
+  for (size_t i = 0; i < count; ++i)
+  {
+    const GLQuad& quad = data[i];
+
+    // Corners in the order top left, top right, bottom right, bottom left.
+    float x[4] = { quad.left, quad.right, quad.right, quad.left };
+    float y[4] = { quad.top, quad.top, quad.bottom, quad.bottom };
+
+    if (quad.angle != 0.0f)
+    {
+      const float center_x = (quad.left + quad.right) / 2;
+      const float center_y = (quad.top + quad.bottom) / 2;
+
+      const float sa = sinf(quad.angle);
+      const float ca = cosf(quad.angle);
+
+      for (int corner = 0; corner < 4; ++corner)
+      {
+        const float dx = x[corner] - center_x;
+        const float dy = y[corner] - center_y;
+        x[corner] = dx*ca - dy*sa + center_x;
+        y[corner] = dx*sa + dy*ca + center_y;
+      }
+    }
+
+    const float u[4] = { quad.uv_left, quad.uv_right, quad.uv_right, quad.uv_left };
+    const float v[4] = { quad.uv_top, quad.uv_top, quad.uv_bottom, quad.uv_bottom };
+
+    for (const int corner : { 0, 1, 2, 3, 0, 2 })
+    {
+      m_quad_vertices.push_back({ x[corner], y[corner], u[corner], v[corner],
+                                  quad.r, quad.g, quad.b, quad.a });
+    }
+  }
+
+  const GLint first = set_vertices(m_quad_vertices.data(), m_quad_vertices.size());
+  draw_arrays(GL_TRIANGLES, first, static_cast<GLsizei>(m_quad_vertices.size()));
+}
@@ -18,6 +18,7 @@
 
 #include <stddef.h>
 #include <string>
+#include <vector>
 
 #include "video/gl.hpp"
 
@@ -25,10 +26,30 @@ class Color;
 class GLTexture;
 class Texture;
 
+/** Vertex with position, texture coordinate and color interleaved, as
+    taken by GLContext::set_vertices(). */
+struct GLVertex
+{
+  float x, y;
+  float u, v;
+  float r, g, b, a;
+};
+
+/** One textured quad as taken by GLContext::draw_quads(), expanded
+    into vertices on the GPU. */
+struct GLQuad
+{
+  float left, top, right, bottom;
+  float uv_left, uv_top, uv_right, uv_bottom;
+  /** In radians, around the center of the quad. */
+  float angle;
+  float r, g, b, a;
+};
+
 class GLContext
 {
 public:
-  GLContext() {}
+  GLContext() : m_quad_vertices() {}
   virtual ~GLContext() {}
 
   virtual std::string get_name() const = 0;
@@ -47,13 +68,27 @@ public:
   virtual void set_colors(const float* data, size_t size) = 0;
   virtual void set_color(const Color& color) = 0;
 
+  /** Sets positions, texcoords and colors at once from 'count'
+      interleaved vertices. Returns the index to pass to draw_arrays()
+      as 'first' to draw them. */
+  virtual GLint set_vertices(const GLVertex* data, size_t count) = 0;
+
   virtual void bind_texture(const Texture& texture, const Texture* displacement_texture) = 0;
   virtual void bind_no_texture() = 0;
 
   virtual void draw_arrays(GLenum type, GLint first, GLsizei count) = 0;
 
+  /** Draws 'count' quads, with instancing if supports_instancing() is
+      true. Otherwise they get expanded into vertices here. */
+  virtual void draw_quads(const GLQuad* data, size_t count);
+
+  virtual bool supports_instancing() const = 0;
+
   virtual bool supports_framebuffer() const = 0;
 
+private:
+  std::vector<GLVertex> m_quad_vertices;
+
 private:
   GLContext(const GLContext&) = delete;
   GLContext& operator=(const GLContext&) = delete;
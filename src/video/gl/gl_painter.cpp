@@ -62,8 +62,7 @@ inline GLenum dfactor(Blend blend)
 GLPainter::GLPainter(GLVideoSystem& video_system, GLRenderer& renderer) :
   m_video_system(video_system),
   m_renderer(renderer),
-  m_vertices(),
-  m_uvs()
+  m_vertices()
 {
 }
 
@@ -77,11 +76,25 @@ GLPainter::draw_texture(const TextureRequest& request)
   assert(request.srcrects.size() == request.dstrects.size());
   assert(request.srcrects.size() == request.angles.size());
 
-  m_vertices.reserve(request.srcrects.size() * 12);
-  m_uvs.reserve(request.srcrects.size() * 12);
-  
+  GLContext& context = m_video_system.get_context();
+
+  // Where supported only one record per quad is uploaded and the
+  // corners get expanded in the vertex shader.
+  const bool instanced = context.supports_instancing();
+
   m_vertices.clear();
-  m_uvs.clear();
+  m_quads.clear();
+  if (instanced)
+    m_quads.reserve(request.srcrects.size());
+  else
+    m_vertices.reserve(request.srcrects.size() * 6);
+
+  const Color request_color(request.color.red,
+                            request.color.green,
+                            request.color.blue,
+                            request.color.alpha * request.alpha);
+
+  assert(request.colors.empty() || request.colors.size() == request.srcrects.size());
 
   for (size_t i = 0; i < request.srcrects.size(); ++i)
   {
@@ -101,31 +114,22 @@ GLPainter::draw_texture(const TextureRequest& request)
     if (request.flip & VERTICAL_FLIP)
       std::swap(uv_top, uv_bottom);
 
-    if (request.angles[i] == 0.0f)
+    const Color& color = request.colors.empty() ? request_color : request.colors[i];
+
+    if (instanced)
     {
-      const float vertices_lst[] = {
-        left, top,
-        right, top,
-        right, bottom,
-
-        left, bottom,
-        left, top,
-        right, bottom,
-      };
-      m_vertices.insert(m_vertices.end(), vertices_lst, vertices_lst + 12);
-
-      const float uvs_lst[] = {
-        uv_left, uv_top,
-        uv_right, uv_top,
-        uv_right, uv_bottom,
-
-        uv_left, uv_bottom,
-        uv_left, uv_top,
-        uv_right, uv_bottom,
-      };
-      m_uvs.insert(m_uvs.end(), uvs_lst, uvs_lst + 12);
+      m_quads.push_back({ left, top, right, bottom,
+                          uv_left, uv_top, uv_right, uv_bottom,
+                          math::radians(request.angles[i]),
+                          color.red, color.green, color.blue, color.alpha });
+      continue;
     }
-    else
+
+    // Corners in the order top left, top right, bottom right, bottom left.
+    float x[4] = { left, right, right, left };
+    float y[4] = { top, top, bottom, bottom };
+
+    if (request.angles[i] != 0.0f)
     {
       // Rotated blit.
       const float center_x = (left + right) / 2;
@@ -134,48 +138,37 @@ GLPainter::draw_texture(const TextureRequest& request)
       const float sa = sinf(math::radians(request.angles[i]));
       const float ca = cosf(math::radians(request.angles[i]));
 
-      const float new_left = left - center_x;
-      const float new_right = right - center_x;
-
-      const float new_top = top - center_y;
-      const float new_bottom = bottom - center_y;
-
-      const float vertices_lst[] = {
-        new_left*ca - new_top*sa + center_x, new_left*sa + new_top*ca + center_y,
-        new_right*ca - new_top*sa + center_x, new_right*sa + new_top*ca + center_y,
-        new_right*ca - new_bottom*sa + center_x, new_right*sa + new_bottom*ca + center_y,
-
-        new_left*ca - new_bottom*sa + center_x, new_left*sa + new_bottom*ca + center_y,
-        new_left*ca - new_top*sa + center_x, new_left*sa + new_top*ca + center_y,
-        new_right*ca - new_bottom*sa + center_x, new_right*sa + new_bottom*ca + center_y,
-      };
-      m_vertices.insert(m_vertices.end(), vertices_lst, vertices_lst + 12);
-
-      const float uvs_lst[] = {
-        uv_left, uv_top,
-        uv_right, uv_top,
-        uv_right, uv_bottom,
-
-        uv_left, uv_bottom,
-        uv_left, uv_top,
-        uv_right, uv_bottom,
-      };
-      m_uvs.insert(m_uvs.end(), uvs_lst, uvs_lst + 12);
+      for (int corner = 0; corner < 4; ++corner)
+      {
+        const float dx = x[corner] - center_x;
+        const float dy = y[corner] - center_y;
+        x[corner] = dx*ca - dy*sa + center_x;
+        y[corner] = dx*sa + dy*ca + center_y;
+      }
     }
-  }
 
-  GLContext& context = m_video_system.get_context();
+    const float u[4] = { uv_left, uv_right, uv_right, uv_left };
+    const float v[4] = { uv_top, uv_top, uv_bottom, uv_bottom };
+
+    for (const int corner : { 0, 1, 2, 3, 0, 2 })
+    {
+      m_vertices.push_back({ x[corner], y[corner], u[corner], v[corner],
+                             color.red, color.green, color.blue, color.alpha });
+    }
+  }
 
   context.blend_func(sfactor(request.blend), dfactor(request.blend));
   context.bind_texture(texture, request.displacement_texture);
-  context.set_texcoords(m_uvs.data(), sizeof(float) * m_uvs.size());
-  context.set_positions(m_vertices.data(), sizeof(float) * m_vertices.size());
-  context.set_color(Color(request.color.red,
-                          request.color.green,
-                          request.color.blue,
-                          request.color.alpha * request.alpha));
-
-  context.draw_arrays(GL_TRIANGLES, 0, static_cast<GLsizei>(request.srcrects.size() * 2 * 3));
+
+  if (instanced)
+  {
+    context.draw_quads(m_quads.data(), m_quads.size());
+  }
+  else
+  {
+    const GLint first = context.set_vertices(m_vertices.data(), m_vertices.size());
+    context.draw_arrays(GL_TRIANGLES, first, static_cast<GLsizei>(m_vertices.size()));
+  }
 
   assert_gl();
 }
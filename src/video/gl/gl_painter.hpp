@@ -19,6 +19,7 @@
 #include "video/painter.hpp"
 
 #include "video/flip.hpp"
+#include "video/gl/gl_context.hpp"
 
 enum class Blend;
 class GLRenderer;
@@ -47,8 +48,8 @@ private:
   GLRenderer& m_renderer;
 
 private:
-  std::vector<float> m_vertices;
-  std::vector<float> m_uvs;
+  std::vector<GLVertex> m_vertices;
+  std::vector<GLQuad> m_quads;
 
 private:
   GLPainter(const GLPainter&) = delete;
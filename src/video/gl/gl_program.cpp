@@ -37,7 +37,12 @@ GLProgram::GLProgram() :
   m_position_location(-1),
   m_texcoord_location(-1),
   m_diffuse_location(-1),
-  m_is_displacement_location(-1)
+  m_is_displacement_location(-1),
+  m_instanced_location(-1),
+  m_quad_dstrect_location(-1),
+  m_quad_srcrect_location(-1),
+  m_quad_angle_location(-1),
+  m_quad_diffuse_location(-1)
 {
   assert_gl();
 
@@ -78,6 +83,13 @@ GLProgram::GLProgram() :
   m_texcoord_location = glGetAttribLocation(m_program, "texcoord");
   m_diffuse_location = glGetAttribLocation(m_program, "diffuse");
 
+  // Only present in the GLSL 3.30 shader.
+  m_instanced_location = glGetUniformLocation(m_program, "instanced");
+  m_quad_dstrect_location = glGetAttribLocation(m_program, "quad_dstrect");
+  m_quad_srcrect_location = glGetAttribLocation(m_program, "quad_srcrect");
+  m_quad_angle_location = glGetAttribLocation(m_program, "quad_angle");
+  m_quad_diffuse_location = glGetAttribLocation(m_program, "quad_diffuse");
+
   assert_gl();
 }
 
@@ -46,6 +46,11 @@ public:
   inline GLint get_texcoord_location() const { return check_valid(m_texcoord_location, "texcoord"); }
   inline GLint get_diffuse_location() const { return check_valid(m_diffuse_location, "diffuse"); }
   inline GLint get_is_displacement_location() const { return check_valid(m_is_displacement_location, "is_displacement"); }
+  inline GLint get_instanced_location() const { return check_valid(m_instanced_location, "instanced"); }
+  inline GLint get_quad_dstrect_location() const { return check_valid(m_quad_dstrect_location, "quad_dstrect"); }
+  inline GLint get_quad_srcrect_location() const { return check_valid(m_quad_srcrect_location, "quad_srcrect"); }
+  inline GLint get_quad_angle_location() const { return check_valid(m_quad_angle_location, "quad_angle"); }
+  inline GLint get_quad_diffuse_location() const { return check_valid(m_quad_diffuse_location, "quad_diffuse"); }
 
 private:
   bool get_link_status() const;
@@ -72,6 +77,11 @@ private:
   GLint m_texcoord_location;
   GLint m_diffuse_location;
   GLint m_is_displacement_location;
+  GLint m_instanced_location;
+  GLint m_quad_dstrect_location;
+  GLint m_quad_srcrect_location;
+  GLint m_quad_angle_location;
+  GLint m_quad_diffuse_location;
 
 private:
   GLProgram(const GLProgram&) = delete;
@@ -196,6 +196,44 @@ GLTexture::reload(const SDL_Surface& image)
   assert_gl();
 }
 
+void
+GLTexture::reload_region(const SDL_Surface& image, const Rect& region)
+{
+#if defined(GL_UNPACK_ROW_LENGTH)
+  if (image.w != m_texture_width || image.h != m_texture_height ||
+      image.format->BytesPerPixel != 4)
+  {
+    reload(image);
+    return;
+  }
+
+  assert_gl();
+
+  glBindTexture(GL_TEXTURE_2D, m_handle);
+  glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+  glPixelStorei(GL_UNPACK_ROW_LENGTH, image.pitch / image.format->BytesPerPixel);
+
+  if (SDL_MUSTLOCK(&image)) {
+    SDL_LockSurface(const_cast<SDL_Surface*>(&image));
+  }
+
+  const uint8_t* pixels = static_cast<const uint8_t*>(image.pixels) +
+    region.top * image.pitch + region.left * image.format->BytesPerPixel;
+  glTexSubImage2D(GL_TEXTURE_2D, 0, region.left, region.top,
+                  region.get_width(), region.get_height(), GL_RGBA,
+                  GL_UNSIGNED_BYTE, pixels);
+
+  if (SDL_MUSTLOCK(&image)) {
+    SDL_UnlockSurface(const_cast<SDL_Surface*>(&image));
+  }
+
+  assert_gl();
+#else
+  // Without UNPACK_ROW_LENGTH the rows of the region are not contiguous.
+  reload(image);
+#endif
+}
+
 GLTexture::~GLTexture()
 {
   glDeleteTextures(1, &m_handle);
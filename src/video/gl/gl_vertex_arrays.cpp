@@ -16,7 +16,11 @@
 
 #include "video/gl/gl_vertex_arrays.hpp"
 
+#include <algorithm>
+#include <stddef.h>
+
 #include "video/color.hpp"
+#include "video/gl/gl_context.hpp"
 #include "video/gl/gl33core_context.hpp"
 #include "video/gl/gl_program.hpp"
 #include "video/gl/gl_video_system.hpp"
@@ -27,7 +31,12 @@ GLVertexArrays::GLVertexArrays(GL33CoreContext& context) :
   m_vao(),
   m_positions_buffer(),
   m_texcoords_buffer(),
-  m_color_buffer()
+  m_color_buffer(),
+  m_stream_buffer(),
+  m_stream_size(0),
+  m_stream_offset(0),
+  m_stream_bound(false),
+  m_instanced(false)
 {
   assert_gl();
 
@@ -35,6 +44,7 @@ GLVertexArrays::GLVertexArrays(GL33CoreContext& context) :
   glGenBuffers(1, &m_positions_buffer);
   glGenBuffers(1, &m_texcoords_buffer);
   glGenBuffers(1, &m_color_buffer);
+  glGenBuffers(1, &m_stream_buffer);
 
   assert_gl();
 }
@@ -44,6 +54,7 @@ GLVertexArrays::~GLVertexArrays()
   glDeleteBuffers(1, &m_positions_buffer);
   glDeleteBuffers(1, &m_texcoords_buffer);
   glDeleteBuffers(1, &m_color_buffer);
+  glDeleteBuffers(1, &m_stream_buffer);
   glDeleteVertexArrays(1, &m_vao);
 }
 
@@ -62,6 +73,9 @@ GLVertexArrays::set_positions(const float* data, size_t size)
 {
   assert_gl();
 
+  m_stream_bound = false;
+  set_instanced(false);
+
   glBindBuffer(GL_ARRAY_BUFFER, m_positions_buffer);
   glBufferData(GL_ARRAY_BUFFER, size, data, GL_DYNAMIC_DRAW);
 
@@ -77,6 +91,9 @@ GLVertexArrays::set_texcoords(const float* data, size_t size)
 {
   assert_gl();
 
+  m_stream_bound = false;
+  set_instanced(false);
+
   glBindBuffer(GL_ARRAY_BUFFER, m_texcoords_buffer);
   glBufferData(GL_ARRAY_BUFFER, size, data, GL_DYNAMIC_DRAW);
 
@@ -92,6 +109,9 @@ GLVertexArrays::set_texcoord(float u, float v)
 {
   assert_gl();
 
+  m_stream_bound = false;
+  set_instanced(false);
+
   int loc = m_context.get_program().get_texcoord_location();
   glVertexAttrib2f(loc, u, v);
   glDisableVertexAttribArray(loc);
@@ -104,6 +124,9 @@ GLVertexArrays::set_colors(const float* data, size_t size)
 {
   assert_gl();
 
+  m_stream_bound = false;
+  set_instanced(false);
+
   glBindBuffer(GL_ARRAY_BUFFER, m_color_buffer);
   glBufferData(GL_ARRAY_BUFFER, size, data, GL_DYNAMIC_DRAW);
 
@@ -119,9 +142,147 @@ GLVertexArrays::set_color(const Color& color)
 {
   assert_gl();
 
+  m_stream_bound = false;
+  set_instanced(false);
+
   int loc = m_context.get_program().get_diffuse_location();
   glVertexAttrib4f(loc, color.red, color.green, color.blue, color.alpha);
   glDisableVertexAttribArray(loc);
 
   assert_gl();
 }
+
+GLint
+GLVertexArrays::set_vertices(const GLVertex* data, size_t count)
+{
+  assert_gl();
+
+  set_instanced(false);
+
+  const size_t offset = stream(data, sizeof(GLVertex) * count, sizeof(GLVertex));
+
+  if (!m_stream_bound)
+    bind_stream_attributes();
+
+  assert_gl();
+
+  return static_cast<GLint>(offset / sizeof(GLVertex));
+}
+
+void
+GLVertexArrays::set_quads(const GLQuad* data, size_t count)
+{
+  assert_gl();
+
+  set_instanced(true);
+
+  const size_t offset = stream(data, sizeof(GLQuad) * count, sizeof(float));
+  const GLProgram& program = m_context.get_program();
+
+  // There is no base instance in GL 3.3, so the pointers have to move
+  // along with every draw.
+  const struct
+  {
+    GLint location;
+    GLint size;
+    size_t member;
+  } attributes[] = {
+    { program.get_quad_dstrect_location(), 4, offsetof(GLQuad, left) },
+    { program.get_quad_srcrect_location(), 4, offsetof(GLQuad, uv_left) },
+    { program.get_quad_angle_location(), 1, offsetof(GLQuad, angle) },
+    { program.get_quad_diffuse_location(), 4, offsetof(GLQuad, r) }
+  };
+
+  for (const auto& attribute : attributes)
+  {
+    glVertexAttribPointer(attribute.location, attribute.size, GL_FLOAT, GL_FALSE, sizeof(GLQuad),
+                          reinterpret_cast<const void*>(offset + attribute.member));
+    glVertexAttribDivisor(attribute.location, 1);
+    glEnableVertexAttribArray(attribute.location);
+  }
+
+  assert_gl();
+}
+
+size_t
+GLVertexArrays::stream(const void* data, size_t size, size_t alignment)
+{
+  // Room for a few thousand sprites, it grows if a single draw needs more.
+  const size_t min_stream_size = 4 * 1024 * 1024;
+
+  glBindBuffer(GL_ARRAY_BUFFER, m_stream_buffer);
+
+  size_t offset = (m_stream_offset + alignment - 1) / alignment * alignment;
+
+  if (size > m_stream_size)
+  {
+    m_stream_size = std::max(min_stream_size, 2 * size);
+    offset = 0;
+    glBufferData(GL_ARRAY_BUFFER, m_stream_size, nullptr, GL_STREAM_DRAW);
+  }
+  else if (offset + size > m_stream_size)
+  {
+    // Orphan the old storage instead of waiting for the GPU to be done
+    // with it.
+    offset = 0;
+    glBufferData(GL_ARRAY_BUFFER, m_stream_size, nullptr, GL_STREAM_DRAW);
+  }
+
+  glBufferSubData(GL_ARRAY_BUFFER, offset, size, data);
+  m_stream_offset = offset + size;
+
+  return offset;
+}
+
+void
+GLVertexArrays::set_instanced(bool instanced)
+{
+  if (m_instanced == instanced)
+    return;
+
+  const GLProgram& program = m_context.get_program();
+
+  glUniform1i(program.get_instanced_location(), instanced);
+
+  if (instanced)
+  {
+    // The per vertex arrays may still point at a four vertex buffer,
+    // which the six vertices of an instance would read past.
+    glDisableVertexAttribArray(program.get_position_location());
+    glDisableVertexAttribArray(program.get_texcoord_location());
+    glDisableVertexAttribArray(program.get_diffuse_location());
+    m_stream_bound = false;
+  }
+  else
+  {
+    glDisableVertexAttribArray(program.get_quad_dstrect_location());
+    glDisableVertexAttribArray(program.get_quad_srcrect_location());
+    glDisableVertexAttribArray(program.get_quad_angle_location());
+    glDisableVertexAttribArray(program.get_quad_diffuse_location());
+  }
+
+  m_instanced = instanced;
+}
+
+void
+GLVertexArrays::bind_stream_attributes()
+{
+  const GLProgram& program = m_context.get_program();
+
+  int loc = program.get_position_location();
+  glVertexAttribPointer(loc, 2, GL_FLOAT, GL_FALSE, sizeof(GLVertex),
+                        reinterpret_cast<const void*>(offsetof(GLVertex, x)));
+  glEnableVertexAttribArray(loc);
+
+  loc = program.get_texcoord_location();
+  glVertexAttribPointer(loc, 2, GL_FLOAT, GL_FALSE, sizeof(GLVertex),
+                        reinterpret_cast<const void*>(offsetof(GLVertex, u)));
+  glEnableVertexAttribArray(loc);
+
+  loc = program.get_diffuse_location();
+  glVertexAttribPointer(loc, 4, GL_FLOAT, GL_FALSE, sizeof(GLVertex),
+                        reinterpret_cast<const void*>(offsetof(GLVertex, r)));
+  glEnableVertexAttribArray(loc);
+
+  m_stream_bound = true;
+}
@@ -22,6 +22,8 @@
 
 class Color;
 class GL33CoreContext;
+struct GLQuad;
+struct GLVertex;
 
 class GLVertexArrays final
 {
@@ -40,6 +42,23 @@ public:
   void set_colors(const float* data, size_t size);
   void set_color(const Color& color);
 
+  /** Appends the vertices to the stream buffer and returns the index
+      of the first one in it. The buffer is only orphaned when it runs
+      full, so most draws just write behind the previous one. */
+  GLint set_vertices(const GLVertex* data, size_t count);
+
+  /** Appends the quads to the stream buffer and points the per-instance
+      attributes at them. */
+  void set_quads(const GLQuad* data, size_t count);
+
+private:
+  /** Copies 'size' bytes to the stream buffer at a multiple of
+      'alignment' and returns the offset they were written to. */
+  size_t stream(const void* data, size_t size, size_t alignment);
+
+  void bind_stream_attributes();
+  void set_instanced(bool instanced);
+
 private:
   GL33CoreContext& m_context;
   GLuint m_vao;
@@ -47,6 +66,16 @@ private:
   GLuint m_texcoords_buffer;
   GLuint m_color_buffer;
 
+  GLuint m_stream_buffer;
+  size_t m_stream_size;
+  size_t m_stream_offset;
+
+  /** True while the attributes point into the stream buffer. */
+  bool m_stream_bound;
+
+  /** True while the program expands instanced quads. */
+  bool m_instanced;
+
 private:
   GLVertexArrays(const GLVertexArrays&) = delete;
   GLVertexArrays& operator=(const GLVertexArrays&) = delete;
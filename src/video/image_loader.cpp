@@ -0,0 +1,171 @@
+//  SuperTux
+//  Copyright (C) 2026 SuperTux Development Team
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#include "video/image_loader.hpp"
+
+#include <sstream>
+#include <stdexcept>
+
+#include <SDL_image.h>
+
+#include "physfs/physfs_sdl.hpp"
+#include "util/job_system.hpp"
+
+ImageLoader::ImageLoader() :
+  m_group(),
+  m_mutex(),
+  m_done_cond(),
+  m_jobs(),
+  m_quit(false)
+{
+  JobSystem* job_system = JobSystem::current();
+  if (job_system && job_system->get_worker_count() > 0)
+    m_group = std::make_unique<JobGroup>(*job_system);
+}
+
+ImageLoader::~ImageLoader()
+{
+  if (!m_group)
+    return;
+
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_quit = true;
+  }
+
+  // Jobs that did not start yet return right away now.
+  m_group->wait();
+}
+
+void
+ImageLoader::request(const std::string& filename)
+{
+  if (!m_group)
+    return;
+
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (!m_jobs.emplace(filename, Job()).second)
+      return;
+  }
+
+  m_group->run([this, filename] { process(filename); });
+}
+
+bool
+ImageLoader::has(const std::string& filename) const
+{
+  std::lock_guard<std::mutex> lock(m_mutex);
+  return m_jobs.find(filename) != m_jobs.end();
+}
+
+bool
+ImageLoader::is_done(const std::string& filename) const
+{
+  std::lock_guard<std::mutex> lock(m_mutex);
+  auto it = m_jobs.find(filename);
+  return it != m_jobs.end() && it->second.done;
+}
+
+SDLSurfacePtr
+ImageLoader::take(const std::string& filename)
+{
+  std::unique_lock<std::mutex> lock(m_mutex);
+
+  auto it = m_jobs.find(filename);
+  if (it == m_jobs.end())
+    throw std::runtime_error("Image '" + filename + "' was not requested");
+
+  if (!it->second.started)
+  {
+    // Waiting for the rest of the queue would take longer, the job
+    // finds nothing to do once it gets its turn.
+    m_jobs.erase(it);
+    lock.unlock();
+    return decode(filename);
+  }
+
+  m_done_cond.wait(lock, [this, &filename] { return m_jobs[filename].done; });
+  it = m_jobs.find(filename);
+
+  Job job = std::move(it->second);
+  m_jobs.erase(it);
+
+  if (!job.surface)
+    throw std::runtime_error(job.error);
+
+  return std::move(job.surface);
+}
+
+void
+ImageLoader::expire(int max_age)
+{
+  std::lock_guard<std::mutex> lock(m_mutex);
+  for (auto it = m_jobs.begin(); it != m_jobs.end();)
+  {
+    if (it->second.done && ++it->second.age > max_age)
+      it = m_jobs.erase(it);
+    else
+      ++it;
+  }
+}
+
+void
+ImageLoader::process(const std::string& filename)
+{
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    auto it = m_jobs.find(filename);
+    if (m_quit || it == m_jobs.end() || it->second.started)
+      return;
+
+    it->second.started = true;
+  }
+
+  SDLSurfacePtr surface;
+  std::string error;
+  try
+  {
+    surface = decode(filename);
+  }
+  catch (const std::exception& err)
+  {
+    error = err.what();
+  }
+
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    Job& job = m_jobs[filename];
+    job.done = true;
+    job.surface = std::move(surface);
+    job.error = std::move(error);
+  }
+  m_done_cond.notify_all();
+}
+
+SDLSurfacePtr
+ImageLoader::decode(const std::string& filename)
+{
+  // Same as SDLSurface::from_file(), minus the logging.
+  SDLSurfacePtr surface(IMG_Load_RW(get_physfs_SDLRWops(filename), 1));
+  if (!surface)
+  {
+    std::ostringstream msg;
+    msg << "Couldn't load image '" << filename << "' :" << SDL_GetError();
+    throw std::runtime_error(msg.str());
+  }
+  return surface;
+}
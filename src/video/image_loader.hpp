@@ -0,0 +1,86 @@
+//  SuperTux
+//  Copyright (C) 2026 SuperTux Development Team
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#pragma once
+
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+#include "video/sdl_surface_ptr.hpp"
+
+class JobGroup;
+
+/**
+ * Reads and decodes image files on the JobSystem's workers, so that
+ * the main thread only has to upload them.
+ *
+ * The workers neither log nor touch anything but PhysFS and
+ * SDL_image, failed images are reported to whoever takes them.
+ */
+class ImageLoader final
+{
+private:
+  struct Job
+  {
+    bool started = false;
+    bool done = false;
+    SDLSurfacePtr surface = {};
+    std::string error = {};
+    int age = 0;
+  };
+
+public:
+  /** Without a JobSystem or with one without workers, request() does
+      nothing and all images get loaded the synchronous way. */
+  ImageLoader();
+  ~ImageLoader();
+
+  /** Queues 'filename' for decoding, unless it is already known. */
+  void request(const std::string& filename);
+
+  /** Returns true if 'filename' was requested and not taken yet. */
+  bool has(const std::string& filename) const;
+
+  /** Returns true if 'filename' was requested and is decoded. */
+  bool is_done(const std::string& filename) const;
+
+  /** Removes the image of 'filename' from the loader. If no worker
+      picked it up yet, it gets decoded right here, otherwise this
+      waits for the worker. Throws if decoding failed or 'filename'
+      was never requested. */
+  SDLSurfacePtr take(const std::string& filename);
+
+  /** Drops decoded images that nobody took for 'max_age' calls. */
+  void expire(int max_age);
+
+private:
+  void process(const std::string& filename);
+  static SDLSurfacePtr decode(const std::string& filename);
+
+private:
+  std::unique_ptr<JobGroup> m_group;
+  mutable std::mutex m_mutex;
+  std::condition_variable m_done_cond;
+  std::unordered_map<std::string, Job> m_jobs;
+  bool m_quit;
+
+private:
+  ImageLoader(const ImageLoader&) = delete;
+  ImageLoader& operator=(const ImageLoader&) = delete;
+};
@@ -222,10 +222,15 @@ SDLPainter::draw_texture(const TextureRequest& request)
     const SDL_Rect& src_rect = request.srcrects[i].to_rect().to_sdl();
     const SDL_FRect& dst_rect = request.dstrects[i].to_sdl();
 
-    Uint8 r = static_cast<Uint8>(request.color.red * 255);
-    Uint8 g = static_cast<Uint8>(request.color.green * 255);
-    Uint8 b = static_cast<Uint8>(request.color.blue * 255);
-    Uint8 a = static_cast<Uint8>(request.color.alpha * request.alpha * 255);
+    const Color color = request.colors.empty() ?
+      Color(request.color.red, request.color.green, request.color.blue,
+            request.color.alpha * request.alpha) :
+      request.colors[i];
+
+    Uint8 r = static_cast<Uint8>(color.red * 255);
+    Uint8 g = static_cast<Uint8>(color.green * 255);
+    Uint8 b = static_cast<Uint8>(color.blue * 255);
+    Uint8 a = static_cast<Uint8>(color.alpha * 255);
 
     SDL_SetTextureColorMod(texture.get_texture(), r, g, b);
     SDL_SetTextureAlphaMod(texture.get_texture(), a);
@@ -74,11 +74,10 @@ Surface::from_file(const std::string& filename, const std::optional<Rect>& rect)
   }
   else
   {
-    auto textureManager = TextureManager::current();
-    TexturePtr texture = rect ?
-      textureManager->get(filename, *rect) : textureManager->get(filename);
+    Rect region;
+    TexturePtr texture = TextureManager::current()->get_region(filename, rect, region);
 
-    return SurfacePtr(new Surface(texture, TexturePtr(), NO_FLIP, filename));
+    return SurfacePtr(new Surface(texture, TexturePtr(), region, NO_FLIP, filename));
   }
 }
 
@@ -128,9 +127,12 @@ Surface::clone(Flip flip) const
 SurfacePtr
 Surface::region(const Rect& rect) const
 {
+  // 'rect' is relative to this surface, which might itself only be a
+  // part of its texture (e.g. when it lives in the texture atlas).
   SurfacePtr surface(new Surface(m_diffuse_texture,
                                  m_displacement_texture,
-                                 rect,
+                                 Rect(m_region.left + rect.left, m_region.top + rect.top,
+                                      m_region.left + rect.right, m_region.top + rect.bottom),
                                  m_flip));
   return surface;
 }
@@ -45,6 +45,7 @@ private:
 public:
   ~Surface();
 
+  /** Returns the part 'rect' of this surface, given relative to its region. */
   SurfacePtr region(const Rect& rect) const;
   SurfacePtr clone(Flip flip = NO_FLIP) const;
 
@@ -18,16 +18,26 @@
 
 #include "video/texture_manager.hpp"
 
+int Texture::s_created = 0;
+
 Texture::Texture() :
   m_sampler(),
   m_cache_key()
 {
+  ++s_created;
 }
 
 Texture::Texture(const Sampler& sampler) :
   m_sampler(sampler),
   m_cache_key()
 {
+  ++s_created;
+}
+
+void
+Texture::reload_region(const SDL_Surface& image, const Rect& /* region */)
+{
+  reload(image);
 }
 
 Texture::~Texture()
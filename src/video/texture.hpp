@@ -37,6 +37,9 @@ public:
   /** filename, left, top, right, bottom */
   using Key = std::tuple<std::string, Rect>;
 
+  /** Number of textures created so far, for statistics. */
+  static int s_created;
+
 protected:
   Texture();
   Texture(const Sampler& sampler);
@@ -46,6 +49,10 @@ public:
 
   virtual void reload(const SDL_Surface& image) = 0;
 
+  /** Uploads only 'region' of 'image', which has the size of the
+      texture. Reloads the whole image unless a subclass knows better. */
+  virtual void reload_region(const SDL_Surface& image, const Rect& region);
+
   virtual int get_texture_width() const = 0;
   virtual int get_texture_height() const = 0;
 
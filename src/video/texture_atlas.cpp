@@ -0,0 +1,275 @@
+//  SuperTux
+//  Copyright (C) 2026 SuperTux Development Team
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#include "video/texture_atlas.hpp"
+
+#include <SDL.h>
+#include <algorithm>
+#include <string.h>
+
+#include "util/log.hpp"
+#include "video/sdl_surface.hpp"
+#include "video/video_system.hpp"
+
+TextureAtlas::TextureAtlas(int page_size) :
+  m_page_size(page_size),
+  m_pages(),
+  m_entries()
+{
+}
+
+TextureAtlas::~TextureAtlas()
+{
+}
+
+bool
+TextureAtlas::fits(int width, int height)
+{
+  return width > 0 && height > 0 &&
+         width <= MAX_IMAGE_SIZE && height <= MAX_IMAGE_SIZE;
+}
+
+TexturePtr
+TextureAtlas::get(const Texture::Key& key, Rect& region) const
+{
+  auto it = m_entries.find(key);
+  if (it == m_entries.end())
+    return {};
+
+  region = it->second.region;
+  return m_pages[it->second.page].texture;
+}
+
+TexturePtr
+TextureAtlas::add(const Texture::Key& key, const SDL_Surface& image, Rect& region)
+{
+  size_t page_index;
+  if (!pack(image, region, page_index))
+    return {};
+
+  m_entries[key] = { page_index, region };
+  return m_pages[page_index].texture;
+}
+
+TexturePtr
+TextureAtlas::add(const SDL_Surface& image, Rect& region)
+{
+  size_t page_index;
+  if (!pack(image, region, page_index))
+    return {};
+
+  return m_pages[page_index].texture;
+}
+
+bool
+TextureAtlas::pack(const SDL_Surface& image, Rect& region, size_t& page_index)
+{
+  const int width = image.w + 2 * PADDING;
+  const int height = image.h + 2 * PADDING;
+  if (width > m_page_size || height > m_page_size)
+    return false;
+
+  int x = 0;
+  int y = 0;
+  page_index = 0;
+  while (page_index < m_pages.size() &&
+         (!m_pages[page_index].surface.get() || !allocate(m_pages[page_index], width, height, x, y)))
+    ++page_index;
+
+  if (page_index == m_pages.size())
+  {
+    // Reuse the slot of a released page, the entries refer to pages by index.
+    page_index = 0;
+    while (page_index < m_pages.size() && m_pages[page_index].surface.get())
+      ++page_index;
+    if (page_index == m_pages.size())
+      m_pages.emplace_back();
+
+    Page& page = m_pages[page_index];
+    page.surface = SDLSurface::create_rgba(m_page_size, m_page_size);
+    page.texture = VideoSystem::current()->new_texture(*page.surface);
+    page.shelves.clear();
+    page.shelves_bottom = 0;
+    page.dirty_region = Rect();
+
+    if (!allocate(page, width, height, x, y))
+      return false;
+  }
+
+  Page& page = m_pages[page_index];
+  copy_image(page, image, x, y);
+
+  region = Rect(x + PADDING, y + PADDING, x + PADDING + image.w, y + PADDING + image.h);
+  return true;
+}
+
+bool
+TextureAtlas::replace(const Texture::Key& key, const SDL_Surface& image)
+{
+  auto it = m_entries.find(key);
+  if (it == m_entries.end())
+    return false;
+
+  const Rect& region = it->second.region;
+  if (region.get_width() != image.w || region.get_height() != image.h)
+    return false;
+
+  copy_image(m_pages[it->second.page], image, region.left - PADDING, region.top - PADDING);
+  return true;
+}
+
+std::vector<Texture::Key>
+TextureAtlas::get_keys() const
+{
+  std::vector<Texture::Key> keys;
+  keys.reserve(m_entries.size());
+  for (const auto& entry : m_entries)
+    keys.push_back(entry.first);
+  return keys;
+}
+
+bool
+TextureAtlas::allocate(Page& page, int width, int height, int& x, int& y)
+{
+  // Put the image on the flattest shelf it fits on, unless that
+  // wastes more than half of its height and a new shelf can be opened.
+  Shelf* best = nullptr;
+  for (auto& shelf : page.shelves)
+  {
+    if (shelf.height >= height && shelf.x + width <= m_page_size &&
+        (!best || shelf.height < best->height))
+      best = &shelf;
+  }
+
+  const bool can_open_shelf = page.shelves_bottom + height <= m_page_size && width <= m_page_size;
+  if (!best || (best->height - height > height / 2 && can_open_shelf))
+  {
+    if (!can_open_shelf)
+      return false;
+
+    page.shelves.push_back({ page.shelves_bottom, height, 0 });
+    page.shelves_bottom += height;
+    best = &page.shelves.back();
+  }
+
+  x = best->x;
+  y = best->y;
+  best->x += width;
+  return true;
+}
+
+void
+TextureAtlas::copy_image(Page& page, const SDL_Surface& image, int x, int y)
+{
+  SDL_Surface* surface = page.surface.get();
+
+  SDL_SetSurfaceBlendMode(const_cast<SDL_Surface*>(&image), SDL_BLENDMODE_NONE);
+  SDL_Rect dstrect{ x + PADDING, y + PADDING, image.w, image.h };
+  SDL_BlitSurface(const_cast<SDL_Surface*>(&image), nullptr, surface, &dstrect);
+
+  if (SDL_MUSTLOCK(surface))
+    SDL_LockSurface(surface);
+
+  // Repeat the outermost rows and columns into the padding, so that
+  // filtering at the image's border does not pick up its neighbours.
+  const int bpp = surface->format->BytesPerPixel;
+  auto pixel = [surface, bpp](int px, int py) {
+    return static_cast<uint8_t*>(surface->pixels) + py * surface->pitch + px * bpp;
+  };
+
+  for (int i = 0; i < PADDING; ++i)
+  {
+    memcpy(pixel(x + PADDING, y + i), pixel(x + PADDING, y + PADDING), image.w * bpp);
+    memcpy(pixel(x + PADDING, y + PADDING + image.h + i), pixel(x + PADDING, y + PADDING + image.h - 1), image.w * bpp);
+  }
+
+  for (int row = y; row < y + image.h + 2 * PADDING; ++row)
+  {
+    for (int i = 0; i < PADDING; ++i)
+    {
+      memcpy(pixel(x + i, row), pixel(x + PADDING, row), bpp);
+      memcpy(pixel(x + PADDING + image.w + i, row), pixel(x + PADDING + image.w - 1, row), bpp);
+    }
+  }
+
+  if (SDL_MUSTLOCK(surface))
+    SDL_UnlockSurface(surface);
+
+  const Rect area(x, y, x + image.w + 2 * PADDING, y + image.h + 2 * PADDING);
+  if (page.dirty_region.empty())
+  {
+    page.dirty_region = area;
+  }
+  else
+  {
+    page.dirty_region = Rect(std::min(page.dirty_region.left, area.left),
+                             std::min(page.dirty_region.top, area.top),
+                             std::max(page.dirty_region.right, area.right),
+                             std::max(page.dirty_region.bottom, area.bottom));
+  }
+}
+
+void
+TextureAtlas::upload()
+{
+  for (auto& page : m_pages)
+  {
+    if (!page.surface.get() || page.dirty_region.empty())
+      continue;
+
+    page.texture->reload_region(*page.surface, page.dirty_region);
+    page.dirty_region = Rect();
+  }
+}
+
+void
+TextureAtlas::release_unused()
+{
+  for (size_t i = 0; i < m_pages.size(); ++i)
+  {
+    Page& page = m_pages[i];
+    if (!page.surface.get() || page.texture.use_count() > 1)
+      continue;
+
+    for (auto it = m_entries.begin(); it != m_entries.end();)
+    {
+      if (it->second.page == i)
+        it = m_entries.erase(it);
+      else
+        ++it;
+    }
+
+    page.surface.reset(nullptr);
+    page.texture.reset();
+    page.shelves.clear();
+    page.shelves_bottom = 0;
+    page.dirty_region = Rect();
+  }
+}
+
+void
+TextureAtlas::debug_print(std::ostream& out) const
+{
+  out << "atlas:begin" << std::endl;
+  for (size_t i = 0; i < m_pages.size(); ++i)
+  {
+    out << "  page " << i << " filled:" << m_pages[i].shelves_bottom << "/" << m_page_size
+        << " use_count:" << m_pages[i].texture.use_count() << std::endl;
+  }
+  out << "atlas:end" << std::endl;
+  out << "total atlas pages:" << m_pages.size() << std::endl;
+  out << "total atlas images:" << m_entries.size() << std::endl;
+}
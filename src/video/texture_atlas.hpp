@@ -0,0 +1,121 @@
+//  SuperTux
+//  Copyright (C) 2026 SuperTux Development Team
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#pragma once
+
+#include <map>
+#include <ostream>
+#include <vector>
+
+#include "math/rect.hpp"
+#include "video/sdl_surface_ptr.hpp"
+#include "video/texture.hpp"
+#include "video/texture_ptr.hpp"
+
+struct SDL_Surface;
+
+/**
+ * Packs small images into a few big shared textures ("pages"), so
+ * that tiles and sprite frames drawn after each other end up on the
+ * same texture and can be batched into a single draw call.
+ *
+ * Images are surrounded by a border of repeated edge pixels to avoid
+ * bleeding of their neighbours when filtering. Pages are kept in
+ * memory and the parts that changed are uploaded lazily with upload().
+ *
+ * Every page takes PAGE_SIZE * PAGE_SIZE * 4 bytes (16 MB) in memory
+ * and on the GPU. Images are never removed one by one, only whole
+ * pages nothing draws from anymore with release_unused().
+ */
+class TextureAtlas final
+{
+public:
+  static const int PAGE_SIZE = 2048;
+  static const int MAX_IMAGE_SIZE = 256;
+  static const int PADDING = 2;
+
+private:
+  struct Shelf
+  {
+    int y;
+    int height;
+    int x;
+  };
+
+  struct Page
+  {
+    SDLSurfacePtr surface;
+    TexturePtr texture;
+    std::vector<Shelf> shelves;
+    int shelves_bottom;
+    /** Area changed since the last upload(), empty if none. */
+    Rect dirty_region;
+  };
+
+  struct Entry
+  {
+    size_t page;
+    Rect region;
+  };
+
+public:
+  explicit TextureAtlas(int page_size = PAGE_SIZE);
+  ~TextureAtlas();
+
+  /** Returns true if images of the given size get packed. */
+  static bool fits(int width, int height);
+
+  /** If the image for 'key' was added before, stores its region in
+      'region' and returns the page texture, returns nullptr otherwise. */
+  TexturePtr get(const Texture::Key& key, Rect& region) const;
+
+  /** Copies 'image' into a page and returns the page texture, with the
+      image's position in it stored in 'region'. */
+  TexturePtr add(const Texture::Key& key, const SDL_Surface& image, Rect& region);
+
+  /** Like above, for images the caller keeps track of itself. Returns
+      nullptr if the image is too big for a page. */
+  TexturePtr add(const SDL_Surface& image, Rect& region);
+
+  /** Overwrites the pixels of an added image, 'image' must have the
+      size the image was added with. Returns false if it has not. */
+  bool replace(const Texture::Key& key, const SDL_Surface& image);
+
+  std::vector<Texture::Key> get_keys() const;
+
+  /** Uploads the areas that changed since the last call. */
+  void upload();
+
+  /** Frees the pages whose texture is not used outside the atlas
+      anymore, their images have to be added again when needed. */
+  void release_unused();
+
+  void debug_print(std::ostream& out) const;
+
+private:
+  bool pack(const SDL_Surface& image, Rect& region, size_t& page_index);
+  bool allocate(Page& page, int width, int height, int& x, int& y);
+  void copy_image(Page& page, const SDL_Surface& image, int x, int y);
+
+private:
+  int m_page_size;
+  std::vector<Page> m_pages;
+  std::map<Texture::Key, Entry> m_entries;
+
+private:
+  TextureAtlas(const TextureAtlas&) = delete;
+  TextureAtlas& operator=(const TextureAtlas&) = delete;
+};
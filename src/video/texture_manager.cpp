@@ -19,6 +19,8 @@
 #include <SDL_image.h>
 #include <assert.h>
 #include <sstream>
+#include <stdint.h>
+#include <string.h>
 
 #include <physfs.h>
 
@@ -75,6 +77,34 @@ GLenum string2filter(const std::string& text)
   }
 }
 
+/** Reads the size of a PNG file from its header, without decoding it. */
+bool read_png_size(const std::string& filename, int& width, int& height)
+{
+  PHYSFS_File* file = PHYSFS_openRead(filename.c_str());
+  if (!file)
+    return false;
+
+  unsigned char header[24];
+  const bool complete = PHYSFS_readBytes(file, header, sizeof(header)) == sizeof(header);
+  PHYSFS_close(file);
+
+  // Signature followed by the IHDR chunk, which always comes first.
+  static const unsigned char signature[] = { 0x89, 'P', 'N', 'G', '\r', '\n', 0x1a, '\n' };
+  if (!complete ||
+      memcmp(header, signature, sizeof(signature)) != 0 ||
+      memcmp(header + 12, "IHDR", 4) != 0)
+    return false;
+
+  auto read_u32 = [](const unsigned char* p) {
+    return (static_cast<uint32_t>(p[0]) << 24) | (static_cast<uint32_t>(p[1]) << 16) |
+           (static_cast<uint32_t>(p[2]) << 8) | static_cast<uint32_t>(p[3]);
+  };
+
+  width = static_cast<int>(read_u32(header + 16));
+  height = static_cast<int>(read_u32(header + 20));
+  return width > 0 && height > 0;
+}
+
 SDLSurfacePtr create_image_surface(const std::string& filename)
 {
   if (PHYSFS_exists(filename.c_str()))
@@ -90,9 +120,16 @@ SDLSurfacePtr create_image_surface(const std::string& filename)
 
 const std::string TextureManager::s_dummy_texture = "images/engine/missing.png";
 
+/** Number of update() calls prefetched images are kept for if nobody
+    asks for them. */
+static const int s_prefetch_lifetime = 600;
+
 TextureManager::TextureManager() :
   m_image_textures(),
   m_surfaces(),
+  m_atlas(),
+  m_loader(),
+  m_placeholders(),
   m_load_successful(false)
 {
 }
@@ -247,6 +284,189 @@ TextureManager::get(const std::string& _filename,
   return texture;
 }
 
+TexturePtr
+TextureManager::get_region(const std::string& _filename,
+                           const std::optional<Rect>& rect,
+                           Rect& region)
+{
+  std::string filename = FileSystem::normalize(_filename);
+  Texture::Key key = Texture::Key(filename, rect ? *rect : Rect(0, 0, 0, 0));
+
+  if (TexturePtr texture = m_atlas.get(key, region))
+  {
+    m_load_successful = true;
+    return texture;
+  }
+
+  // Images that were loaded on their own before stay that way.
+  auto i = m_image_textures.find(key);
+  TexturePtr texture = (i != m_image_textures.end()) ? i->second.lock() : TexturePtr();
+
+  if (!texture && (!rect || TextureAtlas::fits(rect->get_width(), rect->get_height())))
+  {
+    try
+    {
+      SDLSurfacePtr surface;
+      bool placeholder = false;
+      int width;
+      int height;
+      if (rect)
+      {
+        surface = create_image_surface_raw(filename, *rect, Sampler());
+      }
+      else if (get_pending_image_size(filename, width, height))
+      {
+        // Reserve the space in the atlas now, the pixels follow once
+        // they are decoded.
+        placeholder = true;
+        if (TextureAtlas::fits(width, height))
+          surface = SDLSurface::create_rgba(width, height);
+      }
+      else
+      {
+        surface = take_decoded(filename);
+        if (!surface.get())
+          surface = create_image_surface(filename);
+      }
+
+      if (surface.get() && TextureAtlas::fits(surface->w, surface->h))
+      {
+        texture = m_atlas.add(key, *surface, region);
+      }
+      else if (surface.get() && !placeholder)
+      {
+        // Too big for the atlas, but decoding it again in get() would
+        // be a waste.
+        texture = VideoSystem::current()->new_texture(*surface);
+        texture->m_cache_key = key;
+        m_image_textures[key] = texture;
+        region = Rect(0, 0, surface->w, surface->h);
+      }
+
+      if (texture)
+      {
+        if (placeholder)
+          m_placeholders.push_back({ filename, {}, key });
+
+        m_load_successful = true;
+        return texture;
+      }
+    }
+    catch (const std::exception&)
+    {
+      // get() below reports the error and hands out the dummy texture.
+    }
+  }
+
+  if (!texture)
+    texture = rect ? get(filename, *rect) : get(filename);
+
+  region = Rect(0, 0, texture->get_image_width(), texture->get_image_height());
+  return texture;
+}
+
+void
+TextureManager::prefetch(const std::vector<std::string>& filenames)
+{
+  // A new level is about to load, a good time to give back the atlas
+  // pages of the previous one.
+  m_atlas.release_unused();
+
+  Rect region;
+  for (const auto& _filename : filenames)
+  {
+    const std::string filename = FileSystem::normalize(_filename);
+    const Texture::Key key(filename, Rect(0, 0, 0, 0));
+
+    auto i = m_image_textures.find(key);
+    if ((i != m_image_textures.end() && !i->second.expired()) ||
+        m_atlas.get(key, region) ||
+        m_surfaces.find(filename) != m_surfaces.end())
+      continue;
+
+    m_loader.request(filename);
+  }
+}
+
+void
+TextureManager::update()
+{
+  std::vector<Placeholder> placeholders = std::move(m_placeholders);
+  m_placeholders.clear();
+
+  std::unordered_map<std::string, SDLSurfacePtr> finished;
+  for (auto& placeholder : placeholders)
+  {
+    auto it = finished.find(placeholder.filename);
+    if (it == finished.end())
+    {
+      if (m_loader.has(placeholder.filename) && !m_loader.is_done(placeholder.filename))
+      {
+        m_placeholders.push_back(std::move(placeholder));
+        continue;
+      }
+
+      SDLSurfacePtr surface = take_decoded(placeholder.filename);
+      if (!surface.get())
+      {
+        try
+        {
+          surface = create_image_surface(placeholder.filename);
+        }
+        catch (const std::exception& err)
+        {
+          log_warning << "Couldn't load texture '" << placeholder.filename << "': " << err.what() << std::endl;
+        }
+      }
+      it = finished.emplace(placeholder.filename, std::move(surface)).first;
+    }
+
+    const SDLSurfacePtr& surface = it->second;
+    if (!surface.get())
+      continue;
+
+    if (placeholder.atlas_key)
+    {
+      // The page may have been released in the meantime.
+      Rect region;
+      if (!m_atlas.replace(*placeholder.atlas_key, *surface) && m_atlas.get(*placeholder.atlas_key, region))
+        log_warning << "Image '" << placeholder.filename << "' does not match the size in its header" << std::endl;
+    }
+    else if (TexturePtr texture = placeholder.texture.lock())
+    {
+      texture->reload(*surface);
+    }
+  }
+
+  m_loader.expire(s_prefetch_lifetime);
+  m_atlas.upload();
+}
+
+bool
+TextureManager::get_pending_image_size(const std::string& filename, int& width, int& height) const
+{
+  return m_loader.has(filename) && !m_loader.is_done(filename) &&
+         read_png_size(filename, width, height);
+}
+
+SDLSurfacePtr
+TextureManager::take_decoded(const std::string& filename)
+{
+  if (!m_loader.has(filename))
+    return {};
+
+  try
+  {
+    return m_loader.take(filename);
+  }
+  catch (const std::exception& err)
+  {
+    // The synchronous path tries again and reports the error.
+    log_debug << err.what() << std::endl;
+    return {};
+  }
+}
+
 void
 TextureManager::reap_cache_entry(const Texture::Key& key)
 {
@@ -288,7 +508,10 @@ TextureManager::get_surface(const std::string& filename)
     return *i->second;
   }
 
-  SDLSurfacePtr surface = create_image_surface(filename);
+  SDLSurfacePtr surface = take_decoded(filename);
+  if (!surface.get())
+    surface = create_image_surface(filename);
+
   return *(m_surfaces[filename] = std::move(surface));
 }
 
@@ -361,7 +584,22 @@ TextureManager::create_image_texture(const std::string& filename, const Sampler&
   m_load_successful = true;
   try
   {
-    SDLSurfacePtr surface = create_image_surface(filename);
+    int width;
+    int height;
+    if (get_pending_image_size(filename, width, height))
+    {
+      // Hand out a blank texture of the right size, update() fills it
+      // in once the image is decoded.
+      SDLSurfacePtr surface = SDLSurface::create_rgba(width, height);
+      TexturePtr texture = VideoSystem::current()->new_texture(*surface, sampler);
+      m_placeholders.push_back({ filename, texture, std::nullopt });
+      return texture;
+    }
+
+    SDLSurfacePtr surface = take_decoded(filename);
+    if (!surface.get())
+      surface = create_image_surface(filename);
+
     return VideoSystem::current()->new_texture(*surface, sampler);
   }
   catch (const std::exception& err)
@@ -457,6 +695,24 @@ TextureManager::reload()
 
     texture_ptr->reload(*surface);
   }
+
+  // Reload atlas images
+  for (const auto& key : m_atlas.get_keys())
+  {
+    try
+    {
+      SDLSurfacePtr surface = std::get<1>(key).empty() ?
+        create_image_surface(std::get<0>(key)) :
+        create_image_surface_raw(std::get<0>(key), std::get<1>(key), Sampler());
+
+      if (!m_atlas.replace(key, *surface))
+        log_warning << "Image '" << std::get<0>(key) << "' changed its size, not reloading it" << std::endl;
+    }
+    catch (const std::exception& err)
+    {
+      log_warning << "Couldn't reload texture '" << std::get<0>(key) << "': " << err.what() << std::endl;
+    }
+  }
 }
 
 void
@@ -495,4 +751,6 @@ TextureManager::debug_print(std::ostream& out) const
 
   out << "total surface count:" << m_surfaces.size() << std::endl;
   out << "total surface pixels:" << total_surface_pixels << std::endl;
+
+  m_atlas.debug_print(out);
 }
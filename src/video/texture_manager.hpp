@@ -28,9 +28,11 @@
 
 #include "math/rect.hpp"
 #include "util/currenton.hpp"
+#include "video/image_loader.hpp"
 #include "video/sampler.hpp"
 #include "video/sdl_surface_ptr.hpp"
 #include "video/texture.hpp"
+#include "video/texture_atlas.hpp"
 #include "video/texture_ptr.hpp"
 
 class GLTexture;
@@ -55,6 +57,22 @@ public:
                  const Sampler& sampler = Sampler());
   TexturePtr create_dummy_texture() const;
 
+  /** Like get(), but small images are packed into a shared atlas
+      texture. 'region' receives the image's area in the returned texture. */
+  TexturePtr get_region(const std::string& filename,
+                        const std::optional<Rect>& rect,
+                        Rect& region);
+
+  /** Starts decoding the given images in the background, so that
+      they are ready (or at least on their way) once they are needed.
+      Called when a level loads, so it also releases the atlas pages
+      nothing draws from anymore. */
+  void prefetch(const std::vector<std::string>& filenames);
+
+  /** Swaps decoded images into their placeholders and uploads atlas
+      pages that received new images, call before drawing. */
+  void update();
+
   void reload();
 
   void debug_print(std::ostream& out) const;
@@ -63,6 +81,14 @@ public:
 
 private:
   const SDL_Surface& get_surface(const std::string& filename);
+
+  /** Returns the image of 'filename' from the background loader, or
+      nullptr if it was not requested there or failed to decode. */
+  SDLSurfacePtr take_decoded(const std::string& filename);
+
+  /** Returns true and the image's size if 'filename' is still being
+      decoded and its size can be read from the header. */
+  bool get_pending_image_size(const std::string& filename, int& width, int& height) const;
   void reap_cache_entry(const Texture::Key& key);
 
   /** on failure a dummy texture is returned and no exception is thrown */
@@ -75,9 +101,22 @@ private:
 
   static SDLSurfacePtr create_dummy_surface();
 
+private:
+  /** A texture or atlas image that shows a blank image until its
+      file is decoded. */
+  struct Placeholder
+  {
+    std::string filename;
+    std::weak_ptr<Texture> texture;
+    std::optional<Texture::Key> atlas_key;
+  };
+
 private:
   std::map<Texture::Key, std::weak_ptr<Texture>> m_image_textures;
   std::unordered_map<std::string, SDLSurfacePtr> m_surfaces;
+  TextureAtlas m_atlas;
+  ImageLoader m_loader;
+  std::vector<Placeholder> m_placeholders;
   bool m_load_successful;
 
 private:
@@ -24,17 +24,37 @@
 #include "util/line_iterator.hpp"
 #include "physfs/physfs_sdl.hpp"
 #include "util/log.hpp"
+#include "util/utf8_iterator.hpp"
 #include "video/canvas.hpp"
+#include "video/sdl_surface.hpp"
 #include "video/surface.hpp"
+#include "video/ttf_surface.hpp"
 #include "video/ttf_surface_manager.hpp"
 
+namespace {
+
+/** Glyphs are small, so the pages can be too. */
+const int GLYPH_PAGE_SIZE = 512;
+
+/** Characters from here on are left to SDL_ttf, Hebrew and Arabic
+    need shaping and CJK would fill up the atlas quickly. */
+const uint32_t FIRST_UNCACHED_CODEPOINT = 0x0590;
+
+} // namespace
+
 TTFFont::TTFFont(const std::string& filename, int font_size, float line_spacing, int shadow_size, int border) :
   m_font(),
   m_filename(filename),
   m_font_size(font_size),
   m_line_spacing(line_spacing),
   m_shadow_size(shadow_size),
-  m_border(border)
+  m_border(border),
+  m_glyph_atlas(GLYPH_PAGE_SIZE),
+  m_glyphs(),
+  m_glyph_pages(),
+  m_layout(),
+  m_srcrects(),
+  m_dstrects()
 {
   m_font = TTF_OpenFontRW(get_physfs_SDLRWops(m_filename), 1, font_size);
   if (!m_font)
@@ -63,6 +83,13 @@ TTFFont::get_text_width(const std::string& text) const
   {
     const std::string& line = iter.get();
 
+    float layout_width;
+    if (layout_line(line, m_layout, layout_width))
+    {
+      max_width = std::max(max_width, layout_width);
+      continue;
+    }
+
     // Since get_cached_surface_width() takes a surface from the cache
     // instead of generating it from scratch,
     // it should be faster than doing a whole layout.
@@ -114,7 +141,53 @@ TTFFont::draw_text(Canvas& canvas, const std::string& text,
   {
     const std::string& line = iter.get();
 
-    if (!line.empty())
+    float layout_width;
+    if (!line.empty() && layout_line(line, m_layout, layout_width))
+    {
+      Vector new_pos(pos.x, last_y);
+
+      if (alignment == ALIGN_CENTER)
+        new_pos.x -= layout_width / 2.0f;
+      else if (alignment == ALIGN_RIGHT)
+        new_pos.x -= layout_width;
+
+      new_pos = glm::floor(new_pos);
+
+      if (new_pos.x < min_x)
+        min_x = new_pos.x;
+      if (layout_width > max_width)
+        max_width = layout_width;
+
+      m_glyph_atlas.upload();
+
+      // Shadows and borders of all glyphs go below the glyphs
+      // themselves, as they do in a rendered string.
+      const bool has_decoration = m_border > 0 || m_shadow_size > 0;
+      for (const bool decoration : { true, false })
+      {
+        if (decoration && !has_decoration)
+          continue;
+
+        for (const auto& page : m_glyph_pages)
+        {
+          m_srcrects.clear();
+          m_dstrects.clear();
+          for (const auto& placed : m_layout)
+          {
+            if (placed.glyph->page != page)
+              continue;
+
+            const Rectf& srcrect = decoration ? placed.glyph->decoration : placed.glyph->core;
+            m_srcrects.push_back(srcrect);
+            m_dstrects.push_back(Rectf(new_pos + Vector(placed.x, 0.0f), srcrect.get_size()));
+          }
+
+          if (!m_srcrects.empty())
+            canvas.draw_surface_batch(page, m_srcrects, m_dstrects, color, layer);
+        }
+      }
+    }
+    else if (!line.empty())
     {
       TTFSurfacePtr ttf_surface = TTFSurfaceManager::current()->create_surface(*this, line);
       const float width = static_cast<float>(ttf_surface->get_width());
@@ -143,6 +216,112 @@ TTFFont::draw_text(Canvas& canvas, const std::string& text,
   return Rectf(min_x, init_y, min_x + max_width, last_y);
 }
 
+const TTFFont::Glyph&
+TTFFont::get_glyph(uint32_t codepoint) const
+{
+  auto it = m_glyphs.find(codepoint);
+  if (it != m_glyphs.end())
+    return it->second;
+
+  Glyph& glyph = m_glyphs[codepoint];
+  glyph = { SurfacePtr(), Rectf(), Rectf(), 0, 0 };
+
+  int minx, maxx, miny, maxy, advance;
+  if (TTF_GlyphMetrics32(m_font, codepoint, &minx, &maxx, &miny, &maxy, &advance) < 0)
+    return glyph;
+
+  SDLSurfacePtr core(TTF_RenderGlyph32_Blended(m_font, codepoint, SDL_Color{255, 255, 255, 255}));
+  if (!core)
+    return glyph;
+
+  // Keep the decoration and the glyph on one page by packing them
+  // side by side into a single image, with a gap against bleeding.
+  const int gap = 2;
+  const bool has_decoration = m_border > 0 || m_shadow_size > 0;
+  SDLSurfacePtr decoration = has_decoration ? TTFSurface::render_effects(*this, *core, false) : SDLSurfacePtr();
+  const int decoration_width = has_decoration ? decoration->w + gap : 0;
+
+  SDLSurfacePtr image = SDLSurface::create_rgba(decoration_width + core->w,
+                                                has_decoration ? decoration->h : core->h);
+
+  SDL_SetSurfaceAlphaMod(core.get(), 255);
+  SDL_SetSurfaceColorMod(core.get(), 255, 255, 255);
+  SDL_SetSurfaceBlendMode(core.get(), SDL_BLENDMODE_NONE);
+  SDL_Rect core_dstrect{ decoration_width, 0, core->w, core->h };
+  SDL_BlitSurface(core.get(), nullptr, image.get(), &core_dstrect);
+
+  if (has_decoration)
+  {
+    SDL_SetSurfaceBlendMode(decoration.get(), SDL_BLENDMODE_NONE);
+    SDL_Rect decoration_dstrect{ 0, 0, decoration->w, decoration->h };
+    SDL_BlitSurface(decoration.get(), nullptr, image.get(), &decoration_dstrect);
+  }
+
+  Rect region;
+  TexturePtr texture = m_glyph_atlas.add(*image, region);
+  if (!texture)
+  {
+    log_warning << "Glyph atlas of '" << m_filename << "' is full" << std::endl;
+    return glyph;
+  }
+
+  auto page = std::find_if(m_glyph_pages.begin(), m_glyph_pages.end(),
+                           [&texture](const SurfacePtr& surface) { return surface->get_texture() == texture; });
+  glyph.page = (page != m_glyph_pages.end()) ? *page : m_glyph_pages.emplace_back(Surface::from_texture(texture));
+
+  const Vector origin(static_cast<float>(region.left), static_cast<float>(region.top));
+  glyph.core = Rectf(origin + Vector(static_cast<float>(decoration_width), 0.0f),
+                     Sizef(static_cast<float>(core->w), static_cast<float>(core->h)));
+  if (has_decoration)
+    glyph.decoration = Rectf(origin, Sizef(static_cast<float>(decoration->w), static_cast<float>(decoration->h)));
+
+  // SDL_ttf starts a string at the left edge of its first glyph, if
+  // that reaches to the left of the pen.
+  glyph.offset_x = std::min(0, minx);
+  glyph.advance = advance;
+  return glyph;
+}
+
+bool
+TTFFont::layout_line(const std::string& line, std::vector<PlacedGlyph>& glyphs, float& width) const
+{
+  glyphs.clear();
+  width = 0.0f;
+
+  int pen = 0;
+  uint32_t previous = 0;
+  for (UTF8Iterator it(line); !it.done(); ++it)
+  {
+    const uint32_t codepoint = *it;
+    if (codepoint == 0)
+    {
+      // Either the end of the string or a malformed sequence.
+      if (it.pos <= line.size())
+        return false;
+      break;
+    }
+
+    if (codepoint >= FIRST_UNCACHED_CODEPOINT)
+      return false;
+
+    const Glyph& glyph = get_glyph(codepoint);
+    if (!glyph.page)
+      return false;
+
+    if (previous != 0)
+      pen += TTF_GetFontKerningSizeGlyphs32(m_font, previous, codepoint);
+
+    const float x = static_cast<float>(pen + glyph.offset_x);
+    glyphs.push_back({ &glyph, x });
+    width = std::max(width, x + (glyph.decoration.empty() ? glyph.core.get_width() : glyph.decoration.get_width()));
+
+    pen += glyph.advance;
+    previous = codepoint;
+  }
+
+  return true;
+}
+
 std::string
 TTFFont::wrap_to_width(const std::string& text, float width, std::string* overflow)
 {
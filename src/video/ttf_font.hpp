@@ -18,10 +18,16 @@
 #pragma once
 
 #include <SDL_ttf.h>
+#include <stdint.h>
+#include <unordered_map>
+#include <vector>
 
 #include "math/fwd.hpp"
+#include "math/rectf.hpp"
 #include "video/color.hpp"
 #include "video/font.hpp"
+#include "video/surface_ptr.hpp"
+#include "video/texture_atlas.hpp"
 
 class Canvas;
 class Painter;
@@ -53,6 +59,34 @@ public:
 
   inline TTF_Font* get_ttf_font() const { return m_font; }
 
+private:
+  /** A character rendered into the glyph atlas. */
+  struct Glyph
+  {
+    /** The atlas page, nullptr if the glyph could not be rendered. */
+    SurfacePtr page;
+    Rectf core;
+    /** Shadow and border, empty if the font has neither. */
+    Rectf decoration;
+    /** Position relative to the pen, like in a rendered string. */
+    int offset_x;
+    int advance;
+  };
+
+  struct PlacedGlyph
+  {
+    const Glyph* glyph;
+    float x;
+  };
+
+private:
+  const Glyph& get_glyph(uint32_t codepoint) const;
+
+  /** Positions the glyphs of 'line' including kerning. Returns false
+      if the line has characters that need the whole string rendered
+      by SDL_ttf, e.g. because they might need shaping. */
+  bool layout_line(const std::string& line, std::vector<PlacedGlyph>& glyphs, float& width) const;
+
 private:
   TTF_Font* m_font;
   std::string m_filename;
@@ -61,6 +95,13 @@ private:
   int m_shadow_size;
   int m_border;
 
+  mutable TextureAtlas m_glyph_atlas;
+  mutable std::unordered_map<uint32_t, Glyph> m_glyphs;
+  mutable std::vector<SurfacePtr> m_glyph_pages;
+  mutable std::vector<PlacedGlyph> m_layout;
+  std::vector<Rectf> m_srcrects;
+  std::vector<Rectf> m_dstrects;
+
 private:
   TTFFont(const TTFFont&) = delete;
   TTFFont& operator=(const TTFFont&) = delete;
@@ -20,6 +20,7 @@
 #include <string>
 
 #include "math/vector.hpp"
+#include "video/sdl_surface_ptr.hpp"
 #include "video/surface_ptr.hpp"
 
 class TTFFont;
@@ -33,6 +34,10 @@ class TTFSurface final
 public:
   static TTFSurfacePtr create(const TTFFont& font, const std::string& text);
 
+  /** Draws the font's shadow and border around 'text_surface', plus
+      the white text itself if 'with_core' is set. */
+  static SDLSurfacePtr render_effects(const TTFFont& font, SDL_Surface& text_surface, bool with_core);
+
 public:
   TTFSurface(const SurfacePtr& surface, const Vector& offset);
 
@@ -57,10 +57,10 @@ void
 WorldMapObject::initialize()
 {
   // Set sector position from provided tile position
-  m_col.m_bbox.set_pos(Vector(32.0f * m_col.m_bbox.get_left() +
-                    (m_col.m_bbox.get_width() < 32.f ? (32.f - m_col.m_bbox.get_width()) / 2 : 0),
-                       32.0f * m_col.m_bbox.get_top() +
-                    (m_col.m_bbox.get_height() < 32.f ? (32.f - m_col.m_bbox.get_height()) / 2 : 0)));
+  m_col.set_pos(Vector(32.0f * m_col.m_bbox.get_left() +
+             (m_col.m_bbox.get_width() < 32.f ? (32.f - m_col.m_bbox.get_width()) / 2 : 0),
+                32.0f * m_col.m_bbox.get_top() +
+             (m_col.m_bbox.get_height() < 32.f ? (32.f - m_col.m_bbox.get_height()) / 2 : 0)));
   update_pos();
 }
 
@@ -110,10 +110,10 @@ WorldMapObject::after_editor_set()
   MovingSprite::after_editor_set();
 
   // Set sector position from provided tile position
-  m_col.m_bbox.set_pos(Vector(32.0f * m_tile_x +
-                    (m_col.m_bbox.get_width() < 32.f ? (32.f - m_col.m_bbox.get_width()) / 2 : 0),
-                       32.0f * m_tile_y +
-                    (m_col.m_bbox.get_height() < 32.f ? (32.f - m_col.m_bbox.get_height()) / 2 : 0)));
+  m_col.set_pos(Vector(32.0f * m_tile_x +
+             (m_col.m_bbox.get_width() < 32.f ? (32.f - m_col.m_bbox.get_width()) / 2 : 0),
+                32.0f * m_tile_y +
+             (m_col.m_bbox.get_height() < 32.f ? (32.f - m_col.m_bbox.get_height()) / 2 : 0)));
 }
 
 void
@@ -127,10 +127,10 @@ void
 WorldMapObject::update_pos(const Vector& pos)
 {
   // Set sector position to the provided position, rounding it to be divisible by 32
-  m_col.m_bbox.set_pos(Vector(32.0f * static_cast<int>(pos.x / 32) +
-                    (m_col.m_bbox.get_width() < 32.f ? (32.f - m_col.m_bbox.get_width()) / 2 : 0),
-                       32.0f * static_cast<int>(pos.y / 32) +
-                    (m_col.m_bbox.get_height() < 32.f ? (32.f - m_col.m_bbox.get_height()) / 2 : 0)));
+  m_col.set_pos(Vector(32.0f * static_cast<int>(pos.x / 32) +
+             (m_col.m_bbox.get_width() < 32.f ? (32.f - m_col.m_bbox.get_width()) / 2 : 0),
+                32.0f * static_cast<int>(pos.y / 32) +
+             (m_col.m_bbox.get_height() < 32.f ? (32.f - m_col.m_bbox.get_height()) / 2 : 0)));
   update_pos();
 }
 
@@ -149,7 +149,7 @@ WorldMapObject::move_to(const Vector& pos)
 void
 WorldMapObject::move(const Vector& dist)
 {
-  m_col.m_bbox.move(dist);
+  m_col.move(dist);
   update_pos(m_col.m_bbox.p1());
 }
 
@@ -0,0 +1,70 @@
+//  SuperTux
+//  Copyright (C) 2026 SuperTux Development Team
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#include "st_assert.hpp"
+#include "util/binary_sexp.hpp"
+
+#include <sexp/parser.hpp>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace {
+
+bool throws_on_read(const std::string& data)
+{
+  try
+  {
+    BinarySexp::read(data);
+    return false;
+  }
+  catch (const std::runtime_error&)
+  {
+    return true;
+  }
+}
+
+} // namespace
+
+int main(void)
+{
+  const sexp::Value sx = sexp::Parser::from_string(
+    "(supertux-level\n"
+    "  (version 3)\n"
+    "  (name (_ \"Test\"))\n"
+    "  (sector\n"
+    "    (name \"main\")\n"
+    "    (tilemap (solid #t) (speed 0.5) (width 4) (height 2)\n"
+    "      (tiles 0 1 2 3 -4 5 6 2147483647))\n"
+    "    (spawnpoint (name \"main\") (x 32) (y 64.25)))\n"
+    "  (sector (name \"other\") (empty) (short 1 2 \"a\" 3)))\n",
+    sexp::Parser::USE_ARRAYS);
+
+  const std::string data = BinarySexp::write(sx);
+  ST_ASSERT("documents survive the round trip", BinarySexp::read(data).str() == sx.str());
+
+  const std::vector<std::vector<int>> arrays = { { 1, -3, 2, 0 }, {}, { 2147483647 } };
+  std::vector<std::vector<int>> read_arrays;
+  const std::string data_with_arrays = BinarySexp::write(sx, arrays);
+  ST_ASSERT("integer arrays survive the round trip",
+            BinarySexp::read(data_with_arrays, read_arrays).str() == sx.str() && read_arrays == arrays);
+
+  ST_ASSERT("truncated documents are rejected", throws_on_read(data.substr(0, data.size() - 1)));
+  ST_ASSERT("trailing data is rejected", throws_on_read(data + '\0'));
+  ST_ASSERT("foreign data is rejected", throws_on_read("(supertux-level)"));
+
+  return 0;
+}
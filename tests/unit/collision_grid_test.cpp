@@ -0,0 +1,69 @@
+//  SuperTux
+//  Copyright (C) 2026 SuperTux Development Team
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#include "st_assert.hpp"
+#include "collision/collision_grid.hpp"
+#include "math/rectf.hpp"
+
+#include <limits>
+#include <vector>
+
+int main(void)
+{
+  CollisionGrid grid(32.0f);
+  std::vector<size_t> result;
+
+  grid.insert(3, Rectf(0.0f, 0.0f, 16.0f, 16.0f));
+  grid.insert(1, Rectf(100.0f, 100.0f, 120.0f, 120.0f));
+  grid.insert(2, Rectf(10.0f, 10.0f, 40.0f, 40.0f));
+
+  grid.query(Rectf(8.0f, 8.0f, 12.0f, 12.0f), result);
+  ST_ASSERT("query finds nearby entries in ascending order",
+            result == std::vector<size_t>({ 2, 3 }));
+
+  grid.query(Rectf(500.0f, 500.0f, 510.0f, 510.0f), result);
+  ST_ASSERT("query far away finds nothing", result.empty());
+
+  // Touching edges count as overlap for Rectf, so the grid must report them too.
+  grid.insert(4, Rectf(200.0f, 200.0f, 224.0f, 210.0f));
+  grid.query(Rectf(224.0f, 200.0f, 240.0f, 210.0f), result);
+  ST_ASSERT("query on cell border", result == std::vector<size_t>({ 4 }));
+  grid.remove(4, Rectf(200.0f, 200.0f, 224.0f, 210.0f));
+
+  grid.move(1, Rectf(100.0f, 100.0f, 120.0f, 120.0f), Rectf(0.0f, 20.0f, 8.0f, 28.0f));
+  grid.query(Rectf(8.0f, 8.0f, 12.0f, 12.0f), result);
+  ST_ASSERT("moved entry is found at its new position",
+            result == std::vector<size_t>({ 1, 2, 3 }));
+  grid.query(Rectf(100.0f, 100.0f, 120.0f, 120.0f), result);
+  ST_ASSERT("moved entry is gone from its old position", result.empty());
+
+  grid.insert(7, Rectf(-100000.0f, -100000.0f, 100000.0f, 100000.0f));
+  grid.query(Rectf(500.0f, 500.0f, 510.0f, 510.0f), result);
+  ST_ASSERT("oversized entries are always returned", result == std::vector<size_t>({ 7 }));
+
+  const float nan = std::numeric_limits<float>::quiet_NaN();
+  grid.insert(8, Rectf(Vector(nan, nan), Sizef(1.0f, 1.0f)));
+  grid.query(Rectf(500.0f, 500.0f, 510.0f, 510.0f), result);
+  ST_ASSERT("non-finite entries are always returned", result == std::vector<size_t>({ 7, 8 }));
+
+  grid.clear();
+  grid.query(Rectf(8.0f, 8.0f, 12.0f, 12.0f), result);
+  ST_ASSERT("clear removes all entries", result.empty());
+
+  return 0;
+}
+
+/* EOF */
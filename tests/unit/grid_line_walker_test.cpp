@@ -0,0 +1,160 @@
+//  SuperTux
+//  Copyright (C) 2026 SuperTux Development Team
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#include "st_assert.hpp"
+#include "math/grid_line_walker.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <utility>
+#include <vector>
+
+namespace {
+
+std::vector<std::pair<int, int>> walk(const Vector& start, const Vector& end, float cell_size)
+{
+  std::vector<std::pair<int, int>> cells;
+  GridLineWalker walker(start, end, cell_size);
+  while (walker.next())
+    cells.emplace_back(walker.get_x(), walker.get_y());
+  return cells;
+}
+
+bool is_connected(const std::vector<std::pair<int, int>>& cells)
+{
+  for (size_t i = 1; i < cells.size(); ++i)
+  {
+    const int dx = std::abs(cells[i].first - cells[i - 1].first);
+    const int dy = std::abs(cells[i].second - cells[i - 1].second);
+    if (dx + dy != 1)
+      return false;
+  }
+  return true;
+}
+
+const int MAP_SIZE = 512;
+
+// The raycast as it used to be done: sample the whole bounding rectangle
+// of the line in 16px steps.
+int sampled_raycast(const std::vector<bool>& solid, const Vector& start, const Vector& end, int& lookups)
+{
+  const float lsx = std::min(start.x, end.x);
+  const float lex = std::max(start.x, end.x);
+  const float lsy = std::min(start.y, end.y);
+  const float ley = std::max(start.y, end.y);
+
+  for (float test_x = lsx; test_x <= lex; test_x += 16) { // NOLINT
+    for (float test_y = lsy; test_y <= ley; test_y += 16) { // NOLINT
+      const int x = static_cast<int>(test_x / 32.0f);
+      const int y = static_cast<int>(test_y / 32.0f);
+      lookups += 1;
+      if (solid[y * MAP_SIZE + x])
+        return y * MAP_SIZE + x;
+    }
+  }
+  return -1;
+}
+
+int walked_raycast(const std::vector<bool>& solid, const Vector& start, const Vector& end, int& lookups)
+{
+  GridLineWalker walker(start, end, 32.0f);
+  while (walker.next())
+  {
+    lookups += 1;
+    const int idx = walker.get_y() * MAP_SIZE + walker.get_x();
+    if (solid[idx])
+      return idx;
+  }
+  return -1;
+}
+
+} // namespace
+
+int main(void)
+{
+  {
+    const auto cells = walk(Vector(5.0f, 5.0f), Vector(100.0f, 5.0f), 32.0f);
+    ST_ASSERT("horizontal line visits 4 cells", cells.size() == 4);
+    ST_ASSERT("horizontal line ends in cell 3", cells.back() == std::make_pair(3, 0));
+  }
+
+  {
+    const auto cells = walk(Vector(100.0f, 70.0f), Vector(-40.0f, -10.0f), 32.0f);
+    ST_ASSERT("backwards line starts in start cell", cells.front() == std::make_pair(3, 2));
+    ST_ASSERT("backwards line ends in end cell", cells.back() == std::make_pair(-2, -1));
+    ST_ASSERT("backwards line is connected", is_connected(cells));
+  }
+
+  {
+    const auto cells = walk(Vector(10.0f, 10.0f), Vector(10.0f, 10.0f), 32.0f);
+    ST_ASSERT("point visits a single cell", cells.size() == 1);
+  }
+
+  {
+    const auto cells = walk(Vector(1.0f, 2.0f), Vector(1000.0f, 777.0f), 32.0f);
+    ST_ASSERT("diagonal line starts in start cell", cells.front() == std::make_pair(0, 0));
+    ST_ASSERT("diagonal line ends in end cell", cells.back() == std::make_pair(31, 24));
+    ST_ASSERT("diagonal line is connected", is_connected(cells));
+    ST_ASSERT("diagonal line visits each row and column once", cells.size() == 32 + 25 - 1);
+  }
+
+  // Benchmark: long diagonal rays over an empty map, with a wall at the far end.
+  {
+    std::vector<bool> solid(MAP_SIZE * MAP_SIZE, false);
+    for (int y = 0; y < MAP_SIZE; ++y)
+      solid[y * MAP_SIZE + (MAP_SIZE - 1)] = true;
+
+    const int rays = 50;
+    int sampled_lookups = 0;
+    int walked_lookups = 0;
+    bool same_hits = true;
+
+    const auto sampled_begin = std::chrono::steady_clock::now();
+    std::vector<int> sampled_hits;
+    for (int i = 0; i < rays; ++i)
+    {
+      const Vector start(16.0f, 16.0f + static_cast<float>(i));
+      const Vector end(MAP_SIZE * 32.0f - 16.0f, MAP_SIZE * 32.0f - 300.0f + static_cast<float>(i));
+      sampled_hits.push_back(sampled_raycast(solid, start, end, sampled_lookups));
+    }
+    const auto sampled_end = std::chrono::steady_clock::now();
+
+    for (int i = 0; i < rays; ++i)
+    {
+      const Vector start(16.0f, 16.0f + static_cast<float>(i));
+      const Vector end(MAP_SIZE * 32.0f - 16.0f, MAP_SIZE * 32.0f - 300.0f + static_cast<float>(i));
+      const int hit = walked_raycast(solid, start, end, walked_lookups);
+      same_hits &= (hit >= 0) == (sampled_hits[i] >= 0);
+    }
+    const auto walked_end = std::chrono::steady_clock::now();
+
+    using std::chrono::duration_cast;
+    using std::chrono::microseconds;
+    std::cout << "-- " << rays << " diagonal rays over " << MAP_SIZE << "x" << MAP_SIZE << " tiles:\n"
+              << "--   sampled: " << sampled_lookups << " tile lookups, "
+              << duration_cast<microseconds>(sampled_end - sampled_begin).count() << " us\n"
+              << "--   walked:  " << walked_lookups << " tile lookups, "
+              << duration_cast<microseconds>(walked_end - sampled_end).count() << " us" << std::endl;
+
+    ST_ASSERT("walked rays hit the wall too", same_hits);
+    ST_ASSERT("walked rays need fewer tile lookups", walked_lookups * 100 < sampled_lookups);
+  }
+
+  return 0;
+}
+
+/* EOF */
@@ -0,0 +1,88 @@
+//  SuperTux
+//  Copyright (C) 2026 SuperTux Development Team
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#include "st_assert.hpp"
+#include "util/job_system.hpp"
+
+#include <atomic>
+#include <numeric>
+#include <stdexcept>
+#include <vector>
+
+namespace {
+
+void test_job_system(int num_workers)
+{
+  JobSystem job_system(num_workers);
+
+  std::vector<int> values(10000, 0);
+  job_system.parallel_for(0, values.size(), 64, [&values](size_t begin, size_t end) {
+    for (size_t i = begin; i < end; ++i)
+      values[i] += static_cast<int>(i);
+  });
+  ST_ASSERT("parallel_for visits every index once",
+            std::accumulate(values.begin(), values.end(), 0LL) == 9999LL * 10000LL / 2);
+
+  std::atomic<int> count(0);
+  {
+    JobGroup group(job_system);
+    for (int i = 0; i < 100; ++i)
+    {
+      group.run([&job_system, &count] {
+        // Nested fork/join from within a job.
+        JobGroup inner(job_system);
+        for (int j = 0; j < 10; ++j)
+          inner.run([&count] { ++count; });
+        inner.wait();
+      });
+    }
+    group.wait();
+  }
+  ST_ASSERT("nested groups run all jobs", count == 1000);
+
+  bool thrown = false;
+  try
+  {
+    JobGroup group(job_system);
+    group.run([] { throw std::runtime_error("job failed"); });
+    group.run([] {});
+    group.wait();
+  }
+  catch (const std::runtime_error&)
+  {
+    thrown = true;
+  }
+  ST_ASSERT("wait() rethrows job exceptions", thrown);
+
+  count = 0;
+  for (int i = 0; i < 50; ++i)
+    job_system.submit([&count] { ++count; });
+  job_system.shutdown();
+  ST_ASSERT("shutdown() finishes queued jobs", count == 50);
+
+  job_system.submit([&count] { ++count; });
+  ST_ASSERT("jobs run inline after shutdown()", count == 51);
+}
+
+} // namespace
+
+int main(void)
+{
+  test_job_system(0);
+  test_job_system(1);
+  test_job_system(4);
+  return 0;
+}
@@ -0,0 +1,70 @@
+//  SuperTux
+//  Copyright (C) 2026 SuperTux Development Team
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#include "st_assert.hpp"
+#include "collision/raycast_grid.hpp"
+#include "math/rectf.hpp"
+
+#include <vector>
+
+int main(void)
+{
+  RaycastGrid grid(32.0f);
+  std::vector<Rectf> rects = {
+    Rectf(600.0f, 0.0f, 632.0f, 32.0f),
+    Rectf(400.0f, 0.0f, 432.0f, 32.0f),
+    Rectf(0.0f, 200.0f, 32.0f, 232.0f)
+  };
+  std::vector<bool> ignored(rects.size(), false);
+
+  const RaycastGrid::GetRect get_rect = [&rects, &ignored](size_t i) -> const Rectf* {
+    return ignored[i] ? nullptr : &rects[i];
+  };
+  const auto raycast = [&grid, &rects, &get_rect](const Vector& start, const Vector& end) {
+    grid.update(rects.size(), get_rect);
+    return grid.get_first_on_line(start, end, get_rect);
+  };
+
+  const Vector start(0.0f, 16.0f);
+  const Vector end(1000.0f, 16.0f);
+
+  ST_ASSERT("the closest rect is hit", raycast(start, end) == 1u);
+  ST_ASSERT("lines past all rects hit nothing", !raycast(Vector(0.0f, 100.0f), Vector(1000.0f, 100.0f)));
+
+  ignored[1] = true;
+  ST_ASSERT("left out rects are passed through", raycast(start, end) == 0u);
+  ignored[1] = false;
+
+  // Moving rects between two raycasts of the same frame, like objects
+  // do in their update().
+  rects[0].move(Vector(-500.0f, 0.0f));
+  grid.invalidate();
+  ST_ASSERT("a rect moved into a closer cell is hit", raycast(start, end) == 0u);
+
+  rects[0].move(Vector(0.0f, 300.0f));
+  grid.invalidate();
+  ST_ASSERT("a rect moved off the line is not hit", raycast(start, end) == 1u);
+
+  rects[2].move(Vector(200.0f, -200.0f));
+  grid.invalidate();
+  ST_ASSERT("a rect moved onto the line from far away is hit", raycast(start, end) == 2u);
+
+  rects[2] = rects[1];
+  grid.invalidate();
+  ST_ASSERT("ties go to the lower index", raycast(start, end) == 1u);
+
+  return 0;
+}
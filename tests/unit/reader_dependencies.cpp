@@ -0,0 +1,52 @@
+//  SuperTux
+//  Copyright (C) 2026 SuperTux Development Team
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#include <iostream>
+#include <string>
+
+#include "physfs/ifile_stream.hpp"
+#include "util/file_system.hpp"
+#include "util/log.hpp"
+
+// The reader tests link the reader sources on their own. These stand in
+// for the logging, PhysFS and file system code ReaderDocument::from_file()
+// and get_directory() use, which would pull in most of the game.
+
+LogLevel g_log_level = LOG_WARNING;
+
+std::ostream&
+log_debug_f(const char*, int, bool)
+{
+  return std::cerr;
+}
+
+IFileStream::IFileStream(const std::string&) :
+  std::istream(nullptr),
+  sb()
+{
+  setstate(std::ios::badbit);
+}
+
+namespace FileSystem {
+
+std::string
+dirname(const std::string& filename)
+{
+  const std::string::size_type p = filename.find_last_of('/');
+  return (p == std::string::npos) ? "./" : filename.substr(0, p + 1);
+}
+
+} // namespace FileSystem
@@ -0,0 +1,235 @@
+//  SuperTux
+//  Copyright (C) 2026 SuperTux Development Team
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#include "st_assert.hpp"
+#include "util/reader_document.hpp"
+#include "util/reader_mapping.hpp"
+
+#include <chrono>
+#include <functional>
+#include <iostream>
+#include <optional>
+#include <sexp/value.hpp>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#ifdef __linux__
+#include <sys/resource.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#endif
+
+namespace {
+
+std::optional<ReaderMapping>
+get_tilemap(const ReaderDocument& doc)
+{
+  std::optional<ReaderMapping> tilemap;
+  doc.get_root().get_mapping().get("tilemap", tilemap);
+  return tilemap;
+}
+
+std::vector<unsigned int>
+get_tiles(const ReaderDocument& doc)
+{
+  std::vector<unsigned int> tiles;
+  get_tilemap(doc)->get_compressed("tiles", tiles);
+  return tiles;
+}
+
+/** Returns the message of the error parsing 'text' and reading an
+    integer "width" from its tilemap raises, empty if there is none.
+    The level parser has to agree with the plain one on all of them. */
+std::string
+get_error(const std::string& text, bool level)
+{
+  try
+  {
+    const ReaderDocument doc = level ? ReaderDocument::from_level_string(text, "test.stl")
+                                     : ReaderDocument::from_string(text, "test.stl");
+    int width = 0;
+    get_tilemap(doc)->get("width", width);
+    return std::string();
+  }
+  catch (const std::exception& err)
+  {
+    return err.what();
+  }
+}
+
+/** Returns a level with 'layers' tilemaps of 'width' x 'height' tiles,
+    written out one row per line like the editor does. */
+std::string
+generate_level(int width, int height, int layers)
+{
+  std::ostringstream out;
+  out << "(supertux-level\n"
+      << "  (version 3)\n"
+      << "  (sector\n"
+      << "    (name \"main\")\n";
+  for (int layer = 0; layer < layers; ++layer)
+  {
+    out << "    (tilemap\n"
+        << "      (z-pos " << layer * 50 - 100 << ")\n"
+        << "      (width " << width << ")\n"
+        << "      (height " << height << ")\n"
+        << "      (tiles";
+    for (int y = 0; y < height; ++y)
+    {
+      out << "\n       ";
+      for (int x = 0; x < width; ++x)
+        out << " " << ((x * 7 + y * 13 + layer) % 5 == 0 ? 0 : (x + y * 31 + layer * 101) % 3000);
+    }
+    out << "))\n";
+  }
+  out << "))\n";
+  return out.str();
+}
+
+/** Returns the peak resident set size in KiB of a child process that
+    runs 'func', or -1 where that can't be measured. Measuring in a
+    child keeps the runs apart, the peak of a process never goes down. */
+long
+get_peak_rss(const std::function<void ()>& func)
+{
+#ifdef __linux__
+  const pid_t pid = fork();
+  if (pid == 0)
+  {
+    func();
+    _exit(0);
+  }
+
+  int status = 0;
+  struct rusage usage = {};
+  if (pid < 0 || wait4(pid, &status, 0, &usage) != pid || !WIFEXITED(status))
+    return -1;
+  return usage.ru_maxrss;
+#else
+  (void)func;
+  return -1;
+#endif
+}
+
+/** Times both parsers on a generated level of the size of the largest
+    bundled ones, the results have to agree. */
+void
+benchmark_large_level()
+{
+  const std::string level = generate_level(1000, 200, 4);
+  const auto parse = [&level](bool fast) {
+    return fast ? ReaderDocument::from_level_string(level, "large.stl")
+                : ReaderDocument::from_string(level, "large.stl");
+  };
+
+  // Before anything gets parsed here, the children would count the
+  // memory left behind by it otherwise.
+  long rss[2];
+  for (int i = 0; i < 2; ++i)
+    rss[i] = get_peak_rss([&parse, i] { parse(i == 1); });
+
+  std::vector<unsigned int> tiles[2];
+  for (int i = 0; i < 2; ++i)
+  {
+    const auto start = std::chrono::steady_clock::now();
+    const ReaderDocument doc = parse(i == 1);
+    const std::chrono::duration<double, std::milli> duration = std::chrono::steady_clock::now() - start;
+
+    std::optional<ReaderMapping> sector;
+    doc.get_root().get_mapping().get("sector", sector);
+    std::optional<ReaderMapping> tilemap;
+    sector->get("tilemap", tilemap);
+    tilemap->get_compressed("tiles", tiles[i]);
+
+    std::cout << (i == 1 ? "from_level_string" : "from_string") << ": "
+              << level.size() / 1024 << " KiB parsed in " << duration.count() << " ms, peak RSS ";
+    if (rss[i] < 0)
+      std::cout << "not measured" << std::endl;
+    else
+      std::cout << rss[i] << " KiB" << std::endl;
+  }
+
+  ST_ASSERT("both parsers read the same tiles of a large level",
+            tiles[0].size() == 1000 * 200 && tiles[0] == tiles[1]);
+}
+
+} // namespace
+
+int main(void)
+{
+  const std::string level =
+    "(supertux-level\n"
+    "  (tilemap\n"
+    "    (name \"(tiles 7 8 9)\")\n"
+    "    ; (tiles 4 5 6)\n"
+    "    (tiles -3 1 0\n"
+    "           -2 5 2)))\n";
+
+  const ReaderDocument doc = ReaderDocument::from_level_string(level, "test.stl");
+  const std::vector<unsigned int> expected = { 1, 1, 1, 0, 5, 5, 2 };
+  ST_ASSERT("run length encoded tiles are expanded", get_tiles(doc) == expected);
+  ST_ASSERT("tiles match the plain parser", get_tiles(ReaderDocument::from_string(level)) == expected);
+  ST_ASSERT("only the tiles list is moved into an array",
+            doc.get_integer_arrays().size() == 1 && doc.get_integer_arrays()[0].size() == 6);
+
+  std::string name;
+  get_tilemap(doc)->get("name", name);
+  ST_ASSERT("(tiles inside a string is left alone", name == "(tiles 7 8 9)");
+
+  const std::string real =
+    "(supertux-level\n"
+    "  (tilemap (tiles 1 2.5 3)))\n";
+  const ReaderDocument real_doc = ReaderDocument::from_level_string(real, "test.stl");
+  sexp::Value tiles;
+  get_tilemap(real_doc)->get("tiles", tiles);
+  ST_ASSERT("lists with real numbers fall back to the sexp parser",
+            real_doc.get_integer_arrays().empty() && tiles.is_array() &&
+            tiles.as_array().size() == 4 && tiles.as_array()[2].is_real());
+
+  const std::string overflow =
+    "(supertux-level\n"
+    "  (tilemap (tiles 1 2147483648 3)))\n";
+  ST_ASSERT("lists with integers out of range fall back to the sexp parser",
+            get_error(overflow, true) == get_error(overflow, false));
+
+  const std::string reader_error =
+    "(supertux-level\n"
+    "  (tilemap\n"
+    "    (tiles 0 1\n"
+    "           2 3\n"
+    "           4 5)\n"
+    "    (width \"wide\")))\n";
+  const std::string error = get_error(reader_error, true);
+  ST_ASSERT("reader errors after tiles are raised", !error.empty());
+  ST_ASSERT("reader errors after tiles keep their line", error == get_error(reader_error, false));
+
+  const std::string parse_error =
+    "(supertux-level\n"
+    "  (tilemap\n"
+    "    (tiles 0 1\n"
+    "           2 3)\n"
+    "    (width 4)\n"
+    "    (name \"unterminated)))\n";
+  const std::string level_parse_error = get_error(parse_error, true);
+  ST_ASSERT("parse errors after tiles are raised", !level_parse_error.empty());
+  ST_ASSERT("parse errors after tiles keep their line", level_parse_error == get_error(parse_error, false));
+
+  benchmark_large_level();
+
+  return 0;
+}
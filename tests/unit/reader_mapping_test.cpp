@@ -0,0 +1,159 @@
+//  SuperTux
+//  Copyright (C) 2026 SuperTux Development Team
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#include "st_assert.hpp"
+#include "util/reader_document.hpp"
+#include "util/reader_mapping.hpp"
+
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <sexp/value.hpp>
+#include <sstream>
+#include <stdexcept>
+#include <vector>
+
+namespace {
+
+bool
+get_throws(const ReaderMapping& mapping, const char* key)
+{
+  try
+  {
+    int value = 0;
+    mapping.get(key, value);
+    return false;
+  }
+  catch (const std::runtime_error&)
+  {
+    return true;
+  }
+}
+
+void
+test_key_index(bool key_index)
+{
+  ReaderMapping::s_key_index_enabled = key_index;
+
+  const auto doc = ReaderDocument::from_string(
+    "(supertux-test\n"
+    "   (a 1) (b 2) (c 3) (d 4) (e 5) (f 6) (g 7) (h 8)\n"
+    "   (a 9) (i 10)\n"
+    "   err\n"
+    "   (j 11)\n"
+    ")\n");
+  const auto mapping = doc.get_root().get_mapping();
+
+  int a = 0;
+  int i = 0;
+  ST_ASSERT("the first of duplicate keys wins", mapping.get("a", a) && a == 1);
+  ST_ASSERT("keys after duplicates are found", mapping.get("i", i) && i == 10);
+
+  // Keys behind a malformed entry still raise the error they always did.
+  ST_ASSERT("keys after a malformed entry raise an error", get_throws(mapping, "j"));
+  ST_ASSERT("missing keys raise an error after a malformed entry", get_throws(mapping, "does-not-exist"));
+}
+
+/** Looks up every key of every mapping in 'sx', like the object
+    constructors do. Returns the number of keys found. */
+int
+lookup_all_keys(const ReaderDocument& doc, const sexp::Value& sx)
+{
+  if (!sx.is_array() || sx.as_array().empty() || !sx.as_array()[0].is_symbol())
+    return 0;
+
+  const auto& items = sx.as_array();
+  for (size_t i = 1; i < items.size(); ++i)
+  {
+    if (!items[i].is_array() || items[i].as_array().empty() || !items[i].as_array()[0].is_symbol())
+      return 0;
+  }
+
+  int found = 0;
+  ReaderMapping mapping(doc, sx);
+  for (size_t i = 1; i < items.size(); ++i)
+  {
+    // Entries with more than one value are objects, not properties.
+    const auto& pair = items[i].as_array();
+    if (pair.size() == 2)
+    {
+      try
+      {
+        sexp::Value value;
+        if (mapping.get(pair[0].as_string().c_str(), value))
+          found += 1;
+      }
+      catch (const std::runtime_error&)
+      {
+        // The first entry with this key is an object.
+        found += 1;
+      }
+    }
+    found += lookup_all_keys(doc, items[i]);
+  }
+  return found;
+}
+
+/** Times looking up the keys of all bundled levels with and without
+    the key index, the results have to agree. */
+void
+benchmark_bundled_levels()
+{
+  const std::filesystem::path levels = std::filesystem::path(SUPERTUX_TEST_DATA_DIR) / "levels";
+  if (!std::filesystem::exists(levels))
+  {
+    std::cout << "Skipping benchmark, no levels in " << levels << std::endl;
+    return;
+  }
+
+  std::vector<ReaderDocument> docs;
+  for (const auto& entry : std::filesystem::recursive_directory_iterator(levels))
+  {
+    if (entry.path().extension() != ".stl")
+      continue;
+
+    std::ifstream in(entry.path());
+    docs.push_back(ReaderDocument::from_stream(in, entry.path().string()));
+  }
+
+  const auto run = [&docs](bool key_index) {
+    ReaderMapping::s_key_index_enabled = key_index;
+    const auto start = std::chrono::steady_clock::now();
+    int found = 0;
+    for (const auto& doc : docs)
+      found += lookup_all_keys(doc, doc.get_sexp());
+    const std::chrono::duration<double, std::milli> duration = std::chrono::steady_clock::now() - start;
+    std::cout << (key_index ? "With" : "Without") << " key index: " << docs.size() << " levels, "
+              << found << " lookups in " << duration.count() << " ms" << std::endl;
+    return found;
+  };
+
+  const int found_scan = run(false);
+  const int found_index = run(true);
+  ST_ASSERT("the key index finds the same keys as the scan", found_scan == found_index);
+}
+
+} // namespace
+
+int main(void)
+{
+  test_key_index(false);
+  test_key_index(true);
+  benchmark_bundled_levels();
+
+  return 0;
+}
@@ -0,0 +1,73 @@
+//  SuperTux
+//  Copyright (C) 2026 SuperTux Development Team
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#include "st_assert.hpp"
+#include "audio/ring_buffer.hpp"
+
+#include <algorithm>
+#include <thread>
+#include <vector>
+
+int main(void)
+{
+  RingBuffer ring(1000);
+  ST_ASSERT("capacity gets rounded up to a power of two", ring.capacity() == 1024);
+
+  std::vector<char> data(1500);
+  for (size_t i = 0; i < data.size(); ++i)
+    data[i] = static_cast<char>(i);
+
+  ST_ASSERT("write() stops when full", ring.write(data.data(), data.size()) == 1024);
+  ST_ASSERT("full buffer has no room", ring.writable() == 0);
+
+  std::vector<char> out(1500);
+  ST_ASSERT("read() returns what's there", ring.read(out.data(), 1000) == 1000);
+  ST_ASSERT("wrapped write", ring.write(data.data() + 1024, 476) == 476);
+  ST_ASSERT("wrapped read", ring.read(out.data() + 1000, 1500) == 500);
+  ST_ASSERT("bytes come out in order", out == data);
+
+  // One producer and one consumer thread.
+  const size_t total = 1 << 22;
+  std::thread producer([&ring, total] {
+    size_t written = 0;
+    char chunk[333];
+    while (written < total)
+    {
+      size_t size = std::min(sizeof(chunk), total - written);
+      for (size_t i = 0; i < size; ++i)
+        chunk[i] = static_cast<char>((written + i) % 251);
+      size_t done = 0;
+      while (done < size)
+        done += ring.write(chunk + done, size - done);
+      written += size;
+    }
+  });
+
+  bool in_order = true;
+  size_t received = 0;
+  char chunk[500];
+  while (received < total)
+  {
+    size_t size = ring.read(chunk, sizeof(chunk));
+    for (size_t i = 0; i < size; ++i)
+      in_order = in_order && chunk[i] == static_cast<char>((received + i) % 251);
+    received += size;
+  }
+  producer.join();
+  ST_ASSERT("threaded transfer keeps the bytes in order", in_order && ring.readable() == 0);
+
+  return 0;
+}
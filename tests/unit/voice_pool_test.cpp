@@ -0,0 +1,115 @@
+//  SuperTux
+//  Copyright (C) 2026 SuperTux Development Team
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#include "st_assert.hpp"
+#include "audio/voice_pool.hpp"
+
+#include <alc.h>
+#include <iostream>
+#include <stdlib.h>
+#include <vector>
+
+namespace {
+
+std::shared_ptr<const ALuint> make_buffer()
+{
+  // One second of silence, so voices keep playing through the test.
+  std::vector<short> samples(44100, 0);
+  ALuint buffer;
+  alGenBuffers(1, &buffer);
+  alBufferData(buffer, AL_FORMAT_MONO16, samples.data(),
+               static_cast<ALsizei>(samples.size() * sizeof(short)), 44100);
+  return std::shared_ptr<const ALuint>(new ALuint(buffer), [](const ALuint* b) {
+    alDeleteBuffers(1, b);
+    delete b;
+  });
+}
+
+VoicePool::Sound make_sound(const std::shared_ptr<const ALuint>& buffer, int priority, float distance)
+{
+  VoicePool::Sound sound;
+  sound.buffer = buffer;
+  sound.gain = 0.5f;
+  sound.priority = priority;
+  sound.distance = distance;
+  sound.position = Vector(distance, 0.0f);
+  return sound;
+}
+
+} // namespace
+
+int main(void)
+{
+  // OpenAL Soft's null backend mixes without an audio device.
+  setenv("ALSOFT_DRIVERS", "null", 1);
+
+  ALCdevice* device = alcOpenDevice(nullptr);
+  if (!device)
+  {
+    std::cout << "-- No OpenAL device, skipping" << std::endl;
+    return 0;
+  }
+  ALCcontext* context = alcCreateContext(device, nullptr);
+  alcMakeContextCurrent(context);
+
+  {
+    std::vector<std::shared_ptr<const ALuint>> buffers;
+    for (int i = 0; i < 8; ++i)
+      buffers.push_back(make_buffer());
+
+    VoicePool pool(16);
+    ST_ASSERT("pool allocates its sources", pool.size() == 16);
+
+    // Same buffer, same moment: one voice.
+    uint32_t time = 0;
+    ST_ASSERT("first play starts", pool.play(make_sound(buffers[0], 0, 10.0f), time) == VoicePool::STARTED);
+    ST_ASSERT("immediate replay coalesces", pool.play(make_sound(buffers[0], 0, 10.0f), time + 5) == VoicePool::COALESCED);
+    ST_ASSERT("later replay starts", pool.play(make_sound(buffers[0], 0, 10.0f), time + 50) == VoicePool::STARTED);
+
+    // Fill the pool with far away, low priority sounds.
+    time = 1000;
+    for (size_t i = pool.get_playing_count(); i < pool.size(); ++i)
+      pool.play(make_sound(buffers[1 + i % 7], 0, 1000.0f), time++);
+    ST_ASSERT("pool is full", pool.get_playing_count() == pool.size());
+
+    ST_ASSERT("farther sound gets dropped",
+              pool.play(make_sound(buffers[1], 0, 2000.0f), time += 100) == VoicePool::DROPPED);
+    ST_ASSERT("nearer sound steals", pool.play(make_sound(buffers[1], 0, 10.0f), time += 100) == VoicePool::STOLEN);
+    ST_ASSERT("higher priority steals", pool.play(make_sound(buffers[2], 1, 5000.0f), time += 100) == VoicePool::STOLEN);
+
+    // Coin showers: hundreds of plays in a few frames.
+    for (int frame = 0; frame < 200; ++frame)
+    {
+      time += 16;
+      for (int i = 0; i < 40; ++i)
+        pool.play(make_sound(buffers[static_cast<size_t>(i) % buffers.size()], i % 3, static_cast<float>(i * 37 % 500)), time + static_cast<uint32_t>(i % 4));
+      pool.update();
+      ST_ASSERT(std::nullopt, pool.get_playing_count() <= pool.size());
+    }
+    ST_ASSERT("no OpenAL errors under load", alGetError() == AL_NO_ERROR);
+    ST_ASSERT("voices never exceed the pool", pool.get_playing_count() <= pool.size());
+    ST_ASSERT("bursts get coalesced", pool.get_coalesced_count() > 0);
+
+    pool.stop_all();
+    pool.update();
+    ST_ASSERT("stopped voices release their buffers", buffers[0].use_count() == 1);
+  }
+
+  alcMakeContextCurrent(nullptr);
+  alcDestroyContext(context);
+  alcCloseDevice(device);
+  return 0;
+}